@@ -30,8 +30,37 @@ static const int GSM_PORT = 443;  // HTTPS port untuk API production
 
 // GSM Settings
 static const unsigned long GSM_TIMEOUT = 30000; // 30 seconds
-static const unsigned long GSM_RETRY_INTERVAL = 60000; // 60 seconds
-static const int GSM_MAX_RETRIES = 3;
+static const unsigned long GSM_RETRY_INTERVAL = 60000; // 60 seconds - jeda awal setelah gagal (backoff, lihat RetryPolicy)
+static const int GSM_MAX_RETRIES = 3;                  // Gagal berturut-turut sebelum breaker terbuka
+static const unsigned long GSM_DRAIN_MAX_MS = 60000;   // Maks durasi kirim antrean offline per siklus upload
+static const size_t GSM_BATCH_MAX_BYTES = 4096; // Maks body JSON per POST batch (UART 9600 = ~1 KB/s)
+
+// Encoding body batch GSM - dipilih per build environment (lihat platformio.ini)
+// CBOR/DELTA otomatis kembali ke JSON jika server menjawab 415 Unsupported Media Type
+#define UPLOAD_ENCODING_JSON 0
+#define UPLOAD_ENCODING_CBOR 1
+#define UPLOAD_ENCODING_DELTA 2  // Kolom fixed-point + delta varint (lihat telemetry_delta.h)
+#ifndef UPLOAD_ENCODING
+#define UPLOAD_ENCODING UPLOAD_ENCODING_JSON
+#endif
+
+// Kompresi body batch (GSM sendBatch, WiFi syncOfflineData) dengan Content-Encoding: gzip.
+// Jika body gzip ditolak (400/413/415/422) tapi body asli diterima, gzip dimatikan sampai reboot
+#ifndef UPLOAD_GZIP
+#define UPLOAD_GZIP 0
+#endif
+#define UPLOAD_GZIP_MIN_BYTES 256  // Body lebih kecil dikirim apa adanya (header gzip 18 byte)
+
+// AT Engine (SIM800) - timeout per command, command selesai begitu baris akhir diterima
+#define AT_LINE_BUFFER_SIZE 128           // Baris respon terpanjang yang disimpan (sisanya dipotong)
+#define HTTP_RESPONSE_BODY_MAX 256        // Body respon HTTP yang disimpan untuk log (sisanya dibuang)
+static const unsigned long AT_TIMEOUT_DEFAULT = 1000;
+static const unsigned long AT_TIMEOUT_HTTPINIT = 10000;
+static const unsigned long AT_TIMEOUT_HTTPPARA = 5000;
+static const unsigned long AT_TIMEOUT_HTTPDATA_PROMPT = 5000;
+static const unsigned long AT_TIMEOUT_HTTPACTION = 60000; // TLS handshake + respon server (URC +HTTPACTION)
+static const unsigned long AT_TIMEOUT_HTTPREAD = 5000;
+static const unsigned long AT_URC_LINE_MS = 150;          // Sisa baris URC sebelum perintah baru (128 byte @ 9600 baud)
 
 // --- WIFI CONFIGURATION ---
 // WiFi Configuration
@@ -40,7 +69,21 @@ static const char* WIFI_PASSWORD = "1122334455";
 
 // WiFi Settings
 static const unsigned long WIFI_TIMEOUT = 10000; // 10 seconds
-static const unsigned long WIFI_RETRY_INTERVAL = 30000; // 30 seconds
+static const unsigned long WIFI_RETRY_INTERVAL = 30000; // 30 seconds - jeda awal reconnect (backoff, lihat RetryPolicy)
+static const int WIFI_MAX_RETRIES = 3;                   // Reconnect / upload gagal berturut-turut sebelum breaker terbuka
+static const unsigned long WIFI_UPLOAD_RETRY_MS = 5000;  // Jeda awal setelah upload WiFi gagal
+
+// Koneksi HTTPS persisten WiFiApiHandler (keep-alive, satu handshake TLS untuk banyak request)
+static const char* WIFI_API_ROOT_CA = NULL;                  // PEM CA server API; NULL = tanpa verifikasi sertifikat
+static const unsigned long WIFI_HTTP_KEEPALIVE_MS = 60000;   // Socket idle lebih lama ditutup dulu (nginx default 75 s)
+
+// Drain antrean offline lewat WiFi (WiFiApiHandler::syncOfflineData) - record dikirim
+// sebagai JSON array lewat satu koneksi keep-alive, jeda antar batch mengikuti waktu respon server
+static const size_t WIFI_DRAIN_BATCH_BYTES = 8192;           // Maks body per POST (record per POST <= QUEUE_PEEK_MAX_RECORDS)
+static const unsigned long WIFI_DRAIN_MAX_MS = 30000;        // Maks durasi satu sync, sisa antrean di sync berikutnya
+static const float WIFI_DRAIN_PACING_FACTOR = 0.5f;          // Jeda = faktor x waktu respon server (EWMA)
+static const unsigned long WIFI_DRAIN_MIN_GAP_MS = 20;
+static const unsigned long WIFI_DRAIN_MAX_GAP_MS = 5000;
 
 // NTP Configuration
 static const char* NTP_SERVER1 = "pool.ntp.org";
@@ -56,12 +99,14 @@ static const int TIMEZONE_OFFSET = 7 * 3600; // UTC+7 (WIB)
 #define GPS_RX_PIN 22
 #define GPS_TX_PIN 21
 #define GPS_BAUD 9600
+#define GPS_UART_NUM 2
 
-// Pin untuk Sensor Ultrasonik (menggunakan SoftwareSerial)
-// Sensor1: SoftwareSerial(TX=32, RX=33)
+// Pin untuk Sensor Ultrasonik
+// SENSORx_TX_PIN = pin TX sensor (data masuk ke ESP32), SENSORx_RX_PIN = pin RX sensor
+// Sensor1: TX=32, RX=33
 #define SENSOR1_TX_PIN 32
 #define SENSOR1_RX_PIN 33
-// Sensor2: SoftwareSerial(TX=19, RX=18) 
+// Sensor2: TX=19, RX=18
 #define SENSOR2_TX_PIN 19
 #define SENSOR2_RX_PIN 18
 
@@ -71,14 +116,126 @@ static const int TIMEZONE_OFFSET = 7 * 3600; // UTC+7 (WIB)
 #define SD_SCLK 14
 #define SD_CS 2
 
+// --- SD BUS CONFIGURATION ---
+// initSdCard() mulai dari clock maksimal lalu turun setengahnya (sampai minimal)
+// selama mount atau uji tulis-baca SD_BUS_PROBE_BYTES gagal
+static const uint32_t SD_SPI_MAX_FREQUENCY = 40000000;  // Hz (library default: 4 MHz)
+static const uint32_t SD_SPI_MIN_FREQUENCY = 4000000;   // Hz
+static const uint8_t SD_MAX_OPEN_FILES = 8;              // Log harian + queue + kompresi/export bersamaan
+static const size_t SD_BUS_PROBE_BYTES = 4096;           // Pola uji per clock (8 sektor)
+
 // --- COMMON TIMING CONFIGURATION ---
 static const unsigned long SAVE_SD_INTERVAL = 1000;  // Simpan ke SD setiap 1 detik
 static const unsigned long POST_INTERVAL = 20000;    // Kirim ke API setiap 20 detik
 static const unsigned long HTTP_TIMEOUT = 20000;     // 20 seconds
 
+// --- DAILY LOG CONFIGURATION ---
+#define DAILY_LOG_FORMAT_CSV    0  // Satu baris CSV per sampel (open/append/close setiap sampel)
+#define DAILY_LOG_FORMAT_BINARY 1  // Blok biner 512 byte, file tetap terbuka (lihat binary_log.h)
+#ifndef DAILY_LOG_FORMAT
+#define DAILY_LOG_FORMAT DAILY_LOG_FORMAT_BINARY
+#endif
+static const unsigned long DAILY_LOG_FLUSH_INTERVAL = 5000;  // Maks data log yang hilang saat listrik mati
+
+// --- LOG RETENTION CONFIGURATION ---
+static const int LOG_RETENTION_DAYS = 30;                     // Log harian lebih tua dari ini dihapus
+static const uint8_t LOG_RETENTION_LOW_FREE_PERCENT = 10;     // Mulai hapus log tertua di bawah free space ini
+static const uint8_t LOG_RETENTION_HIGH_FREE_PERCENT = 20;    // Berhenti hapus setelah free space di atas ini
+static const size_t LOG_RETENTION_FILES_PER_TICK = 4;         // Entri direktori / file dihapus per tick
+static const unsigned long LOG_RETENTION_INTERVAL = 3600000;  // Jeda antar pass retensi (1 jam)
+#define LOG_RETENTION_MAX_FILES 128                           // Log tertua yang diingat per pass
+
+// --- LOG COMPRESSION CONFIGURATION ---
+static const size_t LOG_COMPRESS_CHUNK_BYTES = 4096;          // Byte diproses per tick task storage
+static const int LOG_COMPRESS_LOOKBACK_DAYS = 7;              // Log hari sebelumnya yang dicek untuk dikompres
+
+// --- LOG EXPORT CONFIGURATION ---
+#define LOG_EXPORT_MAX_DAYS 400                               // Hari log maksimal dalam satu export gabungan
+#define LOG_EXPORT_BUFFER_SIZE 4096                           // Buffer tulis file export
+static const size_t LOG_EXPORT_STEP_BYTES = 4096;             // Byte log sumber per langkah (lock SD dilepas antar langkah)
+
+// --- OFFLINE QUEUE CONFIGURATION ---
+#ifndef QUEUE_SEGMENT_MAX_BYTES
+#define QUEUE_SEGMENT_MAX_BYTES 65536                 // Segmen tail baru dibuat setelah ukuran ini
+#endif
+static const size_t QUEUE_RECORD_MAX_SIZE = 256;      // Maks satu record (payload JSON production)
+static const size_t QUEUE_PEEK_MAX_RECORDS = 32;      // Maks record per peek()/ack() (= record per batch drain)
+
+// --- SD BENCHMARK CONFIGURATION (env:sdbench / env:sdbench-native) ---
+static const uint32_t SD_BENCH_SPI_CLOCKS[] = {4000000, 10000000, 20000000, 40000000};  // Hz
+static const uint16_t SD_BENCH_RECORD_RATES[] = {1, 10, 50};  // Record per detik
+static const uint32_t SD_BENCH_RUN_SECONDS = 60;              // Durasi satu run (pola x clock x rate)
+#define SD_BENCH_MAX_SAMPLES 2000                             // Sampel latency maksimal per run
+
 // --- SENSOR CONFIGURATION ---
 #define SENSOR_BAUD_RATE 9600
-#define SENSOR_READ_DELAY 4  // Delay untuk stabilitas sensor reading (ms)
+
+// Transport sensor ultrasonik (dipilih per sensor)
+#define SENSOR_TRANSPORT_SOFTSERIAL 0  // EspSoftwareSerial - bit-bang di interrupt, paling berat
+#define SENSOR_TRANSPORT_UART       1  // HardwareSerial - UART1 hanya bebas di build WiFi
+#define SENSOR_TRANSPORT_RMT        2  // RMT receiver - decode 8N1 dari durasi pulsa
+
+#ifndef SENSOR1_TRANSPORT
+#define SENSOR1_TRANSPORT SENSOR_TRANSPORT_RMT
+#endif
+// Nomor UART harus unik per sensor; UART0 = console, GPS_UART_NUM = GPS, UART1 = modem di build GSM.
+// Transport UART yang bentrok ditolak factory dan diganti RMT.
+#define SENSOR1_UART_NUM 1
+#define SENSOR1_RMT_CHANNEL 0
+
+#ifndef SENSOR2_TRANSPORT
+#define SENSOR2_TRANSPORT SENSOR_TRANSPORT_RMT
+#endif
+#define SENSOR2_UART_NUM 2  // Hanya bebas jika GPS dipindah dari UART2
+#define SENSOR2_RMT_CHANNEL 1
+
+// Jumlah sensor ultrasonik aktif (sensor ke-3 butuh SENSOR3_* di bawah)
+#ifndef ULTRASONIC_SENSOR_COUNT
+#define ULTRASONIC_SENSOR_COUNT 2
+#endif
+// #define SENSOR3_TX_PIN 34
+// #define SENSOR3_RX_PIN -1
+// #define SENSOR3_TRANSPORT SENSOR_TRANSPORT_RMT
+// #define SENSOR3_UART_NUM 0
+// #define SENSOR3_RMT_CHANNEL 2
+
+// RMT receiver
+#define RMT_UART_IDLE_BITS 12          // Idle > 12 bit = akhir frame
+#define RMT_UART_FILTER_APB_TICKS 200  // Filter glitch < 2.5 us
+#define RMT_UART_RINGBUF_SIZE 1024     // Bytes ringbuffer item RMT
+#define RMT_UART_FIFO_SIZE 64          // Bytes hasil decode per sensor
+
+// --- TASK PIPELINE CONFIGURATION ---
+#define PIPELINE_ACQ_CORE 1              // Core untuk task akuisisi sensor
+#define PIPELINE_IO_CORE 0               // Core untuk task storage & network
+#define PIPELINE_ACQ_PRIORITY 5
+#define PIPELINE_STORAGE_PRIORITY 3
+#define PIPELINE_NETWORK_PRIORITY 2
+#define PIPELINE_ACQ_POLL_MS 10          // Periode polling UART sensor & GPS
+#define PIPELINE_ACQ_STACK 4096
+#define PIPELINE_STORAGE_STACK 6144
+#define PIPELINE_NETWORK_STACK 12288
+#define PIPELINE_STORAGE_RING_SIZE 32    // Sampel, harus pangkat dua
+#define PIPELINE_UPLOAD_RING_SIZE 64     // Sampel, harus pangkat dua
+
+// --- RETRY POLICY CONFIGURATION ---
+// Backoff eksponensial + jitter dan circuit breaker jalur upload/reconnect (lihat retry_policy.h)
+static const unsigned long RETRY_MAX_DELAY_MS = 900000;  // Batas backoff & cooldown breaker (15 menit)
+static const unsigned long RETRY_OPEN_MS = 300000;       // Cooldown pertama breaker sebelum probe (5 menit)
+static const float RETRY_JITTER = 0.5f;                  // Jeda acak di [1 - jitter, 1] x backoff
+
+// --- ASYNC UPLOAD CONFIGURATION (WiFi) ---
+// Heap terburuk (board tanpa PSRAM): setiap socket TLS aktif memegang satu konteks mbedTLS
+// (~40 KB, buffer in/out 16 KB + sertifikat). Worker dihentikan (pause) selama drain antrean
+// offline, jadi puncaknya ASYNC_UPLOAD_WORKERS x ASYNC_UPLOAD_TLS_HEAP + stack worker - bukan
+// ditambah sesi drain. begin() hanya menjalankan worker yang muat di heap bebas.
+#define ASYNC_UPLOAD_WORKERS 2           // Request in-flight maksimal (satu task + socket TLS per worker)
+#define ASYNC_UPLOAD_TLS_HEAP 40960      // Perkiraan heap satu sesi TLS (cek log "free heap" handshake)
+#define ASYNC_UPLOAD_SLOTS 8             // Body antre + in-flight; submit() ditolak jika semua terpakai
+#define ASYNC_UPLOAD_BODY_SIZE 512       // Bytes per slot body
+#define ASYNC_UPLOAD_RESULT_QUEUE 16     // Hasil yang belum di-poll()
+#define ASYNC_UPLOAD_PRIORITY 2
+#define ASYNC_UPLOAD_STACK 8192
 
 // --- DEBUGGING CONFIGURATION ---
 #define SENSOR_DEBUG_INTERVAL 10000  // Debug sensor setiap 10 detik
@@ -0,0 +1,231 @@
+#include "async_uploader.h"
+#include "wifi_api_handler.h"
+
+// Counter & ID dibaca/ditulis dari loop, task network dan task worker
+static portMUX_TYPE uploaderMux = portMUX_INITIALIZER_UNLOCKED;
+
+AsyncUploader::AsyncUploader(const char* url, const char* userAgent, unsigned long timeout_ms) {
+    apiUrl = String(url);
+    this->userAgent = userAgent;
+    timeout = timeout_ms;
+    onDone = NULL;
+    freeSlots = NULL;
+    requests = NULL;
+    results = NULL;
+    memset(&stats, 0, sizeof(stats));
+    nextId = 0;
+    workerCount = 0;
+
+    for (int i = 0; i < ASYNC_UPLOAD_WORKERS; i++) {
+        workers[i].owner = this;
+        workers[i].lastRequestMs = 0;
+        workers[i].task = NULL;
+        workers[i].busy = NULL;
+    }
+}
+
+bool AsyncUploader::begin(UploadDoneCallback onDone) {
+    this->onDone = onDone;
+
+    freeSlots = xQueueCreate(ASYNC_UPLOAD_SLOTS, sizeof(uint8_t));
+    requests = xQueueCreate(ASYNC_UPLOAD_SLOTS, sizeof(uint8_t));
+    results = xQueueCreate(ASYNC_UPLOAD_RESULT_QUEUE, sizeof(UploadResult));
+    if (freeSlots == NULL || requests == NULL || results == NULL) {
+        Serial.println("❌ Async uploader: failed to create queues");
+        return false;
+    }
+    for (uint8_t i = 0; i < ASYNC_UPLOAD_SLOTS; i++) {
+        xQueueSend(freeSlots, &i, 0);
+    }
+
+    // Setiap worker nanti memegang satu sesi TLS - jangan jalankan worker yang tidak muat
+    uint32_t freeHeap = ESP.getFreeHeap();
+    int affordable = freeHeap / (ASYNC_UPLOAD_TLS_HEAP + ASYNC_UPLOAD_STACK);
+    int count = affordable < ASYNC_UPLOAD_WORKERS ? affordable : ASYNC_UPLOAD_WORKERS;
+    if (count == 0) {
+        Serial.printf("❌ Async uploader: free heap %u too low for one TLS worker\n", (unsigned)freeHeap);
+        return false;
+    }
+    if (count < ASYNC_UPLOAD_WORKERS) {
+        Serial.printf("⚠️ Async uploader: free heap %u - starting %d of %d workers\n",
+                      (unsigned)freeHeap, count, ASYNC_UPLOAD_WORKERS);
+    }
+
+    for (int i = 0; i < count; i++) {
+        Worker& worker = workers[i];
+        worker.busy = xSemaphoreCreateMutex();
+        if (worker.busy == NULL) {
+            Serial.println("❌ Async uploader: failed to create worker mutex");
+            return false;
+        }
+        if (WIFI_API_ROOT_CA != NULL) {
+            worker.client.setCACert(WIFI_API_ROOT_CA);
+        } else {
+            worker.client.setInsecure();
+        }
+        worker.http.setTimeout(timeout);
+        worker.http.setReuse(true);
+
+        char name[16];
+        snprintf(name, sizeof(name), "upload%d", i);
+        if (xTaskCreatePinnedToCore(workerTask, name, ASYNC_UPLOAD_STACK, &worker,
+                                    ASYNC_UPLOAD_PRIORITY, &worker.task, PIPELINE_IO_CORE) != pdPASS) {
+            Serial.println("❌ Async uploader: failed to create worker task");
+            return false;
+        }
+        workerCount++;
+    }
+
+    Serial.printf("✅ Async uploader started: %d workers, %d slots x %d bytes\n",
+                  workerCount, ASYNC_UPLOAD_SLOTS, ASYNC_UPLOAD_BODY_SIZE);
+    return true;
+}
+
+// =======================================================
+//   SUBMIT / POLL (non-blocking, dipanggil dari task mana pun)
+// =======================================================
+
+uint32_t AsyncUploader::submit(const char* body, size_t length) {
+    uint8_t index;
+    if (requests == NULL || length >= ASYNC_UPLOAD_BODY_SIZE || xQueueReceive(freeSlots, &index, 0) != pdTRUE) {
+        portENTER_CRITICAL(&uploaderMux);
+        stats.rejected++;
+        portEXIT_CRITICAL(&uploaderMux);
+        return 0;
+    }
+
+    Slot& slot = slots[index];
+    memcpy(slot.body, body, length);
+    slot.body[length] = '\0';
+    slot.length = length;
+    slot.submittedMs = millis();
+
+    portENTER_CRITICAL(&uploaderMux);
+    if (++nextId == 0) nextId = 1;
+    slot.id = nextId;
+    stats.submitted++;
+    portEXIT_CRITICAL(&uploaderMux);
+
+    // Kapasitas antrean = jumlah slot, jadi tidak pernah penuh di sini
+    xQueueSend(requests, &index, 0);
+    return slot.id;
+}
+
+bool AsyncUploader::poll(UploadResult& result) {
+    return results != NULL && xQueueReceive(results, &result, 0) == pdTRUE;
+}
+
+// =======================================================
+//   PAUSE / RESUME (dipanggil dari satu task, mis. task network)
+// =======================================================
+
+void AsyncUploader::pause() {
+    for (int i = 0; i < workerCount; i++) {
+        xSemaphoreTake(workers[i].busy, portMAX_DELAY);
+        workers[i].client.stop();  // Lepas konteks TLS
+    }
+}
+
+void AsyncUploader::resume() {
+    for (int i = 0; i < workerCount; i++) {
+        xSemaphoreGive(workers[i].busy);
+    }
+}
+
+// =======================================================
+//   TASK WORKER
+// =======================================================
+
+void AsyncUploader::workerTask(void* param) {
+    Worker* worker = (Worker*)param;
+    worker->owner->runWorker(*worker);
+}
+
+void AsyncUploader::runWorker(Worker& worker) {
+    for (;;) {
+        uint8_t index;
+        xQueueReceive(requests, &index, portMAX_DELAY);
+
+        // Menunggu di sini selama pause()
+        xSemaphoreTake(worker.busy, portMAX_DELAY);
+        Slot& slot = slots[index];
+        UploadResult result;
+        result.id = slot.id;
+        result.queuedMs = millis() - slot.submittedMs;
+        upload(worker, slot, result);
+        xSemaphoreGive(worker.busy);
+
+        // Slot dikembalikan sebelum callback agar submit() berikutnya tidak ditolak
+        xQueueSend(freeSlots, &index, 0);
+
+        portENTER_CRITICAL(&uploaderMux);
+        if (result.isSuccess()) {
+            stats.succeeded++;
+        } else {
+            stats.failed++;
+        }
+        portEXIT_CRITICAL(&uploaderMux);
+
+        if (onDone) {
+            onDone(result);
+        }
+        if (xQueueSend(results, &result, 0) != pdTRUE) {
+            portENTER_CRITICAL(&uploaderMux);
+            stats.resultDrops++;
+            portEXIT_CRITICAL(&uploaderMux);
+        }
+    }
+}
+
+void AsyncUploader::upload(Worker& worker, Slot& slot, UploadResult& result) {
+    if (WiFi.status() != WL_CONNECTED) {
+        // Gagal cepat - body tidak ditahan menunggu WiFi kembali
+        result.statusCode = HTTPC_ERROR_NOT_CONNECTED;
+        result.elapsedMs = 0;
+        return;
+    }
+
+    // Socket keep-alive yang idle terlalu lama kemungkinan sudah ditutup server
+    if (worker.client.connected() && millis() - worker.lastRequestMs >= WIFI_HTTP_KEEPALIVE_MS) {
+        worker.client.stop();
+    }
+
+    unsigned long startMs = millis();
+    worker.http.begin(worker.client, apiUrl);  // Connect hanya jika socket belum terbuka
+    worker.http.addHeader("Content-Type", "application/json");
+    worker.http.addHeader("User-Agent", userAgent);
+
+    HttpResponse response;
+    httpPostJson(worker.http, slot.body, slot.length, response);
+    worker.lastRequestMs = millis();
+    if (response.statusCode <= 0) {
+        worker.client.stop();  // Socket dalam keadaan tidak jelas - request berikutnya connect ulang
+    }
+
+    result.statusCode = response.statusCode;
+    result.elapsedMs = millis() - startMs;
+}
+
+// =======================================================
+//   STATISTIK
+// =======================================================
+
+AsyncUploaderStats AsyncUploader::getStats() {
+    portENTER_CRITICAL(&uploaderMux);
+    AsyncUploaderStats copy = stats;
+    portEXIT_CRITICAL(&uploaderMux);
+    copy.inFlight = freeSlots != NULL ? ASYNC_UPLOAD_SLOTS - uxQueueMessagesWaiting(freeSlots) : 0;
+    return copy;
+}
+
+void AsyncUploader::printStats() {
+    AsyncUploaderStats copy = getStats();
+    Serial.println("\n📤 ASYNC UPLOADER:");
+    Serial.printf("  Submitted: %lu (rejected: %lu)\n", (unsigned long)copy.submitted, (unsigned long)copy.rejected);
+    Serial.printf("  Succeeded: %lu, failed: %lu\n", (unsigned long)copy.succeeded, (unsigned long)copy.failed);
+    Serial.printf("  In flight: %lu/%d slots, %d workers\n", (unsigned long)copy.inFlight,
+                  ASYNC_UPLOAD_SLOTS, workerCount);
+    if (copy.resultDrops > 0) {
+        Serial.printf("  Result drops: %lu\n", (unsigned long)copy.resultDrops);
+    }
+}
@@ -0,0 +1,118 @@
+#ifndef ASYNC_UPLOADER_H
+#define ASYNC_UPLOADER_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiClientSecure.h>
+#include <HTTPClient.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "http_response.h"
+#include "../include/config.h"
+
+// =======================================================
+//   ASYNC UPLOADER (WiFi)
+//   submit() menyalin body JSON ke slot kosong dan langsung kembali - tidak pernah
+//   menunggu jaringan. ASYNC_UPLOAD_WORKERS task worker (core PIPELINE_IO_CORE)
+//   mengambil slot dari antrean FIFO dan POST lewat socket keep-alive masing-masing,
+//   jadi paling banyak ASYNC_UPLOAD_WORKERS request in-flight. Hasil dilaporkan lewat
+//   callback (di task worker) dan antrean status yang dibaca dengan poll().
+//   pause() menutup socket semua worker (melepas konteks TLS) selama klien HTTPS lain
+//   aktif, mis. drain antrean offline; body yang di-submit menunggu sampai resume().
+// =======================================================
+
+struct UploadResult {
+    uint32_t id;                // Dari submit()
+    int statusCode;             // HTTP status, <= 0 = error transport (HTTPC_ERROR_*)
+    unsigned long queuedMs;     // Lama menunggu worker
+    unsigned long elapsedMs;    // Lama request (connect + kirim + status)
+
+    bool isSuccess() const { return statusCode >= 200 && statusCode < 300; }
+};
+
+// Dipanggil di task worker - jangan blocking lama
+typedef void (*UploadDoneCallback)(const UploadResult& result);
+
+struct AsyncUploaderStats {
+    uint32_t submitted;
+    uint32_t succeeded;
+    uint32_t failed;            // Error transport / non-2xx
+    uint32_t rejected;          // submit() ditolak: slot habis / body terlalu besar
+    uint32_t resultDrops;       // Antrean status penuh (poll() terlambat)
+    uint32_t inFlight;          // Slot terpakai (antre + dikirim)
+};
+
+class AsyncUploader {
+public:
+    AsyncUploader(const char* url, const char* userAgent, unsigned long timeout_ms = 20000);
+
+    /**
+     * @brief Buat antrean dan task worker (sebanyak yang muat di heap, lihat ASYNC_UPLOAD_TLS_HEAP)
+     * @param onDone Callback per request selesai, boleh NULL
+     * @return false jika antrean / task gagal dibuat atau heap tidak cukup untuk satu worker
+     */
+    bool begin(UploadDoneCallback onDone = NULL);
+
+    /**
+     * @brief Antrekan satu body JSON (disalin), tidak pernah blocking
+     * @return ID request (> 0), atau 0 jika semua slot terpakai / body > ASYNC_UPLOAD_BODY_SIZE - 1
+     */
+    uint32_t submit(const char* body, size_t length);
+
+    /**
+     * @brief Ambil satu hasil dari antrean status (non-blocking)
+     * @return false jika belum ada hasil baru
+     */
+    bool poll(UploadResult& result);
+
+    /**
+     * @brief Tunggu request in-flight selesai lalu tutup socket semua worker
+     *
+     * Blocking sampai timeout request. Worker tidak mengambil slot baru sampai resume().
+     */
+    void pause();
+    void resume();
+
+    AsyncUploaderStats getStats();
+    void printStats();
+
+private:
+    struct Slot {
+        char body[ASYNC_UPLOAD_BODY_SIZE];
+        size_t length;
+        uint32_t id;
+        unsigned long submittedMs;
+    };
+
+    struct Worker {
+        AsyncUploader* owner;
+        WiFiClientSecure client;
+        HTTPClient http;
+        unsigned long lastRequestMs;
+        TaskHandle_t task;
+        SemaphoreHandle_t busy;     // Dipegang selama upload() dan selama pause()
+    };
+
+    static void workerTask(void* param);
+    void runWorker(Worker& worker);
+    void upload(Worker& worker, Slot& slot, UploadResult& result);
+
+    String apiUrl;
+    const char* userAgent;
+    unsigned long timeout;
+    UploadDoneCallback onDone;
+
+    Slot slots[ASYNC_UPLOAD_SLOTS];
+    Worker workers[ASYNC_UPLOAD_WORKERS];
+    int workerCount;            // Worker yang berjalan (<= ASYNC_UPLOAD_WORKERS)
+    QueueHandle_t freeSlots;    // Indeks slot kosong
+    QueueHandle_t requests;     // Indeks slot berisi body, FIFO
+    QueueHandle_t results;      // UploadResult untuk poll()
+
+    AsyncUploaderStats stats;   // Dilindungi uploaderMux (async_uploader.cpp)
+    uint32_t nextId;
+};
+
+#endif // ASYNC_UPLOADER_H
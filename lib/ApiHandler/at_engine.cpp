@@ -0,0 +1,185 @@
+#include "at_engine.h"
+#include <string.h>
+#include <stdlib.h>
+
+AtEngine::AtEngine(Stream& modemStream) : stream(modemStream) {
+    lineLength = 0;
+    infoLine[0] = '\0';
+    infoPending = false;
+    cmeError = 0;
+    commandStartMs = 0;
+    lastDurationMs = 0;
+    urcHandler = NULL;
+    urcContext = NULL;
+}
+
+void AtEngine::setUrcHandler(AtUrcHandler handler, void* context) {
+    urcHandler = handler;
+    urcContext = context;
+}
+
+// =======================================================
+//   COMMANDS
+// =======================================================
+
+void AtEngine::send(const char* cmd) {
+    drainUrcs();
+    infoPending = false;
+    cmeError = 0;
+
+    stream.print("AT");
+    stream.print(cmd);
+    stream.print("\r\n");
+    commandStartMs = millis();
+}
+
+AtResult AtEngine::command(const char* cmd, unsigned long timeoutMs) {
+    send(cmd);
+    return waitFinal(timeoutMs);
+}
+
+AtResult AtEngine::waitFinal(unsigned long timeoutMs) {
+    unsigned long deadline = millis() + timeoutMs;
+    AtResult result = AT_RESULT_TIMEOUT;
+
+    for (;;) {
+        AtLineType type = readLine(deadline);
+        if (type == AT_LINE_NONE) break;
+        if (type == AT_LINE_OK) { result = AT_RESULT_OK; break; }
+        if (type == AT_LINE_CME_ERROR) cmeError = atoi(line + 11);
+        if (type == AT_LINE_ERROR || type == AT_LINE_CME_ERROR) { result = AT_RESULT_ERROR; break; }
+        if (type == AT_LINE_PROMPT) { result = AT_RESULT_PROMPT; break; }
+        if (type == AT_LINE_INFO) storeInfoLine();
+        // AT_LINE_TEXT (echo dsb) diabaikan
+    }
+
+    lastDurationMs = millis() - commandStartMs;
+    return result;
+}
+
+AtResult AtEngine::waitInfo(const char* prefix, unsigned long timeoutMs) {
+    size_t prefixLength = strlen(prefix);
+
+    // URC bisa saja sudah tiba saat menunggu OK perintah sebelumnya
+    if (infoPending && strncmp(infoLine, prefix, prefixLength) == 0) {
+        infoPending = false;
+        lastDurationMs = millis() - commandStartMs;
+        return AT_RESULT_URC;
+    }
+
+    unsigned long deadline = millis() + timeoutMs;
+    AtResult result = AT_RESULT_TIMEOUT;
+
+    for (;;) {
+        AtLineType type = readLine(deadline);
+        if (type == AT_LINE_NONE) break;
+        if (type == AT_LINE_ERROR || type == AT_LINE_CME_ERROR) { result = AT_RESULT_ERROR; break; }
+        if (type != AT_LINE_INFO) continue;
+
+        storeInfoLine();
+        if (strncmp(infoLine, prefix, prefixLength) == 0) {
+            infoPending = false;
+            result = AT_RESULT_URC;
+            break;
+        }
+        if (urcHandler) urcHandler(line, urcContext);
+    }
+
+    lastDurationMs = millis() - commandStartMs;
+    return result;
+}
+
+size_t AtEngine::readRaw(char* out, size_t outSize, size_t length, unsigned long timeoutMs) {
+    unsigned long deadline = millis() + timeoutMs;
+    size_t received = 0;
+    size_t copied = 0;
+
+    while (received < length && (long)(millis() - deadline) < 0) {
+        if (!stream.available()) {
+            delay(1);
+            continue;
+        }
+
+        int c = stream.read();
+        if (c < 0) continue;
+        received++;
+
+        if (out != NULL && copied + 1 < outSize) {
+            out[copied++] = (char)c;
+        }
+    }
+
+    if (out != NULL && outSize > 0) {
+        out[copied] = '\0';
+    }
+    return copied;
+}
+
+void AtEngine::flushInput() {
+    while (stream.available()) {
+        stream.read();
+    }
+    lineLength = 0;
+}
+
+// Sisa respon perintah sebelumnya dibuang, URC "+..." diteruskan ke handler
+void AtEngine::drainUrcs() {
+    while (stream.available()) {
+        AtLineType type = readLine(millis() + AT_URC_LINE_MS);
+        if (type == AT_LINE_NONE) break;  // Potongan baris tanpa '\n'
+        if (type == AT_LINE_INFO && urcHandler) urcHandler(line, urcContext);
+    }
+    lineLength = 0;
+}
+
+// =======================================================
+//   TOKENIZER
+// =======================================================
+
+AtLineType AtEngine::readLine(unsigned long deadline) {
+    lineLength = 0;
+
+    while ((long)(millis() - deadline) < 0) {
+        if (!stream.available()) {
+            delay(1);
+            continue;
+        }
+
+        int c = stream.read();
+        if (c < 0 || c == '\r') continue;
+
+        if (c == '\n') {
+            if (lineLength == 0) continue;  // Baris kosong pemisah respon
+            line[lineLength] = '\0';
+            return classify();
+        }
+
+        // Baris terlalu panjang dipotong, sisanya dibuang sampai '\n'
+        if (lineLength < AT_LINE_BUFFER_SIZE - 1) {
+            line[lineLength++] = (char)c;
+        }
+
+        // Prompt '>' tidak diakhiri newline
+        if (lineLength == 1 && line[0] == '>') {
+            line[1] = '\0';
+            return AT_LINE_PROMPT;
+        }
+    }
+
+    line[lineLength] = '\0';
+    return AT_LINE_NONE;
+}
+
+AtLineType AtEngine::classify() const {
+    if (strcmp(line, "OK") == 0) return AT_LINE_OK;
+    if (strcmp(line, "ERROR") == 0) return AT_LINE_ERROR;
+    if (strncmp(line, "+CME ERROR:", 11) == 0) return AT_LINE_CME_ERROR;
+    if (strcmp(line, "DOWNLOAD") == 0) return AT_LINE_PROMPT;
+    if (line[0] == '+') return AT_LINE_INFO;
+    return AT_LINE_TEXT;
+}
+
+void AtEngine::storeInfoLine() {
+    memcpy(infoLine, line, lineLength + 1);
+    infoPending = true;
+}
@@ -0,0 +1,100 @@
+#ifndef AT_ENGINE_H
+#define AT_ENGINE_H
+
+#include <Arduino.h>
+#include "../include/config.h"
+
+// Hasil akhir satu perintah AT
+enum AtResult {
+    AT_RESULT_OK,
+    AT_RESULT_ERROR,        // ERROR atau +CME ERROR: <n>
+    AT_RESULT_PROMPT,       // DOWNLOAD atau '>' - modem menunggu data
+    AT_RESULT_URC,          // Baris +INFO / URC yang ditunggu sudah diterima
+    AT_RESULT_TIMEOUT
+};
+
+// Jenis baris hasil tokenizer
+enum AtLineType {
+    AT_LINE_NONE,
+    AT_LINE_OK,
+    AT_LINE_ERROR,
+    AT_LINE_CME_ERROR,
+    AT_LINE_PROMPT,
+    AT_LINE_INFO,           // Baris "+XXX: ..." (respon informasi atau URC)
+    AT_LINE_TEXT            // Baris lain (echo, body, dsb)
+};
+
+// Dipanggil untuk URC "+..." yang tidak ditunggu perintah mana pun (mis. +HTTPACTION
+// yang terlambat, +PDP: DEACT). Jangan kirim perintah AT dari dalam handler.
+typedef void (*AtUrcHandler)(const char* line, void* context);
+
+/**
+ * @brief Engine AT command non-String untuk SIM800
+ *
+ * Byte dari modem dikumpulkan ke line buffer berukuran tetap lalu diklasifikasikan
+ * (OK / ERROR / +CME ERROR / prompt / +INFO). Setiap perintah punya timeout sendiri
+ * tetapi selesai begitu baris penutupnya diterima - tidak ada delay() tetap.
+ *
+ * Baris "+..." terakhir disimpan di getInfoLine(). URC yang tiba sebelum
+ * waitInfo() dipanggil (misalnya +HTTPACTION tepat setelah OK) tetap tertangkap.
+ * Baris "+..." yang masih ada di UART saat send() dan baris lain selama waitInfo()
+ * diteruskan ke URC handler, bukan dibuang.
+ */
+class AtEngine {
+public:
+    explicit AtEngine(Stream& modemStream);
+
+    void setUrcHandler(AtUrcHandler handler, void* context);
+
+    /**
+     * @brief Kirim "AT<cmd>\r\n" lalu tunggu OK / ERROR / prompt
+     */
+    AtResult command(const char* cmd, unsigned long timeoutMs = AT_TIMEOUT_DEFAULT);
+    void send(const char* cmd);
+
+    // Tunggu baris akhir (OK / ERROR / prompt) untuk perintah yang sudah dikirim
+    AtResult waitFinal(unsigned long timeoutMs);
+
+    /**
+     * @brief Tunggu baris "+..." dengan prefix tertentu (URC atau respon informasi)
+     * @param prefix Misal "+HTTPACTION:" atau "+HTTPREAD:"
+     * @return AT_RESULT_URC jika diterima (isi di getInfoLine()), AT_RESULT_ERROR, atau AT_RESULT_TIMEOUT
+     */
+    AtResult waitInfo(const char* prefix, unsigned long timeoutMs);
+
+    /**
+     * @brief Baca tepat length byte data mentah (body HTTPREAD)
+     * @param out Buffer tujuan, boleh NULL untuk membuang data
+     * @param outSize Ukuran buffer; byte yang tidak muat dibaca lalu dibuang
+     * @return Jumlah byte yang disalin ke out (selalu diakhiri '\0' jika outSize > 0)
+     */
+    size_t readRaw(char* out, size_t outSize, size_t length, unsigned long timeoutMs);
+
+    // Buang byte sisa di UART sebelum perintah baru
+    void flushInput();
+
+    const char* getInfoLine() const { return infoLine; }
+    int getCmeError() const { return cmeError; }
+    unsigned long getLastDurationMs() const { return lastDurationMs; }
+
+private:
+    AtLineType readLine(unsigned long deadline);
+    AtLineType classify() const;
+    void storeInfoLine();
+    void drainUrcs();
+
+    Stream& stream;
+    char line[AT_LINE_BUFFER_SIZE];
+    size_t lineLength;
+
+    char infoLine[AT_LINE_BUFFER_SIZE];
+    bool infoPending;               // infoLine belum dikonsumsi waitInfo()
+    int cmeError;
+    unsigned long commandStartMs;
+    unsigned long lastDurationMs;
+
+    AtUrcHandler urcHandler;
+    void* urcContext;
+};
+
+#endif // AT_ENGINE_H
@@ -0,0 +1,102 @@
+#include "batch_post.h"
+#include <string.h>
+
+bool isRecordRejected(int statusCode) {
+    return statusCode == 400 || statusCode == 413 || statusCode == 422;
+}
+
+GzipPoster::GzipPoster() {
+    enabled = false;
+}
+
+int GzipPoster::post(const char* body, size_t length, uint8_t* scratch, size_t scratchSize,
+                     HttpPostFunction transport, void* context, HttpResponse& response, size_t& sentLength) {
+    sentLength = length;
+
+    size_t packedLength = 0;
+    if (enabled && length >= UPLOAD_GZIP_MIN_BYTES) {
+        unsigned long startMs = millis();
+        size_t capacity = scratchSize < length - 1 ? scratchSize : length - 1;
+        packedLength = gzip_compress(encoder, body, length, scratch, capacity);
+        Serial.printf("🗜️ gzip %u -> %u bytes (%lu ms)\n", (unsigned)length, (unsigned)packedLength,
+                      millis() - startMs);
+    }
+    if (packedLength == 0) {
+        return transport(body, length, false, response, context);
+    }
+
+    int statusCode = transport((const char*)scratch, packedLength, true, response, context);
+    if (statusCode != 415 && !isRecordRejected(statusCode)) {
+        sentLength = packedLength;
+        return statusCode;
+    }
+
+    statusCode = transport(body, length, false, response, context);
+    if (response.isSuccess()) {
+        enabled = false;
+        Serial.println("⚠️ Server menolak body gzip - upload tanpa kompresi sampai reboot");
+    }
+    return statusCode;
+}
+
+size_t encodeQueueBatch(const char* const* payloads, const size_t* lengths, size_t count,
+                        char* out, size_t maxBytes, size_t& packed, size_t& items) {
+    size_t length = 0;
+    packed = 0;
+    items = 0;
+    out[length++] = '[';
+    while (packed < count) {
+        // Record rusak (baris terpotong) tidak dikirim, cukup ikut di-ack
+        if (lengths[packed] > 0) {
+            size_t needed = lengths[packed] + (items > 0 ? 1 : 0);
+            if (length + needed + 1 > maxBytes) break;
+            if (items > 0) out[length++] = ',';
+            memcpy(out + length, payloads[packed], lengths[packed]);
+            length += lengths[packed];
+            items++;
+        }
+        packed++;
+    }
+    out[length++] = ']';
+    out[length] = '\0';
+    return length;
+}
+
+size_t postQueueRange(const char* const* payloads, const size_t* lengths, size_t count,
+                      char* out, size_t maxBytes, QueueBatchPostFunction post, void* context,
+                      QueueDrainStats& stats) {
+    size_t packed;
+    size_t items;
+    size_t length = encodeQueueBatch(payloads, lengths, count, out, maxBytes, packed, items);
+    if (items == 0) return packed;
+
+    HttpResponse response;
+    int statusCode = post(length, items, stats.batches, response, context);
+    stats.batches++;
+
+    if (response.isSuccess()) {
+        stats.sent += items;
+        return packed;
+    }
+
+    if (!isRecordRejected(statusCode)) {
+        response.print();
+        stats.stopped = true;
+        return 0;
+    }
+
+    if (items == 1) {
+        // Satu record ditolak server - dibuang agar antrean tidak macet (data tetap di log harian)
+        Serial.println("⚠️ Record rejected by server - dropped from offline queue");
+        response.print();
+        stats.rejected++;
+        return packed;
+    }
+
+    // Belah dua sampai record yang ditolak ketemu
+    size_t half = packed / 2;
+    size_t done = postQueueRange(payloads, lengths, half, out, maxBytes, post, context, stats);
+    if (done < half) return done;
+    return half + postQueueRange(payloads + half, lengths + half, packed - half, out, maxBytes,
+                                 post, context, stats);
+}
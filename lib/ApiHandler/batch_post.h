@@ -0,0 +1,94 @@
+#ifndef BATCH_POST_H
+#define BATCH_POST_H
+
+#include <Arduino.h>
+#include "http_response.h"
+#include "../include/config.h"
+#include "../Telemetry/gzip_deflate.h"
+
+// =======================================================
+//   BATCH POST (dipakai GSMApiHandler dan WiFiApiHandler)
+//   Keputusan upload yang sama untuk kedua transport: body gzip atau apa adanya,
+//   fallback saat server menolak gzip, dan drain antrean offline sebagai JSON array
+//   (batch ditolak dibelah dua sampai record penyebabnya ketemu). Transport
+//   (SIM800 / HTTPClient) dioper sebagai callback sehingga logika ini hanya ada di satu tempat.
+// =======================================================
+
+/**
+ * @brief Satu POST lewat transport handler
+ * @param gzip true jika body berisi stream gzip (Content-Encoding: gzip)
+ * @param response Wajib diisi hasil request
+ * @return Status code (<= 0 / 6xx = error transport)
+ */
+typedef int (*HttpPostFunction)(const char* body, size_t length, bool gzip, HttpResponse& response,
+                                void* context);
+
+/**
+ * @brief POST body batch yang sudah ditulis encodeQueueBatch() ke buffer handler
+ * @param batchIndex Jumlah POST sebelumnya dalam sync ini (0 = pertama, untuk pacing)
+ * @return Status code (<= 0 / 6xx = error transport)
+ */
+typedef int (*QueueBatchPostFunction)(size_t length, size_t items, size_t batchIndex, HttpResponse& response,
+                                      void* context);
+
+// Hasil satu syncOfflineData()
+struct QueueDrainStats {
+    size_t sent;                // Record diterima server (2xx)
+    size_t rejected;            // Record yang ditolak sendiri-sendiri (dibuang, tetap ada di log harian)
+    size_t batches;             // Jumlah POST
+    bool stopped;               // Error sementara - sisa antrean dicoba lagi di sync berikutnya
+};
+
+// Ditolak karena isi record (bukan server/auth) - layak dibelah untuk mencari record penyebabnya
+bool isRecordRejected(int statusCode);
+
+/**
+ * @brief Susun record antrean (sudah JSON production) menjadi JSON array di out
+ * @param out Buffer minimal maxBytes + 1 (diakhiri '\0')
+ * @param packed Record dari awal yang tercakup, termasuk record rusak (panjang 0) yang tidak dikirim
+ * @param items Record yang ditulis ke array
+ * @return Panjang body (maksimal maxBytes)
+ */
+size_t encodeQueueBatch(const char* const* payloads, const size_t* lengths, size_t count,
+                        char* out, size_t maxBytes, size_t& packed, size_t& items);
+
+/**
+ * @brief Kirim record antrean per batch; batch yang ditolak 400/413/422 dibelah dua
+ *        sampai record yang ditolak ketemu lalu dibuang
+ *
+ * Error lain menghentikan pengiriman (stats.stopped). Batch berikutnya kembali
+ * memakai ukuran penuh - penolakan satu batch tidak mengecilkan batch lain.
+ * @return Jumlah record dari awal range yang selesai (terkirim atau dibuang) - prefix yang boleh di-ack
+ */
+size_t postQueueRange(const char* const* payloads, const size_t* lengths, size_t count,
+                      char* out, size_t maxBytes, QueueBatchPostFunction post, void* context,
+                      QueueDrainStats& stats);
+
+/**
+ * @brief Kompresi gzip body batch (UPLOAD_GZIP) dengan fallback ke body asli
+ *
+ * Body dikompres jika gzip aktif, minimal UPLOAD_GZIP_MIN_BYTES dan hasilnya lebih
+ * kecil. Body gzip yang ditolak (400/413/415/422) dikirim ulang apa adanya; jika itu
+ * diterima, server tidak mendukung Content-Encoding dan gzip dimatikan sampai reboot.
+ */
+class GzipPoster {
+public:
+    GzipPoster();
+
+    void setEnabled(bool enabled) { this->enabled = enabled; }
+    bool isEnabled() const { return enabled; }
+
+    /**
+     * @param scratch Buffer hasil gzip (minimal length - 1 byte agar gzip berguna)
+     * @param sentLength Panjang body pada request terakhir
+     * @return Status code request terakhir
+     */
+    int post(const char* body, size_t length, uint8_t* scratch, size_t scratchSize,
+             HttpPostFunction transport, void* context, HttpResponse& response, size_t& sentLength);
+
+private:
+    GzipEncoder encoder;
+    bool enabled;
+};
+
+#endif // BATCH_POST_H
@@ -1,8 +1,29 @@
 #include "gsm_api_handler.h"
 
+static const char* encoding_name(uint8_t encoding) {
+    switch (encoding) {
+        case UPLOAD_ENCODING_CBOR:  return "CBOR";
+        case UPLOAD_ENCODING_DELTA: return "DELTA";
+        default:                    return "JSON";
+    }
+}
+
+static const char* encoding_content_type(uint8_t encoding) {
+    switch (encoding) {
+        case UPLOAD_ENCODING_CBOR:  return "application/cbor";
+        case UPLOAD_ENCODING_DELTA: return TELEMETRY_DELTA_CONTENT_TYPE;
+        default:                    return "application/json";
+    }
+}
+
 GSMApiHandler::GSMApiHandler(const char* device_id) {
     deviceId = String(device_id);
     isConnected = false;
+    httpSessionReady = false;
+    sessionGzip = false;
+    sessionEncoding = UPLOAD_ENCODING_JSON;
+    uploadEncoding = UPLOAD_ENCODING;
+    gzip.setEnabled(UPLOAD_GZIP);
     
     // Initialize hardware serial for GSM
     gsmSerial = &Serial1;
@@ -10,10 +31,13 @@ GSMApiHandler::GSMApiHandler(const char* device_id) {
     // Initialize TinyGSM modem and client
     modem = new TinyGsm(*gsmSerial);
     client = new TinyGsmClient(*modem);
+    at = new AtEngine(modem->stream);
+    at->setUrcHandler(onModemUrc, this);
 }
 
 GSMApiHandler::~GSMApiHandler() {
     disconnect();
+    delete at;
     delete modem;
     delete client;
 }
@@ -45,6 +69,9 @@ void GSMApiHandler::powerOnSIM800LManual() {
 void GSMApiHandler::testATCommands() {
     Serial.println("=== Testing AT Commands (TinyGSM) ===");
     
+    // Test ini memakai HTTPINIT/HTTPTERM sendiri - sesi persisten harus dibuka ulang
+    httpSessionReady = false;
+    
     // Test basic AT
     modem->sendAT("");
     if (modem->waitResponse(1000) == 1) {
@@ -112,6 +139,9 @@ bool GSMApiHandler::connect() {
     Serial.print("📍 IP Lokal: ");
     Serial.println(modem->getLocalIP());
     
+    // Jam sistem dari jaringan GSM agar sampel tanpa fix GPS tetap punya waktu
+    syncSystemClock();
+    
     // Test AT commands support
     testATCommands();
     
@@ -124,6 +154,9 @@ bool GSMApiHandler::disconnect() {
     Serial.println("🔌 Disconnecting GSM TinyGPS...");
     
     if (modem) {
+        if (httpSessionReady) {
+            endHttpSession();
+        }
         modem->gprsDisconnect();
     }
     
@@ -189,17 +222,10 @@ String GSMApiHandler::getGSMNetworkTime() {
     
     Serial.println("⏰ Getting network time from GSM...");
     
-    // Get network time from GSM tower
-    modem->sendAT("+CCLK?");
+    // Get network time from GSM tower (+CCLK: ... disimpan sebagai info line)
     String response = "";
-    
-    unsigned long timeout = millis();
-    while (millis() - timeout < 5000) {
-        if (modem->stream.available()) {
-            response += modem->stream.readString();
-            if (response.indexOf("OK") >= 0) break;
-        }
-        delay(100);
+    if (at->command("+CCLK?", 5000) == AT_RESULT_OK) {
+        response = at->getInfoLine();
     }
     
     Serial.print("GSM Time Response: ");
@@ -237,31 +263,87 @@ String GSMApiHandler::getGSMNetworkTime() {
     return "";
 }
 
-String GSMApiHandler::createProductionJsonPayload(float d1, float d2, float lat, float lon, float depth) {
-    // Format PRODUCTION yang BERHASIL berdasarkan test code yang working
-    StaticJsonDocument<512> doc;
+bool GSMApiHandler::syncSystemClock() {
+    if (!modem) return false;
+    
+    // Aktifkan update waktu dari jaringan (NITZ)
+    modem->sendAT("+CLTS=1");
+    modem->waitResponse(1000);
     
-    doc["type"] = "sensor";
-    doc["deviceId"] = deviceId;  // BJK0001 format
+    String response;
+    modem->sendAT("+CCLK?");
+    if (modem->waitResponse(5000L, response) != 1) {
+        Serial.println("❌ CCLK query failed - system clock not synced");
+        return false;
+    }
     
-    // GPS object nested (sesuai production format yang berhasil)
-    JsonObject gps = doc.createNestedObject("gps");
-    gps["lat"] = lat;
-    gps["lon"] = lon;
-    gps["alt"] = depth;  // Pakai depth sebagai altitude
-    gps["sog"] = 0;      // Speed over ground
-    gps["cog"] = 0;      // Course over ground
+    // Format: +CCLK: "yy/MM/dd,hh:mm:ss±zz" (zz = seperempat jam)
+    int start = response.indexOf("+CCLK: \"");
+    int yy, mo, dd, hh, mi, ss, tz = 0;
+    if (start < 0 || sscanf(response.c_str() + start + 8, "%d/%d/%d,%d:%d:%d%d",
+                            &yy, &mo, &dd, &hh, &mi, &ss, &tz) < 6) {
+        Serial.println("❌ CCLK response not recognised");
+        return false;
+    }
+    if (yy + 2000 < 2020) {
+        Serial.println("⚠️ Network time not available yet (modem RTC default)");
+        return false;
+    }
     
-    // Ultrasonic object nested (sesuai production format yang berhasil)
-    JsonObject ultrasonic = doc.createNestedObject("ultrasonic");
-    ultrasonic["dist1"] = round(d1 * 100) / 100.0;   // 2 decimal precision
-    ultrasonic["dist2"] = round(d2 * 100) / 100.0;   // 2 decimal precision
+    struct tm local_tm = {0};
+    local_tm.tm_year = yy + 2000 - 1900;
+    local_tm.tm_mon = mo - 1;
+    local_tm.tm_mday = dd;
+    local_tm.tm_hour = hh;
+    local_tm.tm_min = mi;
+    local_tm.tm_sec = ss;
     
-    doc["timestamp"] = getTimestamp();  // ISO format timestamp
+    // Tanpa zona dari jaringan, waktu modem dianggap WIB
+    long offsetSeconds = (tz != 0) ? (long)tz * 15 * 60 : TIMEZONE_OFFSET;
+    struct timeval tv;
+    tv.tv_sec = timegm_custom(&local_tm) - offsetSeconds;
+    tv.tv_usec = 0;
+    settimeofday(&tv, NULL);
     
-    String payload;
-    serializeJson(doc, payload);  // Compact JSON untuk production
-    return payload;
+    Serial.print("✅ System clock synced from GSM network: ");
+    Serial.println(response.substring(start + 8, start + 28));
+    return true;
+}
+
+String GSMApiHandler::createProductionJsonPayload(float d1, float d2, float lat, float lon, float depth) {
+    VatSensorData sample = {0};
+    sample.isValid = false;  // Tanpa waktu sampel - pakai timestamp saat ini
+    sample.distance1 = d1;
+    sample.distance2 = d2;
+    sample.latitude = lat;
+    sample.longitude = lon;
+    sample.depth = depth;
+    return createProductionJsonPayload(sample);
+}
+
+String GSMApiHandler::createProductionJsonPayload(const VatSensorData& sample) {
+    char fallback[WIB_TIMESTAMP_SIZE];
+    char payload[PRODUCTION_JSON_MAX_SIZE];
+    const char* timestamp = sample.isValid ? NULL : fallbackTimestamp(fallback, sizeof(fallback));
+    encodeSample(sample, timestamp, payload, sizeof(payload));
+    return String(payload);
+}
+
+const char* GSMApiHandler::fallbackTimestamp(char* out, size_t size) {
+    // NULL = jam sistem sudah sinkron, encoder memakai jam sistem per sampel
+    if (format_wib_timestamp_now(out, size) > 0) {
+        return NULL;
+    }
+    // Jam belum sinkron: waktu jaringan lewat AT+CCLK? (bisa sampai 5 s)
+    String networkTime = getTimestamp();
+    strlcpy(out, networkTime.c_str(), size);
+    return out;
+}
+
+size_t GSMApiHandler::encodeSample(const VatSensorData& sample, const char* fallback, char* out, size_t size) {
+    // Format PRODUCTION yang BERHASIL (type, deviceId, gps, ultrasonic, timestamp)
+    // Sampel tanpa waktu memakai fallback (NULL = jam sistem)
+    return encode_production_json(sample, deviceId.c_str(), sample.isValid ? NULL : fallback, out, size);
 }
 
 bool GSMApiHandler::sendSensorData(float distance1, float distance2, float latitude, float longitude, float depth) {
@@ -309,183 +391,327 @@ bool GSMApiHandler::sendSensorData(float distance1, float distance2, float latit
     }
 }
 
-bool GSMApiHandler::sendToProductionAPI(const String& payload) {
-    Serial.println("🚀 MENGIRIM KE API PRODUCTION (TinyGSM AT Commands)...");
+size_t GSMApiHandler::encodeJsonBatch(const VatSensorData* samples, size_t count, size_t& packed) {
+    // Susun JSON array langsung di batchBuffer sampai GSM_BATCH_MAX_BYTES (minimal satu sampel)
+    // Timestamp fallback dibaca sekali per batch, hanya jika ada sampel tanpa waktu
+    char fallback[WIB_TIMESTAMP_SIZE];
+    const char* timestamp = NULL;
+    bool fallbackRead = false;
+    size_t length = 0;
+    packed = 0;
+    batchBuffer[length++] = '[';
+    for (size_t i = 0; i < count; i++) {
+        if (!samples[i].isValid && !fallbackRead) {
+            timestamp = fallbackTimestamp(fallback, sizeof(fallback));
+            fallbackRead = true;
+        }
+        char* item = batchBuffer + length + (packed > 0 ? 1 : 0);
+        size_t room = GSM_BATCH_MAX_BYTES - (item - batchBuffer);  // Sisakan ']' dan '\0'
+        size_t itemLength = encodeSample(samples[i], timestamp, item, room > 1 ? room - 1 : 0);
+        if (itemLength == 0) {
+            break;
+        }
+        if (packed > 0) batchBuffer[length++] = ',';
+        length += itemLength;
+        packed++;
+    }
+    batchBuffer[length++] = ']';
+    batchBuffer[length] = '\0';
+    return packed > 0 ? length : 0;
+}
+
+size_t GSMApiHandler::sendBatch(const VatSensorData* samples, size_t count) {
+    if (!isConnected) {
+        Serial.println("❌ GSM not connected - cannot send batch");
+        return 0;
+    }
+    if (count == 0) return 0;
+    
+    size_t packed = 0;
+    size_t length;
+    if (uploadEncoding == UPLOAD_ENCODING_CBOR) {
+        length = encode_cbor_batch(samples, count, deviceId.c_str(),
+                                   (uint8_t*)batchBuffer, GSM_BATCH_MAX_BYTES, packed);
+    } else if (uploadEncoding == UPLOAD_ENCODING_DELTA) {
+        length = encode_delta_batch(samples, count, deviceId.c_str(),
+                                    (uint8_t*)batchBuffer, GSM_BATCH_MAX_BYTES, packed);
+    } else {
+        length = encodeJsonBatch(samples, count, packed);
+    }
     
-    // Terminate existing HTTP session if any
-    modem->sendAT("+HTTPTERM");
-    modem->waitResponse(1000);
-    delay(1000);
+    if (length == 0) {
+        Serial.println("❌ Sample does not fit in GSM_BATCH_MAX_BYTES");
+        return 0;
+    }
+    
+    Serial.println("");
+    Serial.println("🚀 SENDING BATCH TO PRODUCTION API");
+    Serial.println("========================================");
+    Serial.print("Samples: ");
+    Serial.print(packed);
+    Serial.print("/");
+    Serial.println(count);
+    Serial.print("Body size: ");
+    Serial.print(length);
+    Serial.print(" bytes (");
+    Serial.print(encoding_name(uploadEncoding));
+    Serial.println(")");
+    Serial.println("========================================");
+    
+    HttpResponse response;
+    if (!sendBatchBody(length, uploadEncoding, response)) {
+        // Server belum mendukung format biner - kembali ke JSON untuk sisa uptime
+        if (response.statusCode == 415 && uploadEncoding != UPLOAD_ENCODING_JSON) {
+            Serial.print("⚠️ Server menolak ");
+            Serial.print(encoding_content_type(uploadEncoding));
+            Serial.println(" (415) - beralih ke JSON");
+            uploadEncoding = UPLOAD_ENCODING_JSON;
+            endHttpSession();
+            return sendBatch(samples, count);
+        }
+        Serial.println("❌ Batch upload failed");
+        return 0;
+    }
+    
+    Serial.print("🎉 Batch of ");
+    Serial.print(packed);
+    Serial.println(" samples sent");
+    return packed;
+}
+
+int GSMApiHandler::postBatchTransport(const char* body, size_t length, bool gzip, HttpResponse& response,
+                                      void* context) {
+    BatchTransport* transport = (BatchTransport*)context;
+    transport->handler->sendToProductionAPI(body, length, response, transport->encoding, gzip);
+    return response.statusCode;
+}
+
+// POST batchBuffer lewat sesi HTTP SIM800 (gzip + fallback di GzipPoster)
+bool GSMApiHandler::sendBatchBody(size_t length, uint8_t encoding, HttpResponse& response) {
+    BatchTransport transport = {this, encoding};
+    size_t sentLength;
+    gzip.post(batchBuffer, length, gzipBuffer, sizeof(gzipBuffer), postBatchTransport, &transport,
+              response, sentLength);
+    return response.isSuccess();
+}
+
+// Satu POST batch antrean untuk postQueueRange() - selalu JSON array
+int GSMApiHandler::postQueueBatch(size_t length, size_t items, size_t batchIndex, HttpResponse& response,
+                                  void* context) {
+    ((GSMApiHandler*)context)->sendBatchBody(length, UPLOAD_ENCODING_JSON, response);
+    return response.statusCode;
+}
+
+size_t GSMApiHandler::syncOfflineData() {
+    if (!isConnected || !isOfflineQueueNotEmpty()) return 0;
+    Serial.println("🔄 Syncing offline queue via GSM...");
+    
+    // Record yang tidak di-ack tetap di antrean untuk peek berikutnya
+    static char records[QUEUE_PEEK_MAX_RECORDS * (QUEUE_RECORD_MAX_SIZE + 2)];
+    const char* payloads[QUEUE_PEEK_MAX_RECORDS];
+    size_t lengths[QUEUE_PEEK_MAX_RECORDS];
+    
+    QueueDrainStats stats = {0, 0, 0, false};
+    unsigned long startMs = millis();
+    while (!stats.stopped && millis() - startMs < GSM_DRAIN_MAX_MS) {
+        size_t count = peekOfflineQueue(QUEUE_PEEK_MAX_RECORDS, records, sizeof(records), payloads, lengths);
+        if (count == 0) break;
+        
+        size_t done = postQueueRange(payloads, lengths, count, batchBuffer, GSM_BATCH_MAX_BYTES,
+                                     postQueueBatch, this, stats);
+        
+        // Satu update metadata per batch
+        if (done > 0 && !ackOfflineQueue(done)) break;
+    }
+    
+    Serial.printf("📤 Offline sync: %u records sent in %u batches, %u rejected in %lu ms%s\n",
+                  (unsigned)stats.sent, (unsigned)stats.batches, (unsigned)stats.rejected,
+                  millis() - startMs, isOfflineQueueNotEmpty() ? " (more pending)" : "");
+    return stats.sent;
+}
+
+bool GSMApiHandler::beginHttpSession() {
+    Serial.println("📡 Membuka sesi HTTP (HTTPINIT + SSL + parameter)...");
+    unsigned long startTime = millis();
+    char cmd[AT_LINE_BUFFER_SIZE];
+    
+    // Terminate sesi lama yang mungkin tersisa (error diabaikan)
+    at->command("+HTTPTERM");
+    httpSessionReady = false;
     
     // Inisialisasi HTTP
-    Serial.println("📡 Inisialisasi HTTP...");
-    modem->sendAT("+HTTPINIT");
-    if (modem->waitResponse(10000) != 1) {
+    if (at->command("+HTTPINIT", AT_TIMEOUT_HTTPINIT) != AT_RESULT_OK) {
         Serial.println("❌ Gagal inisialisasi HTTP");
         return false;
     }
-    delay(1000);
     
     // Aktifkan SSL untuk HTTPS
-    Serial.println("🔒 Mengaktifkan SSL...");
-    modem->sendAT("+HTTPSSL=1");
-    if (modem->waitResponse(5000) != 1) {
+    if (at->command("+HTTPSSL=1", AT_TIMEOUT_HTTPPARA) != AT_RESULT_OK) {
         Serial.println("❌ SSL tidak didukung atau gagal diaktifkan");
-        modem->sendAT("+HTTPTERM");
+        endHttpSession();
         return false;
     }
-    delay(1000);
     
     // Set URL untuk API production
-    Serial.println("🌐 Set Production API URL...");
-    String fullURL = "https://" + String(server) + String(resource);
-    modem->sendAT("+HTTPPARA=\"URL\",\"" + fullURL + "\"");
-    if (modem->waitResponse(5000) != 1) {
+    snprintf(cmd, sizeof(cmd), "+HTTPPARA=\"URL\",\"https://%s%s\"", server, resource);
+    if (at->command(cmd, AT_TIMEOUT_HTTPPARA) != AT_RESULT_OK) {
         Serial.println("❌ Gagal set Production API URL");
-        modem->sendAT("+HTTPTERM");
+        endHttpSession();
         return false;
     }
-    delay(500);
     
-    // Set content type dan headers tambahan
-    Serial.println("📋 Set content type dan headers...");
-    modem->sendAT("+HTTPPARA=\"CONTENT\",\"application/json\"");
-    if (modem->waitResponse(5000) != 1) {
+    // Set content type sesuai encoding batch (JSON / CBOR / delta)
+    if (!setContentType(uploadEncoding)) {
         Serial.println("❌ Gagal set content type");
-        modem->sendAT("+HTTPTERM");
+        endHttpSession();
         return false;
     }
-    delay(500);
     
-    // Set User-Agent header (sama dengan test yang berhasil)
-    modem->sendAT("+HTTPPARA=\"USERDATA\",\"User-Agent: ESP32-SIM800L-SubsoilMonitor\"");
-    modem->waitResponse(3000);
-    delay(300);
+    setUserData(false);
     
-    // Set Accept header (sama dengan test yang berhasil)
-    modem->sendAT("+HTTPPARA=\"USERDATA\",\"Accept: application/json\"");
-    modem->waitResponse(3000);
-    delay(300);
-    
-    // Set data
-    Serial.println("📤 Memulai input data...");
-    Serial.print("Payload length: ");
-    Serial.println(payload.length());
+    httpSessionReady = true;
+    Serial.print("✅ Sesi HTTP siap (");
+    Serial.print(millis() - startTime);
+    Serial.println(" ms)");
+    return true;
+}
+
+// USERDATA hanya menyimpan satu nilai - header digabung dengan \r\n (di-escape oleh SIM800)
+bool GSMApiHandler::setUserData(bool gzip) {
+    const char* cmd = gzip
+        ? "+HTTPPARA=\"USERDATA\",\"User-Agent: ESP32-SIM800L-SubsoilMonitor\\r\\nAccept: application/json"
+          "\\r\\nContent-Encoding: gzip\""
+        : "+HTTPPARA=\"USERDATA\",\"User-Agent: ESP32-SIM800L-SubsoilMonitor\\r\\nAccept: application/json\"";
+    sessionGzip = gzip;
+    return at->command(cmd, AT_TIMEOUT_HTTPPARA) == AT_RESULT_OK;
+}
+
+bool GSMApiHandler::setContentType(uint8_t encoding) {
+    char cmd[AT_LINE_BUFFER_SIZE];
+    snprintf(cmd, sizeof(cmd), "+HTTPPARA=\"CONTENT\",\"%s\"", encoding_content_type(encoding));
+    sessionEncoding = encoding;
+    return at->command(cmd, AT_TIMEOUT_HTTPPARA) == AT_RESULT_OK;
+}
+
+void GSMApiHandler::endHttpSession() {
+    at->command("+HTTPTERM");
+    httpSessionReady = false;
+}
+
+void GSMApiHandler::onModemUrc(const char* line, void* context) {
+    ((GSMApiHandler*)context)->handleUrc(line);
+}
+
+void GSMApiHandler::handleUrc(const char* line) {
+    if (strncmp(line, "+HTTPACTION:", 12) == 0) {
+        // Respon request yang sudah dianggap timeout - server mungkin sudah menerima data
+        Serial.printf("⚠️ Late URC after timeout: %s\n", line);
+    } else if (strncmp(line, "+PDP: DEACT", 11) == 0) {
+        // Bearer GPRS putus - sesi HTTP harus di-init ulang
+        Serial.println("⚠️ GPRS bearer deactivated by network");
+        httpSessionReady = false;
+    } else {
+        Serial.printf("📩 URC: %s\n", line);
+    }
+}
+
+bool GSMApiHandler::sendToProductionAPI(const String& payload) {
+    HttpResponse response;
+    return sendToProductionAPI(payload.c_str(), payload.length(), response);
+}
+
+bool GSMApiHandler::sendToProductionAPI(const String& payload, HttpResponse& response) {
+    return sendToProductionAPI(payload.c_str(), payload.length(), response);
+}
+
+bool GSMApiHandler::sendToProductionAPI(const char* body, size_t length, HttpResponse& response,
+                                        uint8_t encoding, bool gzip) {
+    Serial.println("🚀 MENGIRIM KE API PRODUCTION (TinyGSM AT Commands)...");
+    response.reset();
     
-    modem->sendAT("+HTTPDATA=" + String(payload.length()) + ",10000");
+    // Sesi HTTP (INIT/SSL/URL/CONTENT/USERDATA) dipakai ulang antar POST,
+    // hanya dibuka ulang setelah error
+    if (!httpSessionReady && !beginHttpSession()) {
+        return false;
+    }
     
-    // Tunggu prompt ">"
-    unsigned long timeout = millis();
-    bool gotPrompt = false;
-    while (millis() - timeout < 10000) {
-        if (modem->stream.available()) {
-            String response = modem->stream.readString();
-            Serial.print("Response: ");
-            Serial.println(response);
-            if (response.indexOf("DOWNLOAD") >= 0 || response.indexOf(">") >= 0) {
-                gotPrompt = true;
-                break;
-            }
-        }
-        delay(100);
+    // CONTENT / Content-Encoding hanya diganti jika berbeda dari POST sebelumnya
+    if (encoding != sessionEncoding && !setContentType(encoding)) {
+        Serial.println("❌ Gagal set content type");
+        endHttpSession();
+        return false;
     }
+    if (gzip != sessionGzip && !setUserData(gzip)) {
+        Serial.println("❌ Gagal set header Content-Encoding");
+        endHttpSession();
+        return false;
+    }
+    
+    unsigned long startTime = millis();
+    char cmd[AT_LINE_BUFFER_SIZE];
+    
+    // Set data
+    Serial.print("📤 Memulai input data, payload length: ");
+    Serial.println(length);
     
-    if (!gotPrompt) {
+    // Waktu input diskalakan dengan ukuran body (UART 9600 baud = ~1 byte/ms)
+    unsigned long inputTimeMs = 10000 + length * 2;
+    snprintf(cmd, sizeof(cmd), "+HTTPDATA=%u,%lu", (unsigned)length, inputTimeMs);
+    if (at->command(cmd, AT_TIMEOUT_HTTPDATA_PROMPT) != AT_RESULT_PROMPT) {
         Serial.println("❌ Tidak mendapat prompt untuk input data");
-        modem->sendAT("+HTTPTERM");
+        endHttpSession();
         return false;
     }
     
-    // Kirim payload
-    Serial.println("📤 Mengirim payload ke API...");
-    modem->stream.print(payload);
-    
-    // Tunggu konfirmasi
-    if (modem->waitResponse(10000) != 1) {
+    // Kirim payload, modem menjawab OK setelah semua byte diterima
+    modem->stream.write((const uint8_t*)body, length);
+    if (at->waitFinal(inputTimeMs) != AT_RESULT_OK) {
         Serial.println("❌ Gagal mengirim data");
-        modem->sendAT("+HTTPTERM");
+        endHttpSession();
         return false;
     }
     
-    // Kirim POST request
+    // Kirim POST request - OK langsung, status HTTP menyusul sebagai URC
     Serial.println("📡 Mengirim HTTPS POST request ke production API...");
-    modem->sendAT("+HTTPACTION=1"); // 1 = POST
-    if (modem->waitResponse(30000) != 1) {
+    if (at->command("+HTTPACTION=1", AT_TIMEOUT_HTTPPARA) != AT_RESULT_OK) { // 1 = POST
         Serial.println("❌ Gagal mengirim HTTPS POST request");
-        modem->sendAT("+HTTPTERM");
+        endHttpSession();
         return false;
     }
     
-    Serial.println("✅ HTTPS POST request berhasil dikirim ke production API!");
-    
-    // Tunggu sebentar sebelum membaca response
-    delay(3000);
-    
-    // Baca response dari production API dengan detail
-    Serial.println("📥 Membaca response dari production API...");
-    modem->sendAT("+HTTPREAD");
+    // +HTTPACTION: <method>,<status>,<datalen>
+    if (at->waitInfo("+HTTPACTION:", AT_TIMEOUT_HTTPACTION) != AT_RESULT_URC ||
+        !response.parseHttpAction(at->getInfoLine())) {
+        Serial.println("❌ Timeout menunggu +HTTPACTION dari modem");
+        endHttpSession();
+        return false;
+    }
+    response.elapsedMs = millis() - startTime;
     
-    // Baca semua data yang tersedia
-    String response = "";
-    unsigned long startTime = millis();
-    while (millis() - startTime < 15000) { // Tunggu lebih lama
-        while (modem->stream.available()) {
-            char c = modem->stream.read();
-            response += c;
-            Serial.print(c);  // Print setiap karakter untuk debug
-        }
-        delay(50);
-        
-        // Jika dapat +HTTPREAD response, tunggu sebentar lagi untuk body
-        if (response.indexOf("+HTTPREAD:") >= 0 && response.length() > 20) {
-            delay(2000); // Tunggu body response
-        }
-        
-        // Break jika sudah dapat response lengkap
-        if (response.indexOf("OK") >= 0 && response.length() > 50) {
-            break;
+    // Body response: +HTTPREAD: <len>\r\n<data>\r\nOK (hanya awal body yang disimpan)
+    if (response.bodyLength > 0) {
+        size_t readLength = 0;
+        at->send("+HTTPREAD");
+        if (at->waitInfo("+HTTPREAD:", AT_TIMEOUT_HTTPREAD) == AT_RESULT_URC &&
+            parseHttpReadHeader(at->getInfoLine(), readLength)) {
+            at->readRaw(response.body, sizeof(response.body), readLength, AT_TIMEOUT_HTTPREAD);
         }
+        at->waitFinal(AT_TIMEOUT_HTTPREAD);
     }
     
-    Serial.println("\n=== FULL API RESPONSE (Raw) ===");
-    Serial.print("Response length: ");
-    Serial.println(response.length());
-    Serial.println("Raw content:");
-    for (int i = 0; i < response.length(); i++) {
-        Serial.print((char)response[i]);
-        if (i % 80 == 79) Serial.println(); // New line every 80 chars
-    }
-    Serial.println("\n==============================");
+    response.print();
     
-    // Terminate HTTP
-    modem->sendAT("+HTTPTERM");
-    modem->waitResponse(1000);
+    // 6xx = error jaringan/DNS/SSL dari SIM800 - sesi dibuka ulang.
+    // Status HTTP lain: sesi tetap terbuka untuk POST berikutnya
+    if (response.isTransportError()) {
+        endHttpSession();
+    }
     
-    // Analisis response lebih detail (sama dengan test yang berhasil)
-    if (response.indexOf("200") >= 0 || response.indexOf("201") >= 0) {
+    if (response.isSuccess()) {
         Serial.println("\n🎉 DATA BERHASIL DIKIRIM KE PRODUCTION API!");
         return true;
-    } else if (response.indexOf("400") >= 0) {
-        Serial.println("\n⚠️  API Response: 400 Bad Request");
-        Serial.println("❓ Kemungkinan: format data, authentication, atau header salah");
-        return false;
-    } else if (response.indexOf("401") >= 0) {
-        Serial.println("\n🔒 API Response: 401 Unauthorized");
-        Serial.println("❗ Perlu authentication (API Key/Token)");
-        return false;
-    } else if (response.indexOf("404") >= 0) {
-        Serial.println("\n🔍 API Response: 404 Not Found");
-        Serial.println("❗ Endpoint /subsoils tidak ditemukan atau method salah");
-        return false;
-    } else if (response.indexOf("50") >= 0) {
-        Serial.println("\n⚠️  API Response: Server Error (5xx)");
-        Serial.println("Kemungkinan: server API bermasalah");
-        return false;
-    } else {
-        Serial.println("\n❓ Response tidak dikenal atau timeout");
-        Serial.println("Raw response length: " + String(response.length()));
-        return false;
     }
+    return false;
 }
 
 bool GSMApiHandler::sendHTTPTestRequest(const String& payload) {
@@ -619,6 +845,9 @@ bool GSMApiHandler::sendHTTPSATRequest(const String& payload) {
 bool GSMApiHandler::sendHTTPRequest(const String& payload) {
     Serial.println("🧪 Menggunakan AT commands untuk HTTP...");
     
+    // Request test memakai URL lain - sesi production dibuka ulang pada POST berikutnya
+    httpSessionReady = false;
+    
     // Terminate existing HTTP session if any
     modem->sendAT("+HTTPTERM");
     modem->waitResponse(1000);
@@ -658,25 +887,9 @@ bool GSMApiHandler::sendHTTPRequest(const String& payload) {
     Serial.print("Payload length: ");
     Serial.println(payload.length());
     
-    modem->sendAT("+HTTPDATA=" + String(payload.length()) + ",10000");
-    
-    // Tunggu prompt ">"
-    unsigned long timeout = millis();
-    bool gotPrompt = false;
-    while (millis() - timeout < 10000) {
-        if (modem->stream.available()) {
-            String response = modem->stream.readString();
-            Serial.print("Response: ");
-            Serial.println(response);
-            if (response.indexOf("DOWNLOAD") >= 0 || response.indexOf(">") >= 0) {
-                gotPrompt = true;
-                break;
-            }
-        }
-        delay(100);
-    }
-    
-    if (!gotPrompt) {
+    // Tunggu prompt DOWNLOAD / ">"
+    String dataCmd = "+HTTPDATA=" + String(payload.length()) + ",10000";
+    if (at->command(dataCmd.c_str(), AT_TIMEOUT_HTTPDATA_PROMPT) != AT_RESULT_PROMPT) {
         Serial.println("❌ Tidak mendapat prompt untuk input data");
         modem->sendAT("+HTTPTERM");
         return false;
@@ -704,13 +917,11 @@ bool GSMApiHandler::sendHTTPRequest(const String& payload) {
     
     Serial.println("✅ POST request berhasil dikirim!");
     
-    // Tunggu sebentar sebelum membaca response
-    delay(2000);
-    
-    // Baca response (optional)
-    Serial.println("Membaca response...");
-    modem->sendAT("+HTTPREAD");
-    modem->waitResponse(5000);
+    // Tunggu status dari server (URC), bukan delay tetap
+    if (at->waitInfo("+HTTPACTION:", AT_TIMEOUT_HTTPACTION) == AT_RESULT_URC) {
+        Serial.print("Response: ");
+        Serial.println(at->getInfoLine());
+    }
     
     // Terminate HTTP
     modem->sendAT("+HTTPTERM");
@@ -733,6 +944,10 @@ void GSMApiHandler::printStatus() {
     Serial.println(apn);
     Serial.print("Connection: ");
     Serial.println(isConnected ? "Connected ✅" : "Disconnected ❌");
+    Serial.print("HTTP Session: ");
+    Serial.println(httpSessionReady ? "Open ✅" : "Closed");
+    Serial.print("Upload Encoding: ");
+    Serial.println(encoding_name(uploadEncoding));
     
     if (isConnected && modem) {
         Serial.print("Network Status: ");
@@ -2,10 +2,16 @@
 #define GSM_API_HANDLER_H
 
 #include <Arduino.h>
-#include <ArduinoJson.h>
 #include <TinyGsmClient.h>
 #include <HardwareSerial.h>
 #include "../include/config.h"
+#include "../SdUtils/sd_utils.h"
+#include "at_engine.h"
+#include "http_response.h"
+#include "../Telemetry/telemetry_json.h"
+#include "../Telemetry/telemetry_cbor.h"
+#include "../Telemetry/telemetry_delta.h"
+#include "batch_post.h"
 
 // Check if TINY_GSM_MODEM_SIM800 is not already defined
 #ifndef TINY_GSM_MODEM_SIM800
@@ -16,9 +22,12 @@ class GSMApiHandler {
 private:
     TinyGsm* modem;
     TinyGsmClient* client;
+    AtEngine* at;               // Parser respon untuk jalur HTTP (tanpa String/delay)
     HardwareSerial* gsmSerial;
     String deviceId;
     bool isConnected;
+    bool httpSessionReady;      // HTTPINIT/SSL/URL/CONTENT/USERDATA sudah di-set
+    uint8_t uploadEncoding;     // UPLOAD_ENCODING_JSON / _CBOR / _DELTA
     
     // Production API configuration (Tested & Working)
     const char* server = GSM_SERVER;        // "api-vatsubsoil-dev.ggfsystem.com"
@@ -32,6 +41,37 @@ private:
     void powerOnSIM800LManual();
     void testATCommands();
     
+    // URC di luar perintah yang sedang berjalan (lihat AtEngine::setUrcHandler)
+    static void onModemUrc(const char* line, void* context);
+    void handleUrc(const char* line);
+    
+    // Persistent HTTP session
+    bool beginHttpSession();
+    void endHttpSession();
+    bool setUserData(bool gzip);
+    bool setContentType(uint8_t encoding);
+    bool sessionGzip;           // USERDATA sesi saat ini berisi Content-Encoding: gzip
+    uint8_t sessionEncoding;    // CONTENT sesi saat ini (UPLOAD_ENCODING_*)
+    
+    // Body JSON batch, ditulis langsung oleh encoder (tanpa String)
+    char batchBuffer[GSM_BATCH_MAX_BYTES + 1];
+    const char* fallbackTimestamp(char* out, size_t size);
+    size_t encodeSample(const VatSensorData& sample, const char* fallback, char* out, size_t size);
+    size_t encodeJsonBatch(const VatSensorData* samples, size_t count, size_t& packed);
+    
+    // Body batch gzip (UPLOAD_GZIP), hanya dipakai jika lebih kecil dari body asli
+    GzipPoster gzip;
+    uint8_t gzipBuffer[GSM_BATCH_MAX_BYTES];
+    struct BatchTransport {
+        GSMApiHandler* handler;
+        uint8_t encoding;       // CONTENT body (UPLOAD_ENCODING_*)
+    };
+    static int postBatchTransport(const char* body, size_t length, bool gzip, HttpResponse& response,
+                                  void* context);
+    bool sendBatchBody(size_t length, uint8_t encoding, HttpResponse& response);
+    static int postQueueBatch(size_t length, size_t items, size_t batchIndex, HttpResponse& response,
+                              void* context);
+    
 public:
     GSMApiHandler(const char* device_id);
     ~GSMApiHandler();
@@ -46,6 +86,36 @@ public:
     bool sendSensorData(float distance1, float distance2, float latitude, float longitude, float depth);
     bool sendToProductionAPI(const String& payload);
     
+    /**
+     * @brief POST payload ke API production lewat sesi HTTP SIM800
+     * @param response Diisi status code, panjang & awal body, dan waktu request
+     * @return true jika server menjawab 2xx
+     */
+    bool sendToProductionAPI(const String& payload, HttpResponse& response);
+    bool sendToProductionAPI(const char* body, size_t length, HttpResponse& response,
+                             uint8_t encoding = UPLOAD_ENCODING_JSON, bool gzip = false);
+    
+    /**
+     * @brief Kirim banyak sampel dalam satu HTTPS POST (JSON array, CBOR, atau kolom delta sesuai UPLOAD_ENCODING)
+     * @param samples Sampel berurutan dari yang tertua
+     * @param count Jumlah sampel tersedia
+     * @return Jumlah sampel (dari awal array) yang terkirim, 0 jika gagal.
+     *         Sampel dipotong agar body tidak melebihi GSM_BATCH_MAX_BYTES.
+     *         Jika server menjawab 415 untuk CBOR/delta, batch dikirim ulang sebagai JSON.
+     *         Dengan UPLOAD_GZIP body dikompres; body gzip yang ditolak dikirim ulang apa adanya.
+     */
+    size_t sendBatch(const VatSensorData* samples, size_t count);
+    
+    /**
+     * @brief Kirim antrean offline (record JSON production) sebagai JSON array per batch
+     *        (maks GSM_BATCH_MAX_BYTES) selama GSM_DRAIN_MAX_MS
+     *
+     * Batch yang ditolak 400/413/422 dibelah dua sampai record penyebabnya ketemu lalu
+     * dibuang (postQueueRange). Error lain menghentikan sync; sisa antrean dikirim di siklus berikutnya.
+     * @return Jumlah record yang diterima server
+     */
+    size_t syncOfflineData();
+    
     // Test methods
     bool sendHTTPTestRequest(const String& payload);
     bool sendHTTPSTestRequest(const String& payload);
@@ -54,8 +124,10 @@ public:
     
     // Utility methods
     String createProductionJsonPayload(float d1, float d2, float lat, float lon, float depth);
+    String createProductionJsonPayload(const VatSensorData& sample);
     String getTimestamp();
     String getGSMNetworkTime();
+    bool syncSystemClock();
     
     // Debug methods
     void printStatus();
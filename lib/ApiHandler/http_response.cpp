@@ -0,0 +1,61 @@
+#include "http_response.h"
+#include <stdio.h>
+
+void HttpResponse::reset() {
+    statusCode = 0;
+    bodyLength = 0;
+    body[0] = '\0';
+    elapsedMs = 0;
+}
+
+bool HttpResponse::parseHttpAction(const char* line) {
+    int method = 0;
+    int status = 0;
+    unsigned long length = 0;
+    if (sscanf(line, "+HTTPACTION: %d,%d,%lu", &method, &status, &length) != 3) {
+        return false;
+    }
+
+    statusCode = status;
+    bodyLength = length;
+    return true;
+}
+
+bool parseHttpReadHeader(const char* line, size_t& length) {
+    unsigned long value = 0;
+    if (sscanf(line, "+HTTPREAD: %lu", &value) != 1) {
+        return false;
+    }
+
+    length = value;
+    return true;
+}
+
+void HttpResponse::print() const {
+    Serial.println("\n=== API RESPONSE ===");
+    Serial.printf("Status: %d, body: %u bytes, waktu: %lu ms\n", statusCode, (unsigned)bodyLength, elapsedMs);
+    if (body[0] != '\0') {
+        Serial.println(body);
+    }
+    Serial.println("====================");
+
+    if (isSuccess()) {
+        Serial.println("✅ Data diterima server");
+    } else if (statusCode == 400) {
+        Serial.println("⚠️  API Response: 400 Bad Request");
+        Serial.println("❓ Kemungkinan: format data, authentication, atau header salah");
+    } else if (statusCode == 401) {
+        Serial.println("🔒 API Response: 401 Unauthorized");
+        Serial.println("❗ Perlu authentication (API Key/Token)");
+    } else if (statusCode == 404) {
+        Serial.println("🔍 API Response: 404 Not Found");
+        Serial.println("❗ Endpoint tidak ditemukan atau method salah");
+    } else if (statusCode >= 500 && statusCode < 600) {
+        Serial.println("⚠️  API Response: Server Error (5xx)");
+        Serial.println("Kemungkinan: server API bermasalah");
+    } else if (isTransportError()) {
+        Serial.println("❌ Request tidak sampai ke server (error jaringan/transport)");
+    } else {
+        Serial.println("❓ Status HTTP tidak dikenal");
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef HTTP_RESPONSE_H
+#define HTTP_RESPONSE_H
+
+#include <Arduino.h>
+#include "../include/config.h"
+
+/**
+ * @brief Hasil satu HTTP request, sama untuk jalur GSM (SIM800) dan WiFi (HTTPClient)
+ *
+ * Status diambil dari field angka (+HTTPACTION / HTTPClient::POST), bukan dengan
+ * mencari "200" di teks respon. Body hanya disimpan sebagian (untuk log), panjang
+ * aslinya tetap dicatat di bodyLength.
+ *
+ * statusCode <= 0 : error transport HTTPClient (HTTPC_ERROR_*)
+ * statusCode 6xx  : error jaringan/DNS/SSL dari SIM800
+ */
+struct HttpResponse {
+    int statusCode;
+    size_t bodyLength;                      // Panjang body menurut server
+    char body[HTTP_RESPONSE_BODY_MAX];      // Awal body, selalu diakhiri '\0'
+    unsigned long elapsedMs;                // Dari request dikirim sampai status diterima
+
+    void reset();
+
+    bool isSuccess() const { return statusCode >= 200 && statusCode < 300; }
+    bool isTransportError() const { return statusCode <= 0 || statusCode >= 600; }
+
+    /**
+     * @brief Parse URC SIM800 "+HTTPACTION: <method>,<status>,<datalen>"
+     * @return true jika format valid (statusCode & bodyLength terisi)
+     */
+    bool parseHttpAction(const char* line);
+
+    // Cetak status, waktu dan potongan body beserta penjelasan singkat
+    void print() const;
+};
+
+/**
+ * @brief Parse header SIM800 "+HTTPREAD: <datalen>"
+ * @return true jika format valid
+ */
+bool parseHttpReadHeader(const char* line, size_t& length);
+
+#endif // HTTP_RESPONSE_H
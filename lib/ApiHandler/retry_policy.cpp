@@ -0,0 +1,170 @@
+#include "retry_policy.h"
+
+// State dibaca/ditulis dari task network, loop dan callback worker upload
+static portMUX_TYPE retryMux = portMUX_INITIALIZER_UNLOCKED;
+
+RetryPolicy::RetryPolicy(const char* name, unsigned long baseDelayMs, uint8_t failureThreshold,
+                         unsigned long openMs) {
+    this->name = name;
+    this->baseDelayMs = baseDelayMs;
+    this->failureThreshold = failureThreshold > 0 ? failureThreshold : 1;
+    this->openMs = openMs;
+    memset(&stats, 0, sizeof(stats));
+    state = RETRY_CLOSED;
+    reset();
+}
+
+const char* getRetryStateName(RetryState state) {
+    switch (state) {
+        case RETRY_OPEN:      return "OPEN";
+        case RETRY_HALF_OPEN: return "HALF_OPEN";
+        default:              return "CLOSED";
+    }
+}
+
+// Jitter: jeda acak di [1 - RETRY_JITTER, 1] x delay agar device tidak retry serempak
+unsigned long RetryPolicy::withJitter(unsigned long delayMs) const {
+    unsigned long spread = (unsigned long)(delayMs * RETRY_JITTER);
+    if (spread == 0) return delayMs;
+    return delayMs - spread + esp_random() % (spread + 1);
+}
+
+// Dipanggil di dalam critical section - log dicetak oleh caller
+void RetryPolicy::transition(RetryState next) {
+    state = next;
+    stats.lastTransitionMs = millis();
+    if (next == RETRY_OPEN) stats.opened++;
+    else if (next == RETRY_HALF_OPEN) stats.halfOpened++;
+    else stats.closed++;
+}
+
+bool RetryPolicy::canAttempt() {
+    bool allowed;
+    bool probe = false;
+
+    portENTER_CRITICAL(&retryMux);
+    bool waited = millis() - waitStartMs >= waitMs;
+    if (state == RETRY_HALF_OPEN) {
+        allowed = !probeInFlight;
+    } else {
+        allowed = waited;
+    }
+    if (allowed && state == RETRY_OPEN) {
+        transition(RETRY_HALF_OPEN);
+        probe = true;
+    }
+    if (allowed && state == RETRY_HALF_OPEN) probeInFlight = true;
+    if (allowed) {
+        stats.attempts++;
+    } else {
+        stats.skipped++;
+    }
+    portEXIT_CRITICAL(&retryMux);
+
+    if (probe) {
+        Serial.printf("🔌 %s: breaker HALF_OPEN - probing link\n", name);
+    }
+    return allowed;
+}
+
+void RetryPolicy::recordSuccess() {
+    portENTER_CRITICAL(&retryMux);
+    bool recovered = state != RETRY_CLOSED;
+    stats.successes++;
+    consecutiveFailures = 0;
+    openCount = 0;
+    probeInFlight = false;
+    waitMs = 0;
+    if (recovered) transition(RETRY_CLOSED);
+    portEXIT_CRITICAL(&retryMux);
+
+    if (recovered) {
+        Serial.printf("✅ %s: breaker CLOSED - link recovered\n", name);
+    }
+}
+
+void RetryPolicy::recordFailure() {
+    portENTER_CRITICAL(&retryMux);
+    stats.failures++;
+    if (state == RETRY_OPEN) {
+        // Hasil terlambat (request yang sudah in-flight saat breaker terbuka) - cooldown tidak diubah
+        portEXIT_CRITICAL(&retryMux);
+        return;
+    }
+    if (consecutiveFailures < 255) consecutiveFailures++;
+    probeInFlight = false;
+    waitStartMs = millis();
+
+    bool opened = state == RETRY_HALF_OPEN || consecutiveFailures >= failureThreshold;
+    if (opened) {
+        // Cooldown berlipat setiap probe gagal
+        unsigned long cooldown = openMs << (openCount < 8 ? openCount : 8);
+        if (cooldown > RETRY_MAX_DELAY_MS || cooldown < openMs) cooldown = RETRY_MAX_DELAY_MS;
+        if (openCount < 255) openCount++;
+        waitMs = withJitter(cooldown);
+        if (state != RETRY_OPEN) transition(RETRY_OPEN);
+    } else {
+        unsigned long delayMs = baseDelayMs << (consecutiveFailures - 1);
+        if (delayMs > RETRY_MAX_DELAY_MS || delayMs < baseDelayMs) delayMs = RETRY_MAX_DELAY_MS;
+        waitMs = withJitter(delayMs);
+    }
+    unsigned long retryMs = waitMs;
+    uint8_t failures = consecutiveFailures;
+    portEXIT_CRITICAL(&retryMux);
+
+    if (opened) {
+        Serial.printf("⛔ %s: breaker OPEN after %u failures - next probe in %lu s\n",
+                      name, (unsigned)failures, retryMs / 1000);
+    } else {
+        Serial.printf("⏳ %s: attempt failed (%u/%u) - retry in %lu s\n",
+                      name, (unsigned)failures, (unsigned)failureThreshold, retryMs / 1000);
+    }
+}
+
+void RetryPolicy::cancelAttempt() {
+    portENTER_CRITICAL(&retryMux);
+    probeInFlight = false;
+    if (stats.attempts > 0) stats.attempts--;
+    portEXIT_CRITICAL(&retryMux);
+}
+
+void RetryPolicy::reset() {
+    portENTER_CRITICAL(&retryMux);
+    if (state != RETRY_CLOSED) transition(RETRY_CLOSED);
+    consecutiveFailures = 0;
+    openCount = 0;
+    probeInFlight = false;
+    waitStartMs = millis();
+    waitMs = 0;
+    portEXIT_CRITICAL(&retryMux);
+}
+
+unsigned long RetryPolicy::getRetryInMs() const {
+    portENTER_CRITICAL(&retryMux);
+    unsigned long elapsed = millis() - waitStartMs;
+    unsigned long remaining = elapsed < waitMs ? waitMs - elapsed : 0;
+    portEXIT_CRITICAL(&retryMux);
+    return remaining;
+}
+
+RetryPolicyStats RetryPolicy::getStats() const {
+    portENTER_CRITICAL(&retryMux);
+    RetryPolicyStats copy = stats;
+    portEXIT_CRITICAL(&retryMux);
+    return copy;
+}
+
+void RetryPolicy::printStats() const {
+    RetryPolicyStats copy = getStats();
+    Serial.printf("\n🔁 RETRY POLICY (%s): %s", name, getRetryStateName(state));
+    unsigned long retryIn = getRetryInMs();
+    if (retryIn > 0) {
+        Serial.printf(", next attempt in %lu s", retryIn / 1000);
+    }
+    Serial.println();
+    Serial.printf("  Attempts: %lu (ok %lu, failed %lu), skipped: %lu\n", (unsigned long)copy.attempts,
+                  (unsigned long)copy.successes, (unsigned long)copy.failures, (unsigned long)copy.skipped);
+    Serial.printf("  Transitions: open %lu, half-open %lu, closed %lu (last %lu s ago)\n",
+                  (unsigned long)copy.opened, (unsigned long)copy.halfOpened, (unsigned long)copy.closed,
+                  copy.lastTransitionMs > 0 ? (millis() - copy.lastTransitionMs) / 1000 : 0UL);
+}
@@ -0,0 +1,96 @@
+#ifndef RETRY_POLICY_H
+#define RETRY_POLICY_H
+
+#include <Arduino.h>
+#include "../include/config.h"
+
+// =======================================================
+//   RETRY POLICY (backoff + circuit breaker)
+//   CLOSED    : percobaan diizinkan; setelah gagal, percobaan berikutnya ditunda
+//               base x 2^(gagal - 1) (maks RETRY_MAX_DELAY_MS) dengan jitter.
+//   OPEN      : setelah failureThreshold kegagalan berturut-turut link dianggap mati -
+//               tidak ada percobaan sampai cooldown habis (data langsung ke antrean offline).
+//   HALF_OPEN : cooldown habis, tepat satu probe. Berhasil -> CLOSED,
+//               gagal -> OPEN lagi dengan cooldown dua kali lipat (maks RETRY_MAX_DELAY_MS).
+//   Aman dipanggil dari beberapa task (state dilindungi critical section).
+// =======================================================
+
+enum RetryState {
+    RETRY_CLOSED = 0,
+    RETRY_OPEN,
+    RETRY_HALF_OPEN
+};
+
+struct RetryPolicyStats {
+    uint32_t attempts;          // canAttempt() == true
+    uint32_t successes;
+    uint32_t failures;
+    uint32_t skipped;           // canAttempt() == false (backoff / breaker terbuka)
+    uint32_t opened;            // Transisi ke OPEN
+    uint32_t halfOpened;        // Transisi ke HALF_OPEN (probe)
+    uint32_t closed;            // Transisi HALF_OPEN -> CLOSED (link pulih)
+    unsigned long lastTransitionMs;
+};
+
+class RetryPolicy {
+public:
+    /**
+     * @param name Nama untuk log ("gsm", "wifi", ...)
+     * @param baseDelayMs Jeda setelah kegagalan pertama
+     * @param failureThreshold Kegagalan berturut-turut sebelum breaker terbuka
+     * @param openMs Cooldown pertama breaker
+     */
+    RetryPolicy(const char* name, unsigned long baseDelayMs, uint8_t failureThreshold,
+                unsigned long openMs = RETRY_OPEN_MS);
+
+    /**
+     * @brief Boleh mencoba sekarang? Jika true, hasilnya wajib dilaporkan lewat
+     *        recordSuccess() / recordFailure(), atau cancelAttempt() jika request batal dikirim
+     */
+    bool canAttempt();
+    void recordSuccess();
+    void recordFailure();
+
+    /**
+     * @brief Kembalikan izin dari canAttempt() tanpa hasil (tidak ada request yang keluar).
+     *        Di HALF_OPEN probe boleh dicoba lagi pada canAttempt() berikutnya.
+     */
+    void cancelAttempt();
+
+    /**
+     * @brief Kembali ke CLOSED tanpa jeda (mis. reconnect manual dari serial command)
+     */
+    void reset();
+
+    RetryState getState() const { return state; }
+    bool isOpen() const { return state == RETRY_OPEN; }
+
+    /**
+     * @brief Sisa waktu sampai percobaan berikutnya diizinkan (0 = sekarang)
+     */
+    unsigned long getRetryInMs() const;
+
+    RetryPolicyStats getStats() const;
+    void printStats() const;
+
+private:
+    const char* name;
+    unsigned long baseDelayMs;
+    uint8_t failureThreshold;
+    unsigned long openMs;
+
+    RetryState state;
+    uint8_t consecutiveFailures;
+    uint8_t openCount;          // OPEN berturut-turut tanpa probe berhasil (untuk cooldown)
+    bool probeInFlight;
+    unsigned long waitStartMs;
+    unsigned long waitMs;       // Percobaan berikutnya pada waitStartMs + waitMs
+    RetryPolicyStats stats;
+
+    void transition(RetryState next);
+    unsigned long withJitter(unsigned long delayMs) const;
+};
+
+const char* getRetryStateName(RetryState state);
+
+#endif // RETRY_POLICY_H
@@ -1,10 +1,72 @@
 #include "wifi_api_handler.h"
 #include <time.h>
 
+int httpPostJson(HTTPClient& http, const char* body, size_t length, HttpResponse& response) {
+    response.reset();
+    unsigned long startTime = millis();
+    
+    response.statusCode = http.POST((uint8_t*)body, length);
+    response.elapsedMs = millis() - startTime;
+    if (response.statusCode <= 0) {
+        return response.statusCode;
+    }
+    
+    // Simpan awal body langsung dari stream, tanpa http.getString()
+    int size = http.getSize();  // -1 = chunked / tidak diketahui
+    WiFiClient* stream = http.getStreamPtr();
+    if (size > 0 && stream != NULL) {
+        response.bodyLength = size;
+        size_t wanted = (size_t)size < sizeof(response.body) - 1 ? (size_t)size : sizeof(response.body) - 1;
+        size_t got = stream->readBytes(response.body, wanted);
+        response.body[got] = '\0';
+        
+        // Sisa body dibuang agar koneksi keep-alive (setReuse) bisa dipakai request berikutnya
+        char discard[64];
+        size_t remaining = size - got;
+        while (remaining > 0 && got > 0) {
+            got = stream->readBytes(discard, remaining < sizeof(discard) ? remaining : sizeof(discard));
+            remaining -= got;
+        }
+    } else if (size < 0) {
+        // Chunked - getString() membaca sampai chunk terakhir
+        String body = http.getString();
+        response.bodyLength = body.length();
+        strlcpy(response.body, body.c_str(), sizeof(response.body));
+    }
+    
+    return response.statusCode;
+}
+
+int httpPostJson(HTTPClient& http, const String& payload, HttpResponse& response) {
+    return httpPostJson(http, payload.c_str(), payload.length(), response);
+}
+
 WiFiApiHandler::WiFiApiHandler(const char* url, const char* device_id, unsigned long timeout_ms) {
     apiUrl = String(url);
     deviceId = String(device_id);
     timeout = timeout_ms;
+    drainResponseMs = 0;
+    gzip.setEnabled(UPLOAD_GZIP);
+    lastRequestMs = 0;
+    memset(&connectionStats, 0, sizeof(connectionStats));
+    
+    // Host & port untuk connect() manual, agar handshake terukur terpisah dari request (HTTPS saja)
+    int hostStart = apiUrl.indexOf("://");
+    hostStart = hostStart < 0 ? 0 : hostStart + 3;
+    int pathStart = apiUrl.indexOf('/', hostStart);
+    String authority = pathStart < 0 ? apiUrl.substring(hostStart) : apiUrl.substring(hostStart, pathStart);
+    int colon = authority.indexOf(':');
+    apiHost = colon < 0 ? authority : authority.substring(0, colon);
+    apiPort = colon < 0 ? 443 : authority.substring(colon + 1).toInt();
+    
+    if (WIFI_API_ROOT_CA != NULL) {
+        secureClient.setCACert(WIFI_API_ROOT_CA);
+    } else {
+        secureClient.setInsecure();
+    }
+    secureClient.setHandshakeTimeout(timeout / 1000);
+    http.setTimeout(timeout);
+    http.setReuse(true);  // Header "Connection: keep-alive", socket tidak ditutup setelah respon
 }
 
 void WiFiApiHandler::setupSDCard() {
@@ -16,6 +78,84 @@ bool WiFiApiHandler::isConnected() {
     return WiFi.status() == WL_CONNECTED;
 }
 
+// =======================================================
+//   PERSISTENT HTTPS CONNECTION
+// =======================================================
+
+bool WiFiApiHandler::ensureConnection(bool& reused) {
+    reused = false;
+    if (!isConnected()) return false;
+    
+    if (secureClient.connected()) {
+        if (millis() - lastRequestMs < WIFI_HTTP_KEEPALIVE_MS) {
+            reused = true;
+            return true;
+        }
+        // Idle terlalu lama - server kemungkinan sudah menutup koneksi
+        secureClient.stop();
+    }
+    
+    unsigned long startMs = millis();
+    if (!secureClient.connect(apiHost.c_str(), apiPort)) {
+        char error[64] = "";
+        secureClient.lastError(error, sizeof(error));
+        connectionStats.handshakeFailures++;
+        Serial.printf("❌ TLS connect to %s:%u failed: %s\n", apiHost.c_str(), apiPort, error);
+        return false;
+    }
+    
+    unsigned long elapsed = millis() - startMs;
+    connectionStats.handshakes++;
+    connectionStats.lastHandshakeMs = elapsed;
+    connectionStats.avgHandshakeMs = connectionStats.handshakes > 1
+                                     ? connectionStats.avgHandshakeMs * 0.8f + elapsed * 0.2f
+                                     : elapsed;
+    Serial.printf("🔐 TLS handshake %s:%u in %lu ms (free heap %u)\n", apiHost.c_str(), apiPort,
+                  elapsed, (unsigned)ESP.getFreeHeap());
+    return true;
+}
+
+int WiFiApiHandler::postJson(const char* body, size_t length, HttpResponse& response, const char* userAgent,
+                             bool gzip) {
+    for (int attempt = 0; ; attempt++) {
+        bool reused;
+        if (!ensureConnection(reused)) {
+            response.reset();
+            response.statusCode = HTTPC_ERROR_CONNECTION_REFUSED;
+            return response.statusCode;
+        }
+        
+        http.begin(secureClient, apiUrl);  // Hanya reset URL & header, socket tetap dipakai
+        http.addHeader("Content-Type", "application/json");
+        http.addHeader("User-Agent", userAgent);
+        if (gzip) http.addHeader("Content-Encoding", "gzip");
+        int httpResponseCode = httpPostJson(http, body, length, response);
+        lastRequestMs = millis();
+        
+        if (httpResponseCode > 0) {
+            connectionStats.requests++;
+            if (reused) connectionStats.reusedRequests++;
+            connectionStats.avgRequestMs = connectionStats.requests > 1
+                                           ? connectionStats.avgRequestMs * 0.8f + response.elapsedMs * 0.2f
+                                           : response.elapsedMs;
+            return httpResponseCode;
+        }
+        
+        secureClient.stop();
+        // Socket keep-alive yang sudah ditutup server baru ketahuan saat menulis - ulangi sekali
+        // dengan koneksi baru. Read timeout tidak diulang (server mungkin sudah memproses request).
+        if (!reused || attempt > 0 || httpResponseCode == HTTPC_ERROR_READ_TIMEOUT) {
+            return httpResponseCode;
+        }
+        connectionStats.reconnects++;
+        Serial.println("🔁 Keep-alive socket closed by server - reconnecting");
+    }
+}
+
+void WiFiApiHandler::closeConnection() {
+    secureClient.stop();
+}
+
 bool WiFiApiHandler::checkConnection() {
     if (!isConnected()) {
         Serial.println("❌ WiFi not connected");
@@ -59,18 +199,27 @@ String WiFiApiHandler::getISOTimestamp() {
 }
 
 String WiFiApiHandler::createJsonPayload(float d1, float d2, float lat, float lon, float depth) {
-    DynamicJsonDocument doc(1024);
-    
-    doc["device_id"] = deviceId;
-    doc["data"]["distance1"] = round(d1 * 10) / 10.0;  // Round to 1 decimal
-    doc["data"]["distance2"] = round(d2 * 10) / 10.0;
-    doc["data"]["latitude"] = lat;
-    doc["data"]["longitude"] = lon;
-    doc["timestamp"] = getISOTimestamp();
-    
-    String payload;
-    serializeJsonPretty(doc, payload);
-    return payload;
+    char payload[PRODUCTION_JSON_MAX_SIZE];
+    encodePayload(d1, d2, lat, lon, depth, payload, sizeof(payload));
+    return String(payload);
+}
+
+size_t WiFiApiHandler::encodePayload(float d1, float d2, float lat, float lon, float depth, char* out, size_t size) {
+    // Schema production API (sama dengan jalur GSM)
+    VatSensorData sample = {0};
+    sample.isValid = false;  // Waktu saat ini dari jam sistem (NTP)
+    sample.distance1 = d1;
+    sample.distance2 = d2;
+    sample.latitude = lat;
+    sample.longitude = lon;
+    sample.depth = depth;
+    
+    char timestamp[WIB_TIMESTAMP_SIZE];
+    if (format_wib_timestamp_now(timestamp, sizeof(timestamp)) == 0) {
+        String fallback = getISOTimestamp();
+        strlcpy(timestamp, fallback.c_str(), sizeof(timestamp));
+    }
+    return encode_production_json(sample, deviceId.c_str(), timestamp, out, size);
 }
 
 bool WiFiApiHandler::sendSensorData(float distance1, float distance2, float latitude, float longitude, float depth) {
@@ -90,41 +239,34 @@ bool WiFiApiHandler::sendSensorData(float distance1, float distance2, float lati
     Serial.println("========================================");
     
     // Create JSON payload
-    String payload = createJsonPayload(distance1, distance2, latitude, longitude, depth);
+    char payload[PRODUCTION_JSON_MAX_SIZE];
+    size_t payloadLength = encodePayload(distance1, distance2, latitude, longitude, depth,
+                                         payload, sizeof(payload));
     
     Serial.println("📋 JSON Payload:");
     Serial.println(payload);
     Serial.println("========================================");
     
-    // Send HTTP POST request
-    HTTPClient http;
-    http.setTimeout(timeout);
-    http.begin(apiUrl);
-    http.addHeader("Content-Type", "application/json");
-    http.addHeader("User-Agent", "ESP32-VAT-Monitor/1.0");
-    
-    int httpResponseCode = http.POST(payload);
+    // Send HTTP POST request (koneksi persisten)
+    HttpResponse response;
+    int httpResponseCode = postJson(payload, payloadLength, response, "ESP32-VAT-Monitor/1.0");
     
     if (httpResponseCode > 0) {
-        String response = http.getString();
         Serial.print("✅ HTTP Response Code: ");
         Serial.println(httpResponseCode);
         
-        if (httpResponseCode == 200 || httpResponseCode == 201) {
+        if (response.isSuccess()) {
             Serial.println("✅ Data sent successfully!");
             Serial.print("📥 Response: ");
-            Serial.println(response);
+            Serial.println(response.body);
             
             // Save to SD card for backup/logging
             saveToOfflineQueue(distance1, distance2, latitude, longitude, depth);
-            
-            http.end();
             return true;
         } else {
             Serial.print("⚠️ API returned error code: ");
             Serial.println(httpResponseCode);
-            Serial.print("📥 Response: ");
-            Serial.println(response);
+            response.print();
             
             // Save to offline queue for later sync
             saveToOfflineQueue(distance1, distance2, latitude, longitude, depth);
@@ -161,7 +303,6 @@ bool WiFiApiHandler::sendSensorData(float distance1, float distance2, float lati
         }
     }
     
-    http.end();
     return false;
 }
 
@@ -197,6 +338,16 @@ void WiFiApiHandler::printStatus() {
         Serial.print(WiFi.RSSI());
         Serial.println(" dBm");
     }
+    
+    const HttpConnectionStats& stats = connectionStats;
+    Serial.printf("🔐 TLS: %lu handshakes (%lu failed), avg %.0f ms, last %lu ms\n",
+                  (unsigned long)stats.handshakes, (unsigned long)stats.handshakeFailures,
+                  stats.avgHandshakeMs, stats.lastHandshakeMs);
+    Serial.printf("📨 Requests: %lu (%lu on reused socket, %lu reconnects), avg %.0f ms\n",
+                  (unsigned long)stats.requests, (unsigned long)stats.reusedRequests,
+                  (unsigned long)stats.reconnects, stats.avgRequestMs);
+    Serial.print("Socket: ");
+    Serial.println(secureClient.connected() ? "open (keep-alive)" : "closed");
 }
 
 bool WiFiApiHandler::testApiConnection() {
@@ -207,25 +358,73 @@ bool WiFiApiHandler::testApiConnection() {
     
     Serial.println("\n🔍 Testing API Connection...");
     
-    HTTPClient http;
-    http.setTimeout(5000);  // Shorter timeout for test
-    http.begin(apiUrl);
+    // Koneksi baru agar waktu handshake TLS ikut terukur
+    closeConnection();
+    bool reused;
+    if (!ensureConnection(reused)) {
+        Serial.println("❌ API Server unreachable - TLS connect failed");
+        return false;
+    }
     
+    http.setTimeout(5000);  // Shorter timeout for test
+    http.begin(secureClient, apiUrl);
     int httpResponseCode = http.GET();  // Simple GET to test connectivity
+    http.setTimeout(timeout);
+    lastRequestMs = millis();
+    
+    // Body GET tidak dibaca - socket ditutup agar request berikutnya tidak membaca sisanya
+    closeConnection();
     
     if (httpResponseCode > 0) {
         Serial.print("✅ API Server reachable - Response: ");
         Serial.println(httpResponseCode);
-        http.end();
         return true;
     } else {
         Serial.print("❌ API Server unreachable - Error: ");
         Serial.println(httpResponseCode);
-        http.end();
         return false;
     }
 }
 
+int WiFiApiHandler::postBatchTransport(const char* body, size_t length, bool gzip, HttpResponse& response,
+                                       void* context) {
+    return ((WiFiApiHandler*)context)->postJson(body, length, response, "ESP32-VAT-Monitor/1.0-Sync", gzip);
+}
+
+// POST batchBuffer lewat koneksi keep-alive (gzip + fallback di GzipPoster)
+int WiFiApiHandler::postBatch(size_t length, HttpResponse& response, size_t& sentLength) {
+    return gzip.post(batchBuffer, length, gzipBuffer, sizeof(gzipBuffer), postBatchTransport, this,
+                     response, sentLength);
+}
+
+unsigned long WiFiApiHandler::getDrainGapMs() const {
+    unsigned long gap = (unsigned long)(drainResponseMs * WIFI_DRAIN_PACING_FACTOR);
+    if (gap < WIFI_DRAIN_MIN_GAP_MS) return WIFI_DRAIN_MIN_GAP_MS;
+    if (gap > WIFI_DRAIN_MAX_GAP_MS) return WIFI_DRAIN_MAX_GAP_MS;
+    return gap;
+}
+
+// Satu POST batch antrean untuk postQueueRange() - pacing, EWMA waktu respon, log per batch
+int WiFiApiHandler::postQueueBatch(size_t length, size_t items, size_t batchIndex, HttpResponse& response,
+                                   void* context) {
+    WiFiApiHandler* handler = (WiFiApiHandler*)context;
+    
+    // Pacing: jeda mengikuti waktu respon server, bukan delay tetap
+    if (batchIndex > 0) delay(handler->getDrainGapMs());
+    
+    size_t sentLength;
+    int httpResponseCode = handler->postBatch(length, response, sentLength);
+    if (httpResponseCode > 0) {
+        handler->drainResponseMs = handler->drainResponseMs > 0
+                                       ? handler->drainResponseMs * 0.8f + response.elapsedMs * 0.2f
+                                       : response.elapsedMs;
+    }
+    
+    Serial.printf("📤 Batch %u: %u records, %u bytes -> %d (%lu ms)\n", (unsigned)(batchIndex + 1),
+                  (unsigned)items, (unsigned)sentLength, httpResponseCode, response.elapsedMs);
+    return httpResponseCode;
+}
+
 bool WiFiApiHandler::syncOfflineData() {
     if (!isConnected()) {
         Serial.println("❌ WiFi not connected - cannot sync offline data");
@@ -238,49 +437,30 @@ bool WiFiApiHandler::syncOfflineData() {
     }
     
     Serial.println("🔄 Syncing offline data...");
-    int syncCount = 0;
-    int maxSyncAttempts = 10; // Prevent infinite loop
     
-    while (isOfflineQueueNotEmpty() && syncCount < maxSyncAttempts) {
-        String payload = readNextLineFromQueue();
-        if (payload.length() == 0) break;
-        
-        Serial.print("📤 Syncing payload ");
-        Serial.print(syncCount + 1);
-        Serial.print(": ");
-        Serial.println(payload.substring(0, 50) + "...");
-        
-        // Send via HTTP
-        HTTPClient http;
-        http.setTimeout(timeout);
-        http.begin(apiUrl);
-        http.addHeader("Content-Type", "application/json");
-        http.addHeader("User-Agent", "ESP32-VAT-Monitor/1.0-Sync");
+    // Record yang tidak di-ack tetap di antrean untuk peek berikutnya (tidak perlu revert)
+    static char records[QUEUE_PEEK_MAX_RECORDS * (QUEUE_RECORD_MAX_SIZE + 2)];
+    const char* payloads[QUEUE_PEEK_MAX_RECORDS];
+    size_t lengths[QUEUE_PEEK_MAX_RECORDS];
+    
+    QueueDrainStats stats = {0, 0, 0, false};
+    unsigned long startMs = millis();
+    while (!stats.stopped && isConnected() && millis() - startMs < WIFI_DRAIN_MAX_MS) {
+        size_t count = peekOfflineQueue(QUEUE_PEEK_MAX_RECORDS, records, sizeof(records), payloads, lengths);
+        if (count == 0) break;
         
-        int httpResponseCode = http.POST(payload);
+        size_t done = postQueueRange(payloads, lengths, count, batchBuffer, WIFI_DRAIN_BATCH_BYTES,
+                                     postQueueBatch, this, stats);
         
-        if (httpResponseCode == 200 || httpResponseCode == 201) {
-            Serial.println("✅ Offline data synced successfully");
-            syncCount++;
-        } else {
-            Serial.print("❌ Sync failed with code: ");
-            Serial.println(httpResponseCode);
-            revertProgress(payload);
-            http.end();
-            break;
-        }
-        
-        http.end();
-        delay(1000); // Rate limiting
+        // Satu update metadata per batch
+        if (done > 0 && !ackOfflineQueue(done)) break;
     }
     
-    if (syncCount > 0) {
-        Serial.print("✅ Successfully synced ");
-        Serial.print(syncCount);
-        Serial.println(" offline records");
-    }
+    Serial.printf("%s Synced %u offline records in %u batches (%u rejected) in %lu ms, server ~%.0f ms/batch\n",
+                  stats.stopped ? "⚠️" : "✅", (unsigned)stats.sent, (unsigned)stats.batches,
+                  (unsigned)stats.rejected, millis() - startMs, drainResponseMs);
     
-    return syncCount > 0;
+    return stats.sent > 0;
 }
 
 void WiFiApiHandler::saveToOfflineQueue(float distance1, float distance2, float latitude, float longitude, float depth) {
@@ -303,6 +483,7 @@ void WiFiApiHandler::saveToOfflineQueue(float distance1, float distance2, float
     data.second = (currentMillis / 1000) % 60;
     data.satellites = 0;
     data.hdop = 0.0;
+    data.capturedAtMs = currentMillis;
     
     // Save to daily log and offline queue
     backupCriticalData(data);
@@ -3,9 +3,32 @@
 
 #include <Arduino.h>
 #include <WiFi.h>
+#include <WiFiClientSecure.h>
 #include <HTTPClient.h>
-#include <ArduinoJson.h>
 #include "../SdUtils/sd_utils.h"
+#include "http_response.h"
+#include "../Telemetry/telemetry_json.h"
+#include "batch_post.h"
+
+/**
+ * @brief POST body JSON lewat HTTPClient yang sudah di-begin()
+ * @param response Diisi status code, panjang & awal body, dan waktu request
+ * @return Status code dari HTTPClient::POST (<= 0 = error transport)
+ */
+int httpPostJson(HTTPClient& http, const char* body, size_t length, HttpResponse& response);
+int httpPostJson(HTTPClient& http, const String& payload, HttpResponse& response);
+
+// Statistik koneksi HTTPS persisten (sejak boot)
+struct HttpConnectionStats {
+    uint32_t handshakes;        // TCP + TLS handshake penuh
+    uint32_t handshakeFailures;
+    uint32_t requests;
+    uint32_t reusedRequests;    // Request lewat socket yang sudah terbuka (tanpa handshake)
+    uint32_t reconnects;        // Socket keep-alive ternyata mati, disambung ulang otomatis
+    unsigned long lastHandshakeMs;
+    float avgHandshakeMs;       // EWMA
+    float avgRequestMs;         // EWMA, dari kirim request sampai status diterima (tanpa handshake)
+};
 
 class WiFiApiHandler {
 private:
@@ -13,6 +36,33 @@ private:
     String deviceId;
     unsigned long timeout;
     
+    // Satu koneksi HTTPS untuk semua request (keep-alive), dibuka ulang jika mati
+    WiFiClientSecure secureClient;
+    HTTPClient http;
+    String apiHost;
+    uint16_t apiPort;
+    unsigned long lastRequestMs;
+    HttpConnectionStats connectionStats;
+    
+    bool ensureConnection(bool& reused);
+    int postJson(const char* body, size_t length, HttpResponse& response, const char* userAgent, bool gzip = false);
+    
+    size_t encodePayload(float d1, float d2, float lat, float lon, float depth, char* out, size_t size);
+    
+    // Drain antrean offline: body JSON array ditulis langsung di batchBuffer (tanpa String)
+    char batchBuffer[WIFI_DRAIN_BATCH_BYTES + 1];
+    float drainResponseMs;      // EWMA waktu respon server selama drain (untuk pacing)
+    static int postQueueBatch(size_t length, size_t items, size_t batchIndex, HttpResponse& response,
+                              void* context);
+    
+    // Body batch gzip (UPLOAD_GZIP), hanya dipakai jika lebih kecil dari body asli
+    GzipPoster gzip;
+    uint8_t gzipBuffer[WIFI_DRAIN_BATCH_BYTES];
+    static int postBatchTransport(const char* body, size_t length, bool gzip, HttpResponse& response,
+                                  void* context);
+    int postBatch(size_t length, HttpResponse& response, size_t& sentLength);
+    unsigned long getDrainGapMs() const;
+    
 public:
     WiFiApiHandler(const char* url, const char* device_id, unsigned long timeout_ms = 20000);
     
@@ -20,6 +70,17 @@ public:
     void setupSDCard();
     
     // Offline sync methods
+    
+    /**
+     * @brief Kirim antrean offline per batch (sampai QUEUE_PEEK_MAX_RECORDS record /
+     *        WIFI_DRAIN_BATCH_BYTES) lewat satu koneksi keep-alive selama WIFI_DRAIN_MAX_MS
+     *
+     * Batch di-ack utuh jika server menjawab 2xx. Jika ditolak 400/413/422, batch dibelah
+     * dua sampai record yang ditolak ketemu dan dibuang. Error transport/5xx/lainnya
+     * menghentikan sync (record tetap di antrean). Jeda antar POST = WIFI_DRAIN_PACING_FACTOR
+     * x waktu respon server.
+     * @return true jika ada record yang terkirim
+     */
     bool syncOfflineData();
     void saveToOfflineQueue(float distance1, float distance2, float latitude, float longitude, float depth);
     
@@ -27,6 +88,12 @@ public:
     bool isConnected();
     bool checkConnection();
     
+    /**
+     * @brief Tutup socket HTTPS persisten (request berikutnya handshake ulang)
+     */
+    void closeConnection();
+    const HttpConnectionStats& getConnectionStats() const { return connectionStats; }
+    
     // API methods
     bool sendSensorData(float distance1, float distance2, float latitude, float longitude, float depth);
     bool sendTestData();
@@ -0,0 +1,110 @@
+#ifndef SAMPLE_RING_H
+#define SAMPLE_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+/**
+ * @brief Ring buffer lock-free single-producer / single-consumer
+ *
+ * Satu task boleh memanggil push() (producer) dan satu task lain boleh memanggil
+ * pop()/popBatch()/peekBatch()/consume() (consumer). Semua operasi wait-free:
+ * tidak ada mutex, tidak ada loop retry. Index berjalan bebas (32-bit) dan
+ * di-mask dengan N - 1, sehingga kapasitas harus pangkat dua.
+ *
+ * Jika ring penuh, push() menolak sampel baru dan menaikkan overflow counter.
+ */
+template <typename T, size_t N>
+class SampleRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SampleRing capacity must be a power of two");
+
+public:
+    SampleRing() : head(0), tail(0), overflows(0) {}
+
+    static size_t capacity() { return N; }
+
+    // --- Producer ---
+
+    bool push(const T& item) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        uint32_t t = tail.load(std::memory_order_acquire);
+        if (h - t >= N) {
+            overflows.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        buffer[h & MASK] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // --- Consumer ---
+
+    bool pop(T& item) {
+        return popBatch(&item, 1) == 1;
+    }
+
+    /**
+     * @brief Salin hingga maxItems sampel tertua lalu keluarkan dari ring
+     * @return Jumlah sampel yang disalin
+     */
+    size_t popBatch(T* out, size_t maxItems) {
+        size_t count = peekBatch(out, maxItems);
+        consume(count);
+        return count;
+    }
+
+    /**
+     * @brief Salin hingga maxItems sampel tertua tanpa mengeluarkannya
+     *
+     * Dipakai bersama consume() agar sampel baru dibuang setelah berhasil diproses
+     * (misalnya setelah upload sukses).
+     */
+    size_t peekBatch(T* out, size_t maxItems) const {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        uint32_t h = head.load(std::memory_order_acquire);
+        size_t available = h - t;
+        size_t count = available < maxItems ? available : maxItems;
+        for (size_t i = 0; i < count; i++) {
+            out[i] = buffer[(t + i) & MASK];
+        }
+        return count;
+    }
+
+    /**
+     * @brief Keluarkan n sampel tertua (n dibatasi jumlah sampel yang ada)
+     */
+    void consume(size_t n) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        uint32_t h = head.load(std::memory_order_acquire);
+        size_t available = h - t;
+        if (n > available) n = available;
+        tail.store(t + n, std::memory_order_release);
+    }
+
+    // --- Status (aman dipanggil dari task mana pun, nilai bersifat snapshot) ---
+
+    size_t size() const {
+        // tail dibaca dulu: head yang dibaca setelahnya selalu >= tail
+        uint32_t t = tail.load(std::memory_order_acquire);
+        uint32_t h = head.load(std::memory_order_acquire);
+        return h - t;
+    }
+
+    bool empty() const { return size() == 0; }
+    bool full() const { return size() >= N; }
+
+    uint32_t getOverflowCount() const {
+        return overflows.load(std::memory_order_relaxed);
+    }
+
+private:
+    static const uint32_t MASK = N - 1;
+
+    T buffer[N];
+    std::atomic<uint32_t> head;       // Ditulis hanya oleh producer
+    std::atomic<uint32_t> tail;       // Ditulis hanya oleh consumer
+    std::atomic<uint32_t> overflows;
+};
+
+#endif // SAMPLE_RING_H
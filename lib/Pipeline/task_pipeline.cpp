@@ -0,0 +1,174 @@
+#include "task_pipeline.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sample_ring.h"
+#include "../VatSensor/sensors.h"
+
+// Ring SPSC ukuran tetap (satu per konsumen, producer = task akuisisi)
+static SampleRing<VatSensorData, PIPELINE_STORAGE_RING_SIZE> storageRing;
+static SampleRing<VatSensorData, PIPELINE_UPLOAD_RING_SIZE> uploadRing;
+
+static TaskHandle_t acquisitionTask = NULL;
+static TaskHandle_t storageTask = NULL;
+static TaskHandle_t networkTask = NULL;
+
+static PipelineConfig pipelineConfig;
+static uint32_t samplesProduced = 0;
+static uint32_t samplesStored = 0;
+static uint32_t samplesUploaded = 0;
+
+// Sampel terakhir untuk serial command / display
+static portMUX_TYPE latestMux = portMUX_INITIALIZER_UNLOCKED;
+static VatSensorData latestSample;
+static bool hasLatestSample = false;
+
+// =======================================================
+//   TASK AKUISISI
+// =======================================================
+
+static void acquisition_task(void* param) {
+    TickType_t lastWake = xTaskGetTickCount();
+    unsigned long lastSample = 0;
+
+    for (;;) {
+        // Kuras UART sensor & GPS (non-blocking)
+        read_ultrasonic_sensors();
+        read_gps_data();
+
+        unsigned long now = millis();
+        if (now - lastSample >= pipelineConfig.sampleIntervalMs) {
+            lastSample = now;
+
+            VatSensorData sample;
+            build_sensor_record(sample);
+            samplesProduced++;
+
+            portENTER_CRITICAL(&latestMux);
+            latestSample = sample;
+            hasLatestSample = true;
+            portEXIT_CRITICAL(&latestMux);
+
+            // Tidak pernah menunggu konsumen - ring penuh dihitung sebagai overflow
+            if (storageTask && storageRing.push(sample)) {
+                xTaskNotifyGive(storageTask);
+            }
+            if (networkTask) {
+                uploadRing.push(sample);
+            }
+
+            if (pipelineConfig.onSample) {
+                pipelineConfig.onSample(sample);
+            }
+        }
+
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(PIPELINE_ACQ_POLL_MS));
+    }
+}
+
+// =======================================================
+//   TASK STORAGE
+// =======================================================
+
+static void storage_task(void* param) {
+    VatSensorData sample;
+
+    for (;;) {
+        // Dibangunkan oleh task akuisisi setiap ada sampel baru
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        while (storageRing.pop(sample)) {
+            pipelineConfig.store(sample);
+            samplesStored++;
+        }
+    }
+}
+
+// =======================================================
+//   TASK NETWORK
+// =======================================================
+
+static void network_task(void* param) {
+    static VatSensorData pending[PIPELINE_UPLOAD_RING_SIZE];
+
+    for (;;) {
+        // Tunggu interval upload, atau lebih cepat jika request_pipeline_upload() dipanggil
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(pipelineConfig.uploadIntervalMs));
+
+        // Sampel baru dikeluarkan dari ring setelah callback upload selesai memprosesnya
+        size_t count = uploadRing.peekBatch(pending, PIPELINE_UPLOAD_RING_SIZE);
+        if (count == 0) continue;
+
+        size_t done = pipelineConfig.upload(pending, count);
+        if (done > count) done = count;
+        uploadRing.consume(done);
+        samplesUploaded += done;
+    }
+}
+
+// =======================================================
+//   PUBLIC API
+// =======================================================
+
+bool start_task_pipeline(const PipelineConfig& config) {
+    pipelineConfig = config;
+
+    bool ok = true;
+    if (config.store) {
+        ok &= xTaskCreatePinnedToCore(storage_task, "storage", PIPELINE_STORAGE_STACK, NULL,
+                                      PIPELINE_STORAGE_PRIORITY, &storageTask, PIPELINE_IO_CORE) == pdPASS;
+    }
+    if (config.upload) {
+        ok &= xTaskCreatePinnedToCore(network_task, "network", PIPELINE_NETWORK_STACK, NULL,
+                                      PIPELINE_NETWORK_PRIORITY, &networkTask, PIPELINE_IO_CORE) == pdPASS;
+    }
+    ok &= xTaskCreatePinnedToCore(acquisition_task, "acquisition", PIPELINE_ACQ_STACK, NULL,
+                                  PIPELINE_ACQ_PRIORITY, &acquisitionTask, PIPELINE_ACQ_CORE) == pdPASS;
+
+    if (!ok) {
+        Serial.println("❌ Pipeline: failed to create tasks");
+        return false;
+    }
+
+    Serial.println("✅ Task pipeline started");
+    Serial.printf("  Acquisition: core %d, every %lu ms\n", PIPELINE_ACQ_CORE, config.sampleIntervalMs);
+    Serial.printf("  Storage/Network: core %d, upload every %lu ms\n", PIPELINE_IO_CORE, config.uploadIntervalMs);
+    return true;
+}
+
+bool get_latest_sample(VatSensorData& sample) {
+    portENTER_CRITICAL(&latestMux);
+    bool available = hasLatestSample;
+    if (available) {
+        sample = latestSample;
+    }
+    portEXIT_CRITICAL(&latestMux);
+    return available;
+}
+
+void request_pipeline_upload() {
+    if (networkTask) {
+        xTaskNotifyGive(networkTask);
+    }
+}
+
+PipelineStats get_pipeline_stats() {
+    PipelineStats stats;
+    stats.samplesProduced = samplesProduced;
+    stats.samplesStored = samplesStored;
+    stats.samplesUploaded = samplesUploaded;
+    stats.storageDrops = storageRing.getOverflowCount();
+    stats.uploadDrops = uploadRing.getOverflowCount();
+    return stats;
+}
+
+void print_pipeline_stats() {
+    PipelineStats stats = get_pipeline_stats();
+    Serial.println("\n🧵 PIPELINE STATISTICS:");
+    Serial.printf("  Samples produced: %lu\n", (unsigned long)stats.samplesProduced);
+    Serial.printf("  Samples stored:   %lu (drops: %lu)\n",
+                  (unsigned long)stats.samplesStored, (unsigned long)stats.storageDrops);
+    Serial.printf("  Samples uploaded: %lu (drops: %lu)\n",
+                  (unsigned long)stats.samplesUploaded, (unsigned long)stats.uploadDrops);
+    Serial.printf("  Storage ring: %u/%u\n", (unsigned)storageRing.size(), (unsigned)storageRing.capacity());
+    Serial.printf("  Upload ring:  %u/%u\n", (unsigned)uploadRing.size(), (unsigned)uploadRing.capacity());
+}
@@ -0,0 +1,58 @@
+#ifndef TASK_PIPELINE_H
+#define TASK_PIPELINE_H
+
+#include <Arduino.h>
+#include "../include/config.h"
+#include "../VatSensor/vat_sensor_data.h"
+
+// =======================================================
+//   TASK PIPELINE
+//   Akuisisi (core PIPELINE_ACQ_CORE, prioritas tinggi) -> SampleRing SPSC
+//   -> task storage & task network (core PIPELINE_IO_CORE).
+//   Upload yang lambat tidak pernah menghentikan pembacaan sensor.
+// =======================================================
+
+// Callback tahap pipeline - diisi oleh main_gsm.cpp / main_wifi.cpp
+typedef void (*SampleCallback)(const VatSensorData& sample);
+typedef size_t (*UploadBatchCallback)(const VatSensorData* samples, size_t count);
+
+struct PipelineConfig {
+    unsigned long sampleIntervalMs;  // Interval pembuatan sampel
+    unsigned long uploadIntervalMs;  // Interval upload oleh task network
+    SampleCallback onSample;         // Dipanggil di task akuisisi (LED, dsb), boleh NULL
+    SampleCallback store;            // Dipanggil di task storage (SD Card), boleh NULL
+    UploadBatchCallback upload;      // Dipanggil di task network, return jumlah sampel yang selesai diproses
+                                     // (sisanya tetap di ring untuk siklus berikutnya)
+};
+
+struct PipelineStats {
+    uint32_t samplesProduced;
+    uint32_t samplesStored;
+    uint32_t samplesUploaded;
+    uint32_t storageDrops;           // Overflow ring storage
+    uint32_t uploadDrops;            // Overflow ring upload
+};
+
+/**
+ * @brief Membuat task akuisisi, storage dan network
+ * @param config Interval dan callback masing-masing tahap
+ * @return true jika semua task berhasil dibuat
+ */
+bool start_task_pipeline(const PipelineConfig& config);
+
+/**
+ * @brief Salinan sampel terakhir dari task akuisisi (aman dipanggil dari task lain)
+ * @param sample Diisi dengan sampel terakhir
+ * @return false jika belum ada sampel
+ */
+bool get_latest_sample(VatSensorData& sample);
+
+/**
+ * @brief Bangunkan task network untuk upload segera (tanpa menunggu interval)
+ */
+void request_pipeline_upload();
+
+PipelineStats get_pipeline_stats();
+void print_pipeline_stats();
+
+#endif // TASK_PIPELINE_H
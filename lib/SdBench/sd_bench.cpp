@@ -0,0 +1,279 @@
+#include "sd_bench.h"
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+
+static const char* PATTERN_NAMES[BENCH_PATTERN_COUNT] = {
+    "csv_open_close", "queue_open_close", "binary_block", "buffered_append", "preallocated"
+};
+
+static const char* PATTERN_PATHS[BENCH_PATTERN_COUNT] = {
+    "/bench_daily.csv", NULL, "/bench_log.bin", "/bench_buffered.bin", "/bench_prealloc.bin"
+};
+
+#define BENCH_BINARY_RECORD_SIZE 28     // sizeof(BinaryLogRecord)
+#define BENCH_BLOCK_HEADER_SIZE 8       // sizeof(BinaryLogBlockHeader)
+#define BENCH_RECORDS_PER_BLOCK \
+    ((SD_BENCH_BLOCK_SIZE - 4 - BENCH_BLOCK_HEADER_SIZE) / BENCH_BINARY_RECORD_SIZE)
+
+static uint32_t samples[SD_BENCH_MAX_SAMPLES];
+static uint8_t block[SD_BENCH_BLOCK_SIZE];
+static uint8_t buffer[SD_BENCH_BUFFER_SIZE];
+
+struct BenchState {
+    uint32_t blockSequence;     // Blok yang sedang diisi (pola biner)
+    uint8_t blockCount;         // Record di blok tersebut
+    uint8_t flushedCount;       // Record yang sudah ada di kartu
+    size_t used;                // Isi buffer (BENCH_BUFFERED_APPEND)
+    uint32_t lastFlushUs;
+    uint32_t segment;           // Segmen queue (BENCH_QUEUE_OPEN_CLOSE)
+    uint32_t segmentSize;
+};
+
+// =======================================================
+//   PAYLOAD (ukuran sama dengan data production)
+// =======================================================
+
+static size_t formatCsvRecord(uint32_t index, char* out, size_t size) {
+    // Sama dengan baris writeToDailyLog (CSV) + "\r\n" dari println()
+    return snprintf(out, size, "2025-01-15 %02lu:%02lu:%02lu,%s,%.1f,%.1f,%.6f,%.6f,%.2f,%u,%.2f\r\n",
+                    (unsigned long)(index / 3600 % 24), (unsigned long)(index / 60 % 60),
+                    (unsigned long)(index % 60), DEVICE_ID, 120.0f + index % 50, 118.5f + index % 40,
+                    -6.2 + index * 1e-6, 106.8 + index * 1e-6, 1.5f + (index % 30) / 100.0f,
+                    (unsigned)(7 + index % 5), 0.9f + (index % 10) / 10.0f);
+}
+
+static size_t formatJsonRecord(uint32_t index, char* out, size_t size) {
+    // Kira-kira panjang payload buildSensorJson() yang masuk offline queue
+    return snprintf(out, size,
+                    "{\"type\":\"sensor\",\"deviceId\":\"%s\",\"gps\":{\"lat\":%.6f,\"lon\":%.6f,\"alt\":0,"
+                    "\"sog\":0,\"cog\":0},\"ultrasonic\":{\"dist1\":%.1f,\"dist2\":%.1f},"
+                    "\"timestamp\":\"2025-01-15T%02lu:%02lu:%02lu+07:00\"}",
+                    DEVICE_ID, -6.2 + index * 1e-6, 106.8 + index * 1e-6, 120.0f + index % 50,
+                    118.5f + index % 40, (unsigned long)(index / 3600 % 24),
+                    (unsigned long)(index / 60 % 60), (unsigned long)(index % 60));
+}
+
+static void formatBinaryRecord(uint32_t index, uint8_t* out) {
+    for (size_t i = 0; i < BENCH_BINARY_RECORD_SIZE; i++) {
+        out[i] = (uint8_t)(index >> (8 * (i % 4))) ^ (uint8_t)i;
+    }
+}
+
+static void resetBlock(uint32_t sequence) {
+    memset(block, 0, sizeof(block));
+    block[0] = 'V';
+    block[1] = 'L';
+    block[2] = 1;
+    memcpy(block + 4, &sequence, sizeof(sequence));
+}
+
+// =======================================================
+//   POLA TULIS
+// =======================================================
+
+static bool writeBlock(BenchIo& io, BenchState& state) {
+    block[3] = state.blockCount;
+    state.flushedCount = state.blockCount;
+    return io.seek(state.blockSequence * SD_BENCH_BLOCK_SIZE) &&
+           io.write(block, SD_BENCH_BLOCK_SIZE) == SD_BENCH_BLOCK_SIZE;
+}
+
+// Sama dengan BinaryLogWriter::append(): tulis saat blok penuh atau interval flush lewat
+static bool appendBlockRecord(BenchIo& io, BenchState& state, uint32_t index) {
+    formatBinaryRecord(index, block + BENCH_BLOCK_HEADER_SIZE + state.blockCount * BENCH_BINARY_RECORD_SIZE);
+    state.blockCount++;
+
+    bool ok = true;
+    if (state.blockCount == BENCH_RECORDS_PER_BLOCK) {
+        ok = writeBlock(io, state);
+        state.blockSequence++;
+        state.blockCount = 0;
+        state.flushedCount = 0;
+        resetBlock(state.blockSequence);
+    }
+
+    if (io.micros() - state.lastFlushUs >= DAILY_LOG_FLUSH_INTERVAL * 1000UL) {
+        if (state.blockCount > state.flushedCount) ok &= writeBlock(io, state);
+        io.flush();
+        state.lastFlushUs = io.micros();
+    }
+    return ok;
+}
+
+static bool appendBufferedRecord(BenchIo& io, BenchState& state, uint32_t index) {
+    formatBinaryRecord(index, buffer + state.used);
+    state.used += BENCH_BINARY_RECORD_SIZE;
+
+    bool ok = true;
+    if (state.used + BENCH_BINARY_RECORD_SIZE > sizeof(buffer)) {
+        ok = io.write(buffer, state.used) == state.used;
+        state.used = 0;
+    }
+
+    if (io.micros() - state.lastFlushUs >= DAILY_LOG_FLUSH_INTERVAL * 1000UL) {
+        if (state.used > 0) ok &= io.write(buffer, state.used) == state.used;
+        state.used = 0;
+        io.flush();
+        state.lastFlushUs = io.micros();
+    }
+    return ok;
+}
+
+static void queueSegmentPath(uint32_t segment, char* out, size_t size) {
+    snprintf(out, size, "/bench_q%06lu.txt", (unsigned long)segment);
+}
+
+// @return Byte payload yang di-append, 0 jika gagal
+static size_t appendRecord(BenchIo& io, BenchPattern pattern, BenchState& state, uint32_t index) {
+    char line[QUEUE_RECORD_MAX_SIZE + 2];
+    size_t length;
+
+    switch (pattern) {
+    case BENCH_CSV_OPEN_CLOSE: {
+        length = formatCsvRecord(index, line, sizeof(line));
+        if (!io.open(PATTERN_PATHS[pattern], BENCH_OPEN_APPEND)) return 0;
+        size_t written = io.write((const uint8_t*)line, length);
+        io.close();
+        return written == length ? length : 0;
+    }
+
+    case BENCH_QUEUE_OPEN_CLOSE: {
+        length = formatJsonRecord(index, line, sizeof(line));
+        line[length++] = '\n';
+        if (state.segmentSize > 0 && state.segmentSize + length > QUEUE_SEGMENT_MAX_BYTES) {
+            state.segment++;
+            state.segmentSize = 0;
+        }
+        char path[32];
+        queueSegmentPath(state.segment, path, sizeof(path));
+        if (!io.open(path, BENCH_OPEN_APPEND)) return 0;
+        size_t written = io.write((const uint8_t*)line, length);
+        io.close();
+        state.segmentSize += written;
+        return written == length ? length : 0;
+    }
+
+    case BENCH_BINARY_BLOCK:
+    case BENCH_PREALLOCATED:
+        return appendBlockRecord(io, state, index) ? BENCH_BINARY_RECORD_SIZE : 0;
+
+    case BENCH_BUFFERED_APPEND:
+        return appendBufferedRecord(io, state, index) ? BENCH_BINARY_RECORD_SIZE : 0;
+
+    default:
+        return 0;
+    }
+}
+
+// File yang tetap terbuka selama run - dibuat sebelum pengukuran dimulai
+static bool prepareFile(BenchIo& io, BenchPattern pattern, uint32_t records) {
+    const char* path = PATTERN_PATHS[pattern];
+    if (!io.open(path, BENCH_OPEN_CREATE)) return false;
+
+    if (pattern == BENCH_PREALLOCATED) {
+        // Alokasikan semua cluster sekarang agar append tidak pernah memperbesar file
+        uint32_t size = (records / BENCH_RECORDS_PER_BLOCK + 1) * SD_BENCH_BLOCK_SIZE;
+        memset(buffer, 0, sizeof(buffer));
+        while (size > 0) {
+            size_t chunk = size < sizeof(buffer) ? size : sizeof(buffer);
+            if (io.write(buffer, chunk) != chunk) {
+                io.close();
+                return false;
+            }
+            size -= chunk;
+        }
+    }
+
+    if (pattern == BENCH_BUFFERED_APPEND) return true;
+
+    // Sama dengan BinaryLogWriter::open(): buat file lalu buka ulang "r+"
+    io.close();
+    return io.open(path, BENCH_OPEN_UPDATE);
+}
+
+static void removeFiles(BenchIo& io, BenchPattern pattern, const BenchState& state) {
+    if (pattern != BENCH_QUEUE_OPEN_CLOSE) {
+        io.remove(PATTERN_PATHS[pattern]);
+        return;
+    }
+    for (uint32_t segment = 1; segment <= state.segment; segment++) {
+        char path[32];
+        queueSegmentPath(segment, path, sizeof(path));
+        io.remove(path);
+    }
+}
+
+// =======================================================
+//   PUBLIC API
+// =======================================================
+
+bool runBench(BenchIo& io, BenchPattern pattern, uint16_t rateHz, uint32_t records, BenchResult& result) {
+    memset(&result, 0, sizeof(result));
+    result.pattern = pattern;
+    result.rateHz = rateHz;
+    result.spiHz = io.clockHz();
+    if (pattern >= BENCH_PATTERN_COUNT || rateHz == 0) return false;
+    if (records > SD_BENCH_MAX_SAMPLES) records = SD_BENCH_MAX_SAMPLES;
+
+    BenchState state;
+    memset(&state, 0, sizeof(state));
+    state.segment = 1;
+    resetBlock(0);
+
+    removeFiles(io, pattern, state);
+    bool keepOpen = pattern == BENCH_BINARY_BLOCK || pattern == BENCH_BUFFERED_APPEND ||
+                    pattern == BENCH_PREALLOCATED;
+    if (keepOpen && !prepareFile(io, pattern, records)) return false;
+
+    uint32_t intervalUs = 1000000UL / rateHz;
+    uint32_t start = io.micros();
+    state.lastFlushUs = start;
+    uint64_t total = 0;
+
+    for (uint32_t i = 0; i < records; i++) {
+        io.waitUntil(start + i * intervalUs);
+
+        uint32_t begin = io.micros();
+        size_t bytes = appendRecord(io, pattern, state, i);
+        uint32_t latency = io.micros() - begin;
+
+        samples[i] = latency;
+        total += latency;
+        result.bytes += bytes;
+        if (bytes == 0) result.errors++;
+    }
+
+    if (keepOpen) {
+        if (pattern == BENCH_BUFFERED_APPEND && state.used > 0) io.write(buffer, state.used);
+        if (pattern != BENCH_BUFFERED_APPEND && state.blockCount > state.flushedCount) writeBlock(io, state);
+        io.close();
+    }
+    removeFiles(io, pattern, state);
+
+    std::sort(samples, samples + records);
+    result.records = records;
+    if (records > 0) {
+        result.p50Us = samples[(records - 1) * 50 / 100];
+        result.p99Us = samples[(records - 1) * 99 / 100];
+        result.maxUs = samples[records - 1];
+        result.meanUs = (uint32_t)(total / records);
+    }
+    result.elapsedUs = (uint32_t)total;
+    return true;
+}
+
+size_t formatBenchResult(const BenchResult& result, const char* target, char* out, size_t size) {
+    float kbPerSecond = result.elapsedUs > 0 ? result.bytes * 1000000.0f / 1024.0f / result.elapsedUs : 0.0f;
+    int length = snprintf(out, size, "BENCH,%s,%s,%lu,%u,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%.1f",
+                          target, getBenchPatternName(result.pattern), (unsigned long)(result.spiHz / 1000),
+                          (unsigned)result.rateHz, (unsigned long)result.records,
+                          (unsigned long)result.errors, (unsigned long)result.p50Us,
+                          (unsigned long)result.p99Us, (unsigned long)result.maxUs,
+                          (unsigned long)result.meanUs, (unsigned long)result.bytes, kbPerSecond);
+    return length > 0 ? (size_t)length : 0;
+}
+
+const char* getBenchPatternName(uint8_t pattern) {
+    return pattern < BENCH_PATTERN_COUNT ? PATTERN_NAMES[pattern] : "unknown";
+}
@@ -0,0 +1,94 @@
+#ifndef SD_BENCH_H
+#define SD_BENCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../../include/config.h"
+
+// =======================================================
+//   SD BENCHMARK
+//   Mengukur latency append per record untuk pola tulis firmware
+//   (writeToDailyLog CSV/biner, SegmentedQueue::enqueue) dan alternatifnya.
+//   Inti benchmark tidak bergantung Arduino: semua I/O lewat BenchIo, sehingga
+//   pola yang sama dijalankan di ESP32 (env:sdbench, SD library asli) dan di
+//   host (env:sdbench-native, SimBlockDevice).
+//
+//   Output satu baris CSV per run (lihat SD_BENCH_CSV_HEADER), awalan "BENCH,"
+//   agar mudah di-grep dari log serial.
+// =======================================================
+
+#define SD_BENCH_CSV_HEADER \
+    "#BENCH,target,pattern,spi_khz,rate_hz,records,errors,p50_us,p99_us,max_us,mean_us,bytes,kb_per_s"
+#define SD_BENCH_LINE_SIZE 192          // Buffer untuk formatBenchResult
+#define SD_BENCH_BLOCK_SIZE 512         // Sama dengan BINARY_LOG_BLOCK_SIZE
+#define SD_BENCH_BUFFER_SIZE 4096       // Buffer pola BENCH_BUFFERED_APPEND
+
+enum BenchPattern {
+    BENCH_CSV_OPEN_CLOSE = 0,   // writeToDailyLog (CSV): open FILE_APPEND, println, close per sampel
+    BENCH_QUEUE_OPEN_CLOSE,     // addToOfflineQueue: open FILE_APPEND, record + '\n', close per record
+    BENCH_BINARY_BLOCK,         // writeToDailyLog (biner): file terbuka, blok 512 ditulis ulang, flush berkala
+    BENCH_BUFFERED_APPEND,      // Alternatif: file terbuka, buffer SD_BENCH_BUFFER_SIZE, flush berkala
+    BENCH_PREALLOCATED,         // Alternatif: file dialokasikan penuh di awal, blok 512 ditulis di tempat
+    BENCH_PATTERN_COUNT
+};
+
+enum BenchOpenMode {
+    BENCH_OPEN_APPEND = 0,      // FILE_APPEND
+    BENCH_OPEN_CREATE,          // FILE_WRITE (file dikosongkan)
+    BENCH_OPEN_UPDATE           // "r+" (tulis di tempat, ukuran tetap)
+};
+
+/**
+ * @brief Satu file terbuka + jam untuk benchmark
+ *
+ * Implementasi ESP32 memakai SD/File dan micros(); implementasi host
+ * (SimBlockDevice) memakai jam simulasi yang maju sesuai biaya I/O.
+ */
+class BenchIo {
+public:
+    virtual ~BenchIo() {}
+    virtual const char* name() const = 0;
+    virtual uint32_t clockHz() const = 0;
+    virtual bool open(const char* path, BenchOpenMode mode) = 0;
+    virtual size_t write(const uint8_t* data, size_t length) = 0;
+    virtual bool seek(uint32_t position) = 0;
+    virtual void flush() = 0;
+    virtual void close() = 0;
+    virtual void remove(const char* path) = 0;
+    virtual uint32_t micros() = 0;
+    virtual void waitUntil(uint32_t micros) = 0;  // Pacing record rate (kartu idle)
+};
+
+struct BenchResult {
+    uint8_t pattern;            // BenchPattern
+    uint16_t rateHz;
+    uint32_t spiHz;
+    uint32_t records;
+    uint32_t errors;            // Write pendek / open gagal
+    uint32_t p50Us;
+    uint32_t p99Us;
+    uint32_t maxUs;
+    uint32_t meanUs;
+    uint32_t bytes;             // Payload yang di-append
+    uint32_t elapsedUs;         // Total waktu I/O (tanpa jeda pacing)
+};
+
+/**
+ * @brief Jalankan satu pola pada satu record rate
+ *
+ * Setiap record dijadwalkan pada start + i / rateHz; yang diukur hanya waktu
+ * operasi append (termasuk open/close/flush yang dipicu record tersebut).
+ * Persiapan file (hapus, prealokasi) tidak diukur.
+ * @param records Jumlah record (dibatasi SD_BENCH_MAX_SAMPLES)
+ * @return false jika file benchmark tidak bisa dibuat
+ */
+bool runBench(BenchIo& io, BenchPattern pattern, uint16_t rateHz, uint32_t records, BenchResult& result);
+
+/**
+ * @brief Format hasil sebagai satu baris CSV (kolom SD_BENCH_CSV_HEADER, tanpa newline)
+ */
+size_t formatBenchResult(const BenchResult& result, const char* target, char* out, size_t size);
+
+const char* getBenchPatternName(uint8_t pattern);
+
+#endif // SD_BENCH_H
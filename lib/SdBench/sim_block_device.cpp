@@ -0,0 +1,227 @@
+#include "sim_block_device.h"
+#include <string.h>
+
+const SimCardProfile SIM_CARD_BUDGET = {"sim-budget", 40, 300, 900, 256, 250000, 4096};
+const SimCardProfile SIM_CARD_INDUSTRIAL = {"sim-industrial", 30, 150, 250, 2048, 25000, 32768};
+
+#define SIM_TRANSFER_OVERHEAD_BYTES 10  // Start token, CRC16, data response, dummy byte
+#define SIM_GC_IDLE_MIN_US 10000        // Idle lebih pendek tidak dipakai kartu untuk GC
+
+SimBlockDevice::SimBlockDevice(const SimCardProfile& profile, uint32_t spiHz) {
+    this->profile = profile;
+    this->spiHz = spiHz;
+    now = 0;
+    random = 0x12345678;
+    gcDebtUs = 0;
+    sectorsSinceGc = 0;
+    nextGcSectors = profile.gcSectors;
+    sectorWrites = 0;
+    memset(files, 0, sizeof(files));
+    openFile = -1;
+    position = 0;
+    cacheSector = -1;
+    cacheDirty = false;
+    modified = false;
+    fatDirty = false;
+}
+
+// =======================================================
+//   BIAYA KARTU
+// =======================================================
+
+void SimBlockDevice::advance(uint32_t us) {
+    now += us;
+}
+
+uint32_t SimBlockDevice::transferUs(uint32_t bytes) const {
+    return (uint32_t)((uint64_t)bytes * 8 * 1000000 / spiHz) + profile.commandUs;
+}
+
+void SimBlockDevice::readSector() {
+    advance(transferUs(SIM_SECTOR_SIZE + SIM_TRANSFER_OVERHEAD_BYTES) + profile.readBusyUs);
+}
+
+// Multi-block write (CMD25) untuk sektor berurutan
+void SimBlockDevice::writeSectors(uint32_t count) {
+    advance(profile.commandUs);
+    for (uint32_t i = 0; i < count; i++) {
+        advance(transferUs(SIM_SECTOR_SIZE + SIM_TRANSFER_OVERHEAD_BYTES) - profile.commandUs + profile.programUs);
+        sectorWrites++;
+
+        // Setiap sektor menambah pekerjaan GC; ditagih sekaligus saat kartu kehabisan blok kosong
+        gcDebtUs += profile.gcStallUs / profile.gcSectors;
+        if (++sectorsSinceGc >= nextGcSectors) {
+            advance(gcDebtUs);
+            gcDebtUs = 0;
+            sectorsSinceGc = 0;
+            random = random * 1103515245 + 12345;
+            nextGcSectors = profile.gcSectors * 3 / 4 + (random >> 16) % (profile.gcSectors / 2 + 1);
+        }
+    }
+}
+
+// FatFs menyimpan satu sektor FAT di window - hanya sektor FAT yang berbeda dibaca
+void SimBlockDevice::readFatChain(uint32_t fromCluster, uint32_t toCluster) {
+    uint32_t first = fromCluster / SIM_FAT_ENTRIES_PER_SECTOR;
+    uint32_t last = toCluster / SIM_FAT_ENTRIES_PER_SECTOR;
+    for (uint32_t sector = first; sector < last; sector++) {
+        readSector();
+    }
+}
+
+void SimBlockDevice::waitUntil(uint32_t micros) {
+    int32_t idle = (int32_t)(micros - (uint32_t)now);
+    if (idle <= 0) return;
+    now += idle;
+
+    // Kartu memakai sebagian waktu idle yang cukup panjang untuk GC di background
+    if (idle < SIM_GC_IDLE_MIN_US) return;
+    uint32_t background = (uint32_t)idle / 4;
+    gcDebtUs = gcDebtUs > background ? gcDebtUs - background : 0;
+}
+
+// =======================================================
+//   FILE SYSTEM
+// =======================================================
+
+int SimBlockDevice::findFile(const char* path) const {
+    for (int i = 0; i < SIM_MAX_FILES; i++) {
+        if (files[i].used && strcmp(files[i].path, path) == 0) return i;
+    }
+    return -1;
+}
+
+bool SimBlockDevice::open(const char* path, BenchOpenMode mode) {
+    if (openFile >= 0) close();
+
+    readSector();  // Cari entri di direktori
+    int index = findFile(path);
+    if (index < 0) {
+        if (mode == BENCH_OPEN_UPDATE) return false;
+        for (int i = 0; i < SIM_MAX_FILES && index < 0; i++) {
+            if (!files[i].used) index = i;
+        }
+        if (index < 0 || strlen(path) >= sizeof(files[index].path)) return false;
+        memset(&files[index], 0, sizeof(SimFile));
+        strcpy(files[index].path, path);
+        files[index].used = true;
+        writeSectors(1);  // Entri direktori baru
+    } else if (mode == BENCH_OPEN_CREATE && files[index].clusters > 0) {
+        // Truncate: rantai cluster dibebaskan di kedua salinan FAT
+        uint32_t fatSectors = (files[index].clusters - 1) / SIM_FAT_ENTRIES_PER_SECTOR + 1;
+        writeSectors(2 * fatSectors);
+        writeSectors(1);
+        files[index].size = 0;
+        files[index].clusters = 0;
+    }
+
+    openFile = index;
+    position = 0;
+    cacheSector = -1;
+    cacheDirty = false;
+    modified = false;
+    fatDirty = false;
+
+    if (mode == BENCH_OPEN_APPEND && files[index].size > 0) {
+        // FA_OPEN_APPEND = lseek ke akhir file lewat rantai FAT
+        readFatChain(0, files[index].clusters - 1 + SIM_FAT_ENTRIES_PER_SECTOR);
+        position = files[index].size;
+    }
+    return true;
+}
+
+size_t SimBlockDevice::write(const uint8_t* data, size_t length) {
+    (void)data;
+    if (openFile < 0) return 0;
+    SimFile& file = files[openFile];
+
+    size_t remaining = length;
+    while (remaining > 0) {
+        uint32_t cluster = position / profile.clusterBytes;
+        if (cluster >= file.clusters) {
+            file.clusters = cluster + 1;
+            fatDirty = true;
+        }
+
+        uint32_t sector = position / SIM_SECTOR_SIZE;
+        uint32_t offset = position % SIM_SECTOR_SIZE;
+        size_t count;
+
+        if (offset == 0 && remaining >= SIM_SECTOR_SIZE) {
+            // Sektor penuh ditulis langsung (tanpa cache), maksimal sampai batas cluster
+            uint32_t clusterEnd = (cluster + 1) * profile.clusterBytes;
+            uint32_t sectors = remaining / SIM_SECTOR_SIZE;
+            if (sectors > (clusterEnd - position) / SIM_SECTOR_SIZE) sectors = (clusterEnd - position) / SIM_SECTOR_SIZE;
+            if (cacheSector >= (int32_t)sector && cacheSector < (int32_t)(sector + sectors)) {
+                cacheSector = -1;
+                cacheDirty = false;
+            }
+            writeSectors(sectors);
+            count = sectors * SIM_SECTOR_SIZE;
+        } else {
+            if (cacheSector != (int32_t)sector) {
+                if (cacheDirty) writeSectors(1);
+                if (position < file.size) readSector();  // Read-modify-write
+                cacheSector = sector;
+            }
+            count = SIM_SECTOR_SIZE - offset;
+            if (count > remaining) count = remaining;
+            cacheDirty = true;
+        }
+
+        position += count;
+        remaining -= count;
+        if (position > file.size) file.size = position;
+    }
+    modified = true;
+    return length;
+}
+
+bool SimBlockDevice::seek(uint32_t target) {
+    if (openFile < 0 || target > files[openFile].size) return false;
+
+    // Tanpa fast seek, FatFs jalan dari awal rantai jika mundur ke cluster sebelumnya
+    uint32_t current = position > 0 ? (position - 1) / profile.clusterBytes : 0;
+    uint32_t next = target > 0 ? (target - 1) / profile.clusterBytes : 0;
+    if (next < current) {
+        readFatChain(0, next + SIM_FAT_ENTRIES_PER_SECTOR);
+    } else {
+        readFatChain(current, next);
+    }
+    position = target;
+    return true;
+}
+
+void SimBlockDevice::flush() {
+    if (openFile < 0) return;
+    if (cacheDirty) {
+        writeSectors(1);
+        cacheDirty = false;
+    }
+    if (fatDirty) {
+        writeSectors(2);  // FAT1 + FAT2
+        fatDirty = false;
+    }
+    if (modified) {
+        readSector();
+        writeSectors(1);  // Ukuran + waktu modifikasi di entri direktori
+        modified = false;
+    }
+}
+
+void SimBlockDevice::close() {
+    flush();
+    openFile = -1;
+}
+
+void SimBlockDevice::remove(const char* path) {
+    if (openFile >= 0 && strcmp(files[openFile].path, path) == 0) close();
+    int index = findFile(path);
+    if (index < 0) return;
+    readSector();
+    if (files[index].clusters > 0) {
+        writeSectors(2 * ((files[index].clusters - 1) / SIM_FAT_ENTRIES_PER_SECTOR + 1));
+    }
+    writeSectors(1);
+    files[index].used = false;
+}
@@ -0,0 +1,90 @@
+#ifndef SIM_BLOCK_DEVICE_H
+#define SIM_BLOCK_DEVICE_H
+
+#include "sd_bench.h"
+
+// =======================================================
+//   SIMULATED SD CARD (host)
+//   Model biaya FAT32 di atas kartu SD mode SPI, cukup untuk membandingkan pola:
+//   - transfer sektor = (512 + overhead) x 8 / clock SPI, plus busy baca/program kartu
+//   - open: baca sektor direktori + jalan rantai FAT (FILE_APPEND seek ke akhir)
+//   - tulis parsial lewat cache 1 sektor per file (read-modify-write seperti FatFs)
+//   - sync/close: sektor kotor + entri direktori + 2 salinan FAT jika ada cluster baru
+//   - garbage collection internal kartu: stall periodik yang sebagian
+//     dikerjakan di background saat kartu idle (record rate rendah)
+//   Data file tidak disimpan - hanya ukuran dan biaya waktunya.
+// =======================================================
+
+#define SIM_MAX_FILES 16
+#define SIM_SECTOR_SIZE 512
+#define SIM_FAT_ENTRIES_PER_SECTOR 128   // FAT32: 4 byte per cluster
+
+struct SimCardProfile {
+    const char* name;
+    uint32_t commandUs;         // CMD + response + token per transfer
+    uint32_t readBusyUs;        // Akses baca internal per sektor
+    uint32_t programUs;         // Busy setelah menulis satu sektor
+    uint32_t gcSectors;         // Rata-rata sektor tertulis per garbage collection
+    uint32_t gcStallUs;         // Durasi GC jika tidak dicicil saat idle
+    uint32_t clusterBytes;
+};
+
+// Profil contoh: kartu murah (cluster 4 KB, GC sering & lama) dan kartu industrial
+extern const SimCardProfile SIM_CARD_BUDGET;
+extern const SimCardProfile SIM_CARD_INDUSTRIAL;
+
+class SimBlockDevice : public BenchIo {
+public:
+    SimBlockDevice(const SimCardProfile& profile, uint32_t spiHz);
+
+    const char* name() const override { return profile.name; }
+    uint32_t clockHz() const override { return spiHz; }
+    bool open(const char* path, BenchOpenMode mode) override;
+    size_t write(const uint8_t* data, size_t length) override;
+    bool seek(uint32_t position) override;
+    void flush() override;
+    void close() override;
+    void remove(const char* path) override;
+    uint32_t micros() override { return (uint32_t)now; }
+    void waitUntil(uint32_t micros) override;
+
+    uint32_t getSectorWrites() const { return sectorWrites; }
+
+private:
+    struct SimFile {
+        char path[32];
+        uint32_t size;
+        uint32_t clusters;
+        bool used;
+    };
+
+    void advance(uint32_t us);
+    uint32_t transferUs(uint32_t bytes) const;
+    void readSector();
+    void writeSectors(uint32_t count);
+    void readFatChain(uint32_t fromCluster, uint32_t toCluster);
+    int findFile(const char* path) const;
+
+    SimCardProfile profile;
+    uint32_t spiHz;
+    uint64_t now;
+    uint32_t random;
+
+    // Garbage collection internal kartu
+    uint32_t gcDebtUs;
+    uint32_t sectorsSinceGc;
+    uint32_t nextGcSectors;
+    uint32_t sectorWrites;
+
+    SimFile files[SIM_MAX_FILES];
+
+    // Satu file terbuka
+    int openFile;
+    uint32_t position;
+    int32_t cacheSector;        // Sektor (relatif file) di cache, -1 = kosong
+    bool cacheDirty;
+    bool modified;              // Entri direktori perlu ditulis saat sync
+    bool fatDirty;              // Cluster baru belum ditulis ke FAT
+};
+
+#endif // SIM_BLOCK_DEVICE_H
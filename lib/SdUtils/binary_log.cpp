@@ -0,0 +1,281 @@
+#include "binary_log.h"
+#include <math.h>
+#include <string.h>
+#include "crc32.h"
+#include "sd_utils.h"
+#include "../Telemetry/telemetry_delta.h"
+#include "../Telemetry/telemetry_json.h"
+
+// =======================================================
+//   RECORD & BLOCK
+// =======================================================
+
+void toBinaryLogRecord(const VatSensorData& data, BinaryLogRecord& record) {
+    FixedSample fixed;
+    to_fixed_sample(data, DELTA_MISSING_TIME, fixed);
+
+    record.timestamp = fixed.timestamp;
+    record.latitudeE7 = fixed.latitudeE7;
+    record.longitudeE7 = fixed.longitudeE7;
+    record.capturedAtMs = data.capturedAtMs;
+    record.distance1Mm = fixed.distance1Mm;
+    record.distance2Mm = fixed.distance2Mm;
+    record.depthMm = fixed.depthMm;
+    record.hdopX100 = (isnan(data.hdop) || data.hdop < 0 || data.hdop >= 655.35f)
+                      ? 0xFFFF : (uint16_t)lroundf(data.hdop * 100.0f);
+    record.satellites = data.satellites;
+    record.flags = data.isValid ? BINARY_LOG_FLAG_TIME_VALID : 0;
+    record.reserved = 0;
+}
+
+bool isBinaryLogBlockValid(const uint8_t* block) {
+    BinaryLogBlockHeader header;
+    memcpy(&header, block, sizeof(header));
+    if (header.magic[0] != BINARY_LOG_MAGIC0 || header.magic[1] != BINARY_LOG_MAGIC1) return false;
+    if (header.version != BINARY_LOG_VERSION) return false;
+    if (header.count == 0 || header.count > BINARY_LOG_RECORDS_PER_BLOCK) return false;
+
+    uint32_t stored;
+    memcpy(&stored, block + BINARY_LOG_CRC_OFFSET, sizeof(stored));
+    return crc32Compute(block, BINARY_LOG_CRC_OFFSET) == stored;
+}
+
+// Kosongkan buffer dan isi header untuk blok baru
+static void resetBlock(uint8_t* block, uint32_t sequence) {
+    memset(block, 0, BINARY_LOG_BLOCK_SIZE);
+    BinaryLogBlockHeader header = {{BINARY_LOG_MAGIC0, BINARY_LOG_MAGIC1}, BINARY_LOG_VERSION, 0, sequence};
+    memcpy(block, &header, sizeof(header));
+}
+
+// =======================================================
+//   WRITER
+// =======================================================
+
+BinaryLogWriter::BinaryLogWriter(unsigned long flushIntervalMs) {
+    this->flushIntervalMs = flushIntervalMs;
+    fileOpen = false;
+    fileYear = 0;
+    fileMonth = 0;
+    fileDay = 0;
+    blockSequence = 0;
+    blockCount = 0;
+    flushedCount = 0;
+    lastFlushMs = 0;
+    blocksWritten = 0;
+    writeErrors = 0;
+    resetBlock(block, 0);
+}
+
+bool BinaryLogWriter::open(uint16_t year, uint8_t month, uint8_t day) {
+    close();
+
+    String path = generateLogFileName(year, month, day, BINARY_LOG_EXTENSION);
+
+    // "r+" agar blok parsial bisa ditimpa di tempat (FILE_APPEND selalu menulis di akhir)
+    if (!SD.exists(path.c_str())) {
+        File created = SD.open(path.c_str(), FILE_WRITE);
+        if (!created) {
+            Serial.print("❌ Failed to create binary log: ");
+            Serial.println(path);
+            return false;
+        }
+        created.close();
+    }
+
+    file = SD.open(path.c_str(), "r+");
+    if (!file) {
+        Serial.print("❌ Failed to open binary log: ");
+        Serial.println(path);
+        return false;
+    }
+
+    // Lanjutkan dari blok terakhir; blok parsial yang valid diisi lagi setelah reboot
+    size_t size = file.size();
+    blockSequence = (size + BINARY_LOG_BLOCK_SIZE - 1) / BINARY_LOG_BLOCK_SIZE;
+    blockCount = 0;
+    resetBlock(block, blockSequence);
+
+    if (blockSequence > 0 && size % BINARY_LOG_BLOCK_SIZE == 0) {
+        uint8_t* last = block;
+        file.seek((blockSequence - 1) * BINARY_LOG_BLOCK_SIZE);
+        if (file.read(last, BINARY_LOG_BLOCK_SIZE) == BINARY_LOG_BLOCK_SIZE &&
+            isBinaryLogBlockValid(last) && last[3] < BINARY_LOG_RECORDS_PER_BLOCK) {
+            blockSequence--;
+            blockCount = last[3];
+        } else {
+            resetBlock(block, blockSequence);
+        }
+    }
+
+    flushedCount = blockCount;
+    fileOpen = true;
+    fileYear = year;
+    fileMonth = month;
+    fileDay = day;
+    lastFlushMs = millis();
+
+    Serial.print("📂 Binary daily log: ");
+    Serial.print(path);
+    Serial.print(" (block ");
+    Serial.print(blockSequence);
+    Serial.println(")");
+    return true;
+}
+
+bool BinaryLogWriter::writeBlock() {
+    block[3] = blockCount;
+    uint32_t crc = crc32Compute(block, BINARY_LOG_CRC_OFFSET);
+    memcpy(block + BINARY_LOG_CRC_OFFSET, &crc, sizeof(crc));
+
+    if (!file.seek(blockSequence * BINARY_LOG_BLOCK_SIZE) ||
+        file.write(block, BINARY_LOG_BLOCK_SIZE) != BINARY_LOG_BLOCK_SIZE) {
+        writeErrors++;
+        return false;
+    }
+    flushedCount = blockCount;
+    return true;
+}
+
+bool BinaryLogWriter::append(const VatSensorData& data) {
+    if (!data.isValid) return true;
+
+    if (!fileOpen || data.year != fileYear || data.month != fileMonth || data.day != fileDay) {
+        if (!open(data.year, data.month, data.day)) return false;
+    }
+
+    BinaryLogRecord record;
+    toBinaryLogRecord(data, record);
+    memcpy(block + sizeof(BinaryLogBlockHeader) + blockCount * sizeof(BinaryLogRecord),
+           &record, sizeof(record));
+    blockCount++;
+
+    bool ok = true;
+    if (blockCount == BINARY_LOG_RECORDS_PER_BLOCK) {
+        ok = writeBlock();
+        blocksWritten++;
+        blockSequence++;
+        blockCount = 0;
+        flushedCount = 0;
+        resetBlock(block, blockSequence);
+    }
+
+    if (millis() - lastFlushMs >= flushIntervalMs) {
+        ok &= flush();
+    }
+    return ok;
+}
+
+bool BinaryLogWriter::flush() {
+    if (!fileOpen) return true;
+
+    bool ok = true;
+    if (blockCount > flushedCount) {
+        ok = writeBlock();
+    }
+    file.flush();
+    lastFlushMs = millis();
+    return ok;
+}
+
+void BinaryLogWriter::close() {
+    if (!fileOpen) return;
+    flush();
+    file.close();
+    fileOpen = false;
+}
+
+// =======================================================
+//   CSV EXPORT
+// =======================================================
+
+// Tambah ",nilai" fixed-point ke baris CSV; nilai "tidak tersedia" ditulis kosong
+static void appendCsvValue(char* line, size_t size, int64_t value, int64_t missing,
+                           double scale, int decimals) {
+    size_t length = strlen(line);
+    if (value == missing) {
+        snprintf(line + length, size - length, ",");
+    } else {
+        snprintf(line + length, size - length, ",%.*f", decimals, value / scale);
+    }
+}
+
+size_t formatBinaryLogRecordCsv(const BinaryLogRecord& record, char* line, size_t size) {
+    char timestamp[WIB_TIMESTAMP_SIZE];
+    if (record.timestamp == DELTA_MISSING_TIME ||
+        format_wib_epoch(record.timestamp, timestamp, sizeof(timestamp)) == 0) {
+        timestamp[0] = '\0';
+    }
+
+    snprintf(line, size, "%s,%s", timestamp, DEVICE_ID);
+    appendCsvValue(line, size, record.distance1Mm, DELTA_MISSING_MM, 10.0, 1);
+    appendCsvValue(line, size, record.distance2Mm, DELTA_MISSING_MM, 10.0, 1);
+    appendCsvValue(line, size, record.latitudeE7, DELTA_MISSING_COORD, 1e7, 7);
+    appendCsvValue(line, size, record.longitudeE7, DELTA_MISSING_COORD, 1e7, 7);
+    appendCsvValue(line, size, record.depthMm, DELTA_MISSING_MM, 10.0, 2);
+    appendCsvValue(line, size, record.satellites, -1, 1.0, 0);
+    appendCsvValue(line, size, record.hdopX100, 0xFFFF, 100.0, 2);
+    appendCsvValue(line, size, record.capturedAtMs, -1, 1.0, 0);
+    return strlen(line);
+}
+
+bool exportBinaryLogToCsv(const char* binPath, const char* csvPath) {
+    if (!isSdCardOk) return false;
+
+    File input = SD.open(binPath, FILE_READ);
+    if (!input) {
+        Serial.print("❌ Cannot open binary log: ");
+        Serial.println(binPath);
+        return false;
+    }
+
+    File output = SD.open(csvPath, FILE_WRITE);
+    if (!output) {
+        Serial.print("❌ Cannot create CSV export: ");
+        Serial.println(csvPath);
+        input.close();
+        return false;
+    }
+
+    Serial.print("📤 Exporting ");
+    Serial.print(binPath);
+    Serial.print(" -> ");
+    Serial.println(csvPath);
+
+    output.println(BINARY_LOG_CSV_HEADER);
+
+    uint8_t block[BINARY_LOG_BLOCK_SIZE];
+    uint32_t records = 0;
+    uint32_t badBlocks = 0;
+    char line[BINARY_LOG_CSV_LINE_SIZE];
+
+    while (input.read(block, sizeof(block)) == sizeof(block)) {
+        if (!isBinaryLogBlockValid(block)) {
+            badBlocks++;
+            continue;
+        }
+
+        for (uint8_t i = 0; i < block[3]; i++) {
+            BinaryLogRecord record;
+            memcpy(&record, block + sizeof(BinaryLogBlockHeader) + i * sizeof(BinaryLogRecord),
+                   sizeof(record));
+
+            formatBinaryLogRecordCsv(record, line, sizeof(line));
+            output.println(line);
+            records++;
+        }
+    }
+
+    input.close();
+    output.close();
+
+    Serial.print("✅ Exported ");
+    Serial.print(records);
+    Serial.print(" records");
+    if (badBlocks > 0) {
+        Serial.print(" (⚠️ ");
+        Serial.print(badBlocks);
+        Serial.print(" corrupt blocks skipped)");
+    }
+    Serial.println("");
+    return true;
+}
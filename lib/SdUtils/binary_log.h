@@ -0,0 +1,136 @@
+#ifndef BINARY_LOG_H
+#define BINARY_LOG_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include "FS.h"
+#include "../include/config.h"
+#include "../VatSensor/vat_sensor_data.h"
+
+// =======================================================
+//   BINARY DAILY LOG
+//   File /vatlog_YYYY-MM-DD.bin = deretan blok 512 byte (1 sektor SD):
+//     header 8 byte | BINARY_LOG_RECORDS_PER_BLOCK x BinaryLogRecord | padding | CRC32
+//   Blok terakhir boleh berisi sebagian record; blok tersebut ditulis ulang
+//   di tempat yang sama sampai penuh, sehingga setiap write selalu 1 sektor utuh.
+// =======================================================
+
+#define BINARY_LOG_EXTENSION ".bin"
+#define BINARY_LOG_BLOCK_SIZE 512
+#define BINARY_LOG_MAGIC0 'V'
+#define BINARY_LOG_MAGIC1 'L'
+#define BINARY_LOG_VERSION 1
+
+// Flag record
+#define BINARY_LOG_FLAG_TIME_VALID 0x01  // Timestamp diketahui (VatSensorData::isValid: GPS atau jam sistem/NTP)
+
+/**
+ * @brief Satu sampel di log biner (28 byte, little-endian, tanpa padding)
+ *
+ * Fixed-point sama dengan telemetry_delta.h: lat/lon derajat x 1e7, jarak/depth milimeter.
+ */
+struct BinaryLogRecord {
+    uint32_t timestamp;         // Detik Unix UTC (0 = tidak diketahui)
+    int32_t latitudeE7;
+    int32_t longitudeE7;
+    uint32_t capturedAtMs;      // millis() saat sampel diambil (urutan sub-detik)
+    int16_t distance1Mm;
+    int16_t distance2Mm;
+    int16_t depthMm;
+    uint16_t hdopX100;
+    uint8_t satellites;
+    uint8_t flags;              // BINARY_LOG_FLAG_*
+    uint16_t reserved;
+};
+
+struct BinaryLogBlockHeader {
+    uint8_t magic[2];           // 'V' 'L'
+    uint8_t version;
+    uint8_t count;              // Jumlah record terisi di blok ini
+    uint32_t sequence;          // Nomor blok di dalam file (0, 1, 2, ...)
+};
+
+// Kolom CSV hasil export (kolom log CSV lama + uptime_ms)
+#define BINARY_LOG_CSV_HEADER \
+    "timestamp_wib,device_id,distance1,distance2,latitude,longitude,depth,satellites,hdop,uptime_ms"
+#define BINARY_LOG_CSV_LINE_SIZE 200
+
+#define BINARY_LOG_CRC_OFFSET (BINARY_LOG_BLOCK_SIZE - 4)
+#define BINARY_LOG_RECORDS_PER_BLOCK \
+    ((BINARY_LOG_CRC_OFFSET - sizeof(BinaryLogBlockHeader)) / sizeof(BinaryLogRecord))
+
+/**
+ * @brief Penulis log harian biner: file tetap terbuka, record dikumpulkan di buffer
+ *        satu sektor dan ditulis per blok 512 byte.
+ *
+ * Blok ditulis saat penuh, atau saat flushIntervalMs terlewati (blok parsial,
+ * ditimpa lagi nanti). Ganti hari otomatis menutup file lama dan membuka file baru.
+ * Tidak thread-safe - panggil hanya dari satu task (task storage).
+ */
+class BinaryLogWriter {
+private:
+    File file;
+    bool fileOpen;
+    uint16_t fileYear;
+    uint8_t fileMonth;
+    uint8_t fileDay;
+    uint32_t blockSequence;     // Nomor blok yang sedang diisi
+    uint8_t blockCount;         // Record di buffer
+    uint8_t flushedCount;       // Record yang sudah ada di kartu untuk blok ini
+    unsigned long lastFlushMs;
+    unsigned long flushIntervalMs;
+    uint32_t blocksWritten;
+    uint32_t writeErrors;
+    uint8_t block[BINARY_LOG_BLOCK_SIZE];
+
+    bool open(uint16_t year, uint8_t month, uint8_t day);
+    bool writeBlock();
+
+public:
+    BinaryLogWriter(unsigned long flushIntervalMs = DAILY_LOG_FLUSH_INTERVAL);
+
+    /**
+     * @brief Tambah satu sampel (sampel tanpa waktu GPS diabaikan, sama seperti log CSV)
+     * @return false jika file tidak bisa dibuka / ditulis
+     */
+    bool append(const VatSensorData& data);
+
+    /**
+     * @brief Tulis blok parsial ke kartu dan commit FAT (file.flush)
+     */
+    bool flush();
+
+    /**
+     * @brief Flush lalu tutup file
+     */
+    void close();
+
+    uint32_t getBlocksWritten() const { return blocksWritten; }
+    uint32_t getWriteErrors() const { return writeErrors; }
+};
+
+/**
+ * @brief Isi record log biner dari sampel sensor
+ */
+void toBinaryLogRecord(const VatSensorData& data, BinaryLogRecord& record);
+
+/**
+ * @brief Validasi magic, versi, count dan CRC satu blok
+ */
+bool isBinaryLogBlockValid(const uint8_t* block);
+
+/**
+ * @brief Tulis satu record sebagai baris CSV (tanpa newline, kolom BINARY_LOG_CSV_HEADER)
+ * @return Panjang baris
+ */
+size_t formatBinaryLogRecordCsv(const BinaryLogRecord& record, char* line, size_t size);
+
+/**
+ * @brief Ubah log biner menjadi CSV (kolom sama dengan log CSV lama + uptime_ms)
+ * @param binPath Path file .bin
+ * @param csvPath Path file .csv tujuan (ditimpa)
+ * @return true jika berhasil; blok dengan CRC salah dilewati dan dilaporkan
+ */
+bool exportBinaryLogToCsv(const char* binPath, const char* csvPath);
+
+#endif // BINARY_LOG_H
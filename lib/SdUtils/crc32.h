@@ -0,0 +1,16 @@
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief CRC-32 (IEEE 802.3, sama dengan zlib.crc32 di Python)
+ * @param data Data yang dihitung
+ * @param length Panjang data dalam byte
+ * @param previous CRC potongan sebelumnya untuk perhitungan bertahap (0 untuk awal)
+ * @return Nilai CRC-32
+ */
+uint32_t crc32Compute(const void* data, size_t length, uint32_t previous = 0);
+
+#endif // CRC32_H
@@ -0,0 +1,440 @@
+#include "log_compress.h"
+#include <string.h>
+#include <stdio.h>
+#include "crc32.h"
+
+LogCompressor::LogCompressor() {
+    state = IDLE;
+    lastResult = false;
+    sourcePath[0] = '\0';
+    tempPath[0] = '\0';
+    targetPath[0] = '\0';
+    startMs = 0;
+    windowPos = 0;
+    windowEnd = 0;
+    inputDone = false;
+    groupLength = 0;
+    groupItems = 0;
+    sourceSize = 0;
+    sourceCrc = 0;
+    compressedSize = 0;
+    ioPos = 0;
+}
+
+static inline uint16_t hash3(const uint8_t* data) {
+    return ((data[0] << 8) ^ (data[1] << 4) ^ data[2]) & (LZSS_HASH_SIZE - 1);
+}
+
+// =======================================================
+//   LIFECYCLE
+// =======================================================
+
+bool LogCompressor::start(const char* path) {
+    abort();
+    snprintf(sourcePath, sizeof(sourcePath), "%s", path);
+    snprintf(tempPath, sizeof(tempPath), "%s" LOG_COMPRESS_TEMP_EXTENSION, path);
+    snprintf(targetPath, sizeof(targetPath), "%s" LOG_COMPRESS_EXTENSION, path);
+    lastResult = false;
+
+    input = SD.open(sourcePath, FILE_READ);
+    if (!input) {
+        Serial.print("❌ Cannot open log for compression: ");
+        Serial.println(sourcePath);
+        return false;
+    }
+
+    output = SD.open(tempPath, FILE_WRITE);
+    if (!output) {
+        Serial.print("❌ Cannot create ");
+        Serial.println(tempPath);
+        input.close();
+        return false;
+    }
+
+    // Ukuran & CRC diisi ulang setelah compress selesai
+    LogCompressHeader header = {{LOG_COMPRESS_MAGIC0, LOG_COMPRESS_MAGIC1},
+                                LOG_COMPRESS_VERSION, LZSS_WINDOW_BITS, 0, 0};
+    if (output.write((const uint8_t*)&header, sizeof(header)) != sizeof(header)) {
+        state = COMPRESSING;
+        fail("write error");
+        return false;
+    }
+
+    memset(head, 0xFF, sizeof(head));   // LZSS_NIL
+    memset(prev, 0xFF, sizeof(prev));
+    windowPos = 0;
+    windowEnd = 0;
+    inputDone = false;
+    group[0] = 0;
+    groupLength = 1;
+    groupItems = 0;
+    sourceSize = 0;
+    sourceCrc = 0;
+    compressedSize = sizeof(header);
+    ioPos = 0;
+    startMs = millis();
+    state = COMPRESSING;
+
+    Serial.print("🗜️ Compressing ");
+    Serial.println(sourcePath);
+    return true;
+}
+
+bool LogCompressor::step() {
+    switch (state) {
+        case COMPRESSING:
+            compressChunk();
+            break;
+        case VERIFYING:
+            verifyChunk();
+            break;
+        case IDLE:
+            break;
+    }
+    return state != IDLE;
+}
+
+void LogCompressor::closeFiles() {
+    if (input) input.close();
+    if (output) output.close();
+    verifier.close();
+}
+
+void LogCompressor::abort() {
+    if (state == IDLE) return;
+    closeFiles();
+    SD.remove(tempPath);
+    state = IDLE;
+}
+
+void LogCompressor::fail(const char* reason) {
+    Serial.print("❌ Log compression failed (");
+    Serial.print(reason);
+    Serial.print("): ");
+    Serial.println(sourcePath);
+    abort();
+    lastResult = false;
+}
+
+// =======================================================
+//   ENCODER
+// =======================================================
+
+// Jaga lookahead minimal LZSS_MAX_MATCH byte (kecuali di akhir file)
+void LogCompressor::fillWindow() {
+    while (!inputDone && windowEnd - windowPos < LZSS_MAX_MATCH) {
+        if (windowEnd == sizeof(window)) slideWindow();
+
+        size_t got = input.read(window + windowEnd, sizeof(window) - windowEnd);
+        if (got == 0) {
+            inputDone = true;
+            break;
+        }
+        sourceCrc = crc32Compute(window + windowEnd, got, sourceCrc);
+        sourceSize += got;
+        windowEnd += got;
+    }
+}
+
+// Buang separuh window tertua; posisi di hash chain ikut digeser
+void LogCompressor::slideWindow() {
+    memmove(window, window + LZSS_WINDOW_SIZE, windowEnd - LZSS_WINDOW_SIZE);
+    windowPos -= LZSS_WINDOW_SIZE;
+    windowEnd -= LZSS_WINDOW_SIZE;
+
+    for (size_t i = 0; i < LZSS_HASH_SIZE; i++) {
+        head[i] = (head[i] != LZSS_NIL && head[i] >= LZSS_WINDOW_SIZE) ? head[i] - LZSS_WINDOW_SIZE : LZSS_NIL;
+    }
+    for (size_t i = 0; i < LZSS_WINDOW_SIZE; i++) {
+        prev[i] = (prev[i] != LZSS_NIL && prev[i] >= LZSS_WINDOW_SIZE) ? prev[i] - LZSS_WINDOW_SIZE : LZSS_NIL;
+    }
+}
+
+void LogCompressor::insertHash(size_t position) {
+    uint16_t hash = hash3(window + position);
+    prev[position & (LZSS_WINDOW_SIZE - 1)] = head[hash];
+    head[hash] = position;
+}
+
+size_t LogCompressor::findMatch(size_t& distance) {
+    size_t available = windowEnd - windowPos;
+    if (available < LZSS_MIN_MATCH) return 0;
+
+    size_t maxLength = available < LZSS_MAX_MATCH ? available : LZSS_MAX_MATCH;
+    size_t limit = windowPos > LZSS_WINDOW_SIZE ? windowPos - LZSS_WINDOW_SIZE : 0;
+    const uint8_t* current = window + windowPos;
+    uint16_t candidate = head[hash3(current)];
+    size_t best = 0;
+
+    for (int chain = LZSS_MAX_CHAIN; chain > 0 && candidate != LZSS_NIL && candidate >= limit; chain--) {
+        const uint8_t* match = window + candidate;
+        if (match[best] == current[best]) {
+            size_t length = 0;
+            while (length < maxLength && match[length] == current[length]) length++;
+            if (length > best) {
+                best = length;
+                distance = windowPos - candidate;
+                if (best == maxLength) break;
+            }
+        }
+
+        // Slot prev bisa sudah ditimpa posisi yang lebih baru - chain harus selalu mundur
+        uint16_t next = prev[candidate & (LZSS_WINDOW_SIZE - 1)];
+        if (next >= candidate) break;
+        candidate = next;
+    }
+    return best >= LZSS_MIN_MATCH ? best : 0;
+}
+
+bool LogCompressor::writeOutput(const uint8_t* data, size_t length) {
+    compressedSize += length;
+    while (length > 0) {
+        size_t room = sizeof(io) - ioPos;
+        size_t count = length < room ? length : room;
+        memcpy(io + ioPos, data, count);
+        ioPos += count;
+        data += count;
+        length -= count;
+
+        if (ioPos == sizeof(io)) {
+            if (output.write(io, ioPos) != ioPos) return false;
+            ioPos = 0;
+        }
+    }
+    return true;
+}
+
+bool LogCompressor::flushGroup() {
+    if (groupItems == 0) return true;
+    bool ok = writeOutput(group, groupLength);
+    group[0] = 0;
+    groupLength = 1;
+    groupItems = 0;
+    return ok;
+}
+
+bool LogCompressor::emitLiteral(uint8_t value) {
+    group[0] |= 1 << groupItems;
+    group[groupLength++] = value;
+    return ++groupItems < 8 || flushGroup();
+}
+
+bool LogCompressor::emitMatch(size_t distance, size_t length) {
+    uint16_t token = ((distance - 1) << LZSS_LENGTH_BITS) | (length - LZSS_MIN_MATCH);
+    group[groupLength++] = token >> 8;
+    group[groupLength++] = token & 0xFF;
+    return ++groupItems < 8 || flushGroup();
+}
+
+void LogCompressor::compressChunk() {
+    for (size_t processed = 0; processed < LOG_COMPRESS_CHUNK_BYTES; ) {
+        fillWindow();
+        if (windowPos >= windowEnd) {
+            finishCompress();
+            return;
+        }
+
+        // Greedy: match terpanjang di window, semua posisi yang dilewati masuk hash chain
+        size_t distance = 0;
+        size_t length = findMatch(distance);
+        bool ok;
+        if (length > 0) {
+            ok = emitMatch(distance, length);
+        } else {
+            ok = emitLiteral(window[windowPos]);
+            length = 1;
+        }
+
+        for (size_t i = 0; i < length; i++, windowPos++) {
+            if (windowEnd - windowPos >= LZSS_MIN_MATCH) insertHash(windowPos);
+        }
+        processed += length;
+
+        if (!ok) {
+            fail("write error");
+            return;
+        }
+    }
+}
+
+void LogCompressor::finishCompress() {
+    if (!flushGroup() || (ioPos > 0 && output.write(io, ioPos) != ioPos)) {
+        fail("write error");
+        return;
+    }
+    ioPos = 0;
+
+    LogCompressHeader header = {{LOG_COMPRESS_MAGIC0, LOG_COMPRESS_MAGIC1},
+                                LOG_COMPRESS_VERSION, LZSS_WINDOW_BITS, sourceSize, sourceCrc};
+    if (!output.seek(0) || output.write((const uint8_t*)&header, sizeof(header)) != sizeof(header)) {
+        fail("write error");
+        return;
+    }
+    closeFiles();
+    startVerify();
+}
+
+// =======================================================
+//   VERIFY (decode ulang sebelum file asli dihapus)
+// =======================================================
+
+void LogCompressor::startVerify() {
+    state = VERIFYING;
+    if (!verifier.open(tempPath) ||
+        verifier.getOriginalSize() != sourceSize || verifier.getOriginalCrc() != sourceCrc) {
+        fail("bad header");
+    }
+}
+
+void LogCompressor::verifyChunk() {
+    uint8_t chunk[256];
+    for (size_t processed = 0; processed < LOG_COMPRESS_CHUNK_BYTES; ) {
+        int got = verifier.read(chunk, sizeof(chunk));
+        if (got < 0) {
+            fail("corrupt stream");
+            return;
+        }
+        if (got == 0) {
+            finishVerify();
+            return;
+        }
+        processed += got;
+    }
+}
+
+void LogCompressor::finishVerify() {
+    bool complete = verifier.isComplete();
+    closeFiles();
+    if (!complete) {
+        fail("CRC mismatch");
+        return;
+    }
+
+    // Ganti file asli hanya setelah hasil kompresi terbukti utuh
+    if (SD.exists(targetPath)) SD.remove(targetPath);
+    if (!SD.rename(tempPath, targetPath)) {
+        fail("rename failed");
+        return;
+    }
+    SD.remove(sourcePath);
+    state = IDLE;
+    lastResult = true;
+
+    unsigned long elapsed = millis() - startMs;
+    Serial.print("✅ Compressed ");
+    Serial.print(sourcePath);
+    Serial.print(": ");
+    Serial.print(sourceSize);
+    Serial.print(" -> ");
+    Serial.print(compressedSize);
+    Serial.print(" bytes (");
+    Serial.print(compressedSize > 0 ? (float)sourceSize / compressedSize : 0.0f, 1);
+    Serial.print("x, ");
+    Serial.print(elapsed);
+    Serial.println(" ms)");
+}
+
+// =======================================================
+//   READER
+// =======================================================
+
+LzssReader::LzssReader() {
+    memset(&header, 0, sizeof(header));
+    ioPos = 0;
+    ioLength = 0;
+    produced = 0;
+    crc = 0;
+    flags = 0;
+    flagBit = 8;
+    matchDistance = 0;
+    matchRemaining = 0;
+    corrupt = false;
+}
+
+bool LzssReader::open(const char* path) {
+    close();
+    file = SD.open(path, FILE_READ);
+    if (!file) return false;
+
+    if (file.read((uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+        header.magic[0] != LOG_COMPRESS_MAGIC0 || header.magic[1] != LOG_COMPRESS_MAGIC1 ||
+        header.version != LOG_COMPRESS_VERSION || header.windowBits != LZSS_WINDOW_BITS) {
+        file.close();
+        return false;
+    }
+
+    ioPos = 0;
+    ioLength = 0;
+    produced = 0;
+    crc = 0;
+    flagBit = 8;
+    matchRemaining = 0;
+    corrupt = false;
+    return true;
+}
+
+void LzssReader::close() {
+    if (file) file.close();
+}
+
+int LzssReader::readByte() {
+    if (ioPos == ioLength) {
+        ioLength = file.read(io, sizeof(io));
+        ioPos = 0;
+        if (ioLength == 0) return -1;
+    }
+    return io[ioPos++];
+}
+
+int LzssReader::read(uint8_t* out, size_t size) {
+    if (corrupt || !file) return -1;
+
+    size_t count = 0;
+    while (count < size && produced < header.originalSize) {
+        if (matchRemaining > 0) {
+            uint8_t value = ring[(produced - matchDistance) & (LZSS_WINDOW_SIZE - 1)];
+            ring[produced & (LZSS_WINDOW_SIZE - 1)] = value;
+            out[count++] = value;
+            produced++;
+            matchRemaining--;
+            continue;
+        }
+
+        if (flagBit == 8) {
+            int value = readByte();
+            if (value < 0) break;
+            flags = value;
+            flagBit = 0;
+        }
+        bool literal = flags & (1 << flagBit);
+        flagBit++;
+
+        if (literal) {
+            int value = readByte();
+            if (value < 0) break;
+            ring[produced & (LZSS_WINDOW_SIZE - 1)] = value;
+            out[count++] = value;
+            produced++;
+        } else {
+            int high = readByte();
+            int low = readByte();
+            if (high < 0 || low < 0) break;
+            uint16_t token = (high << 8) | low;
+            matchDistance = (token >> LZSS_LENGTH_BITS) + 1;
+            matchRemaining = (token & ((1 << LZSS_LENGTH_BITS) - 1)) + LZSS_MIN_MATCH;
+            if (matchDistance > produced || matchRemaining > header.originalSize - produced) break;
+        }
+    }
+
+    if (count < size && produced < header.originalSize) {
+        // Stream habis / token tidak valid sebelum ukuran asli tercapai
+        corrupt = true;
+        return -1;
+    }
+    crc = crc32Compute(out, count, crc);
+    return count;
+}
+
+bool LzssReader::isComplete() const {
+    return !corrupt && produced == header.originalSize && crc == header.originalCrc;
+}
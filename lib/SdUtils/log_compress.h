@@ -0,0 +1,172 @@
+#ifndef LOG_COMPRESS_H
+#define LOG_COMPRESS_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include "FS.h"
+#include "../include/config.h"
+
+// =======================================================
+//   LOG COMPRESSION (LZSS)
+//   File <log>.lzs = header 12 byte + stream LZSS:
+//     flag byte (bit 0 = item pertama, 1 = literal, 0 = match) diikuti 8 item
+//     literal : 1 byte
+//     match   : 2 byte big-endian, (jarak - 1) << LZSS_LENGTH_BITS | (panjang - LZSS_MIN_MATCH)
+//   Window 2 KB dan hash chain terbatas -> RAM tetap ~20 KB, tanpa malloc.
+//   Decoder host: tools/lzss_log.py
+// =======================================================
+
+#define LOG_COMPRESS_EXTENSION ".lzs"
+#define LOG_COMPRESS_TEMP_EXTENSION ".lzs.tmp"
+#define LOG_COMPRESS_MAGIC0 'V'
+#define LOG_COMPRESS_MAGIC1 'Z'
+#define LOG_COMPRESS_VERSION 1
+
+#define LZSS_WINDOW_BITS 11
+#define LZSS_LENGTH_BITS (16 - LZSS_WINDOW_BITS)
+#define LZSS_WINDOW_SIZE (1 << LZSS_WINDOW_BITS)
+#define LZSS_MIN_MATCH 3
+#define LZSS_MAX_MATCH (LZSS_MIN_MATCH + (1 << LZSS_LENGTH_BITS) - 1)
+#define LZSS_HASH_BITS 12
+#define LZSS_HASH_SIZE (1 << LZSS_HASH_BITS)
+#define LZSS_MAX_CHAIN 32           // Kandidat match maksimal per posisi
+#define LZSS_NIL 0xFFFF
+
+struct LogCompressHeader {
+    uint8_t magic[2];           // 'V' 'Z'
+    uint8_t version;
+    uint8_t windowBits;         // Panjang match memakai 16 - windowBits bit
+    uint32_t originalSize;
+    uint32_t originalCrc;       // CRC32 file asli (diverifikasi sebelum file asli dihapus)
+};
+
+/**
+ * @brief Pembaca streaming file .lzs (RAM tetap: ring window + buffer baca)
+ *
+ * read() mengembalikan data asli potongan demi potongan; CRC32 dihitung
+ * sambil jalan dan dicek dengan header setelah semua data terbaca.
+ */
+class LzssReader {
+private:
+    File file;
+    LogCompressHeader header;
+    uint8_t ring[LZSS_WINDOW_SIZE];
+    uint8_t io[256];
+    size_t ioPos;
+    size_t ioLength;
+    uint32_t produced;
+    uint32_t crc;
+    uint8_t flags;
+    uint8_t flagBit;
+    uint32_t matchDistance;     // Match yang belum selesai disalin ke buffer pemanggil
+    uint32_t matchRemaining;
+    bool corrupt;
+
+    int readByte();
+
+public:
+    LzssReader();
+
+    /**
+     * @brief Buka file .lzs dan validasi header
+     */
+    bool open(const char* path);
+
+    /**
+     * @brief Dekompres sampai size byte ke out
+     * @return Jumlah byte, 0 di akhir data, -1 jika stream rusak
+     */
+    int read(uint8_t* out, size_t size);
+
+    void close();
+
+    /**
+     * @brief true jika semua data sudah terbaca dan CRC32 cocok dengan header
+     */
+    bool isComplete() const;
+
+    uint32_t getOriginalSize() const { return header.originalSize; }
+    uint32_t getOriginalCrc() const { return header.originalCrc; }
+};
+
+/**
+ * @brief Kompresi satu log harian secara bertahap: compress -> verifikasi -> ganti
+ *
+ * Hasil ditulis ke <log>.lzs.tmp, didekompres ulang dan dicocokkan dengan CRC32
+ * file asli, baru kemudian di-rename ke <log>.lzs dan file asli dihapus.
+ * Setiap step() memproses LOG_COMPRESS_CHUNK_BYTES, jadi bisa dipanggil dari
+ * task storage tanpa menahan logging. Tidak thread-safe.
+ */
+class LogCompressor {
+private:
+    enum State { IDLE, COMPRESSING, VERIFYING };
+
+    State state;
+    bool lastResult;
+    File input;
+    File output;
+    char sourcePath[40];
+    char tempPath[48];
+    char targetPath[48];
+    unsigned long startMs;
+
+    // Encoder: window geser 2x ukuran window + hash chain posisi
+    uint8_t window[2 * LZSS_WINDOW_SIZE];
+    uint16_t head[LZSS_HASH_SIZE];
+    uint16_t prev[LZSS_WINDOW_SIZE];
+    size_t windowPos;
+    size_t windowEnd;
+    bool inputDone;
+    uint8_t group[1 + 8 * 2];   // Flag byte + maksimal 8 item
+    size_t groupLength;
+    uint8_t groupItems;
+    uint32_t sourceSize;
+    uint32_t sourceCrc;
+    uint32_t compressedSize;
+
+    // Buffer output saat compress
+    uint8_t io[512];
+    size_t ioPos;
+
+    LzssReader verifier;        // Decode ulang hasil kompresi sebelum file asli dihapus
+
+    void fillWindow();
+    void slideWindow();
+    void insertHash(size_t position);
+    size_t findMatch(size_t& distance);
+    bool emitLiteral(uint8_t value);
+    bool emitMatch(size_t distance, size_t length);
+    bool flushGroup();
+    bool writeOutput(const uint8_t* data, size_t length);
+    void compressChunk();
+    void finishCompress();
+    void startVerify();
+    void verifyChunk();
+    void finishVerify();
+    void fail(const char* reason);
+    void closeFiles();
+
+public:
+    LogCompressor();
+
+    /**
+     * @brief Mulai kompresi file log (file lain yang sedang diproses dibatalkan)
+     * @return false jika file tidak bisa dibuka
+     */
+    bool start(const char* path);
+
+    /**
+     * @brief Proses satu potongan; true selama pekerjaan belum selesai
+     */
+    bool step();
+
+    /**
+     * @brief Batalkan pekerjaan dan hapus file sementara
+     */
+    void abort();
+
+    bool isRunning() const { return state != IDLE; }
+    bool getLastResult() const { return lastResult; }
+};
+
+#endif // LOG_COMPRESS_H
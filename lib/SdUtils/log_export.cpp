@@ -0,0 +1,347 @@
+#include "log_export.h"
+#include <string.h>
+#include <stdio.h>
+#include "sd_utils.h"
+
+// Urutan prioritas sumber untuk satu hari
+static const uint8_t EXPORT_SOURCE_PRIORITY[] = {
+    LOG_FILE_BIN, LOG_FILE_BIN_LZS, LOG_FILE_CSV, LOG_FILE_CSV_LZS
+};
+
+LogExporter::LogExporter() {
+    state = IDLE;
+    lastResult = false;
+    startMs = 0;
+    dayCount = 0;
+    dayIndex = 0;
+    sourceOpen = false;
+    sourceCompressed = false;
+    sourceBinary = false;
+    sourceOk = false;
+    sourcePath[0] = '\0';
+    sourceRows = 0;
+    csvLength = 0;
+    csvFirstLine = true;
+    csvOverflow = false;
+    csvAppendUptime = true;
+    used = 0;
+    writeError = false;
+    lastTimestamp[0] = '\0';
+    previousLine[0] = '\0';
+    rows = 0;
+    duplicates = 0;
+    bytes = 0;
+}
+
+// =======================================================
+//   OUTPUT (buffer tetap + deduplikasi)
+// =======================================================
+
+void LogExporter::writeBytes(const char* data, size_t length) {
+    while (length > 0 && !writeError) {
+        size_t count = sizeof(buffer) - used;
+        if (count > length) count = length;
+        memcpy(buffer + used, data, count);
+        used += count;
+        bytes += count;
+        data += count;
+        length -= count;
+
+        if (used == sizeof(buffer)) {
+            writeError = output.write(buffer, used) != used;
+            used = 0;
+        }
+    }
+}
+
+void LogExporter::flushOutput() {
+    if (used > 0 && !writeError) {
+        writeError = output.write(buffer, used) != used;
+    }
+    used = 0;
+}
+
+// Tulis satu baris data; timestamp mundur atau baris kembar dilewati
+void LogExporter::writeRow(const char* line) {
+    const char* comma = strchr(line, ',');
+    size_t timestampLength = comma ? (size_t)(comma - line) : strlen(line);
+
+    if (timestampLength > 0 && timestampLength < sizeof(lastTimestamp)) {
+        char timestamp[WIB_TIMESTAMP_SIZE];
+        memcpy(timestamp, line, timestampLength);
+        timestamp[timestampLength] = '\0';
+
+        int order = strcmp(timestamp, lastTimestamp);
+        if (order < 0 || (order == 0 && strcmp(line, previousLine) == 0)) {
+            duplicates++;
+            return;
+        }
+        memcpy(lastTimestamp, timestamp, timestampLength + 1);
+    }
+
+    snprintf(previousLine, sizeof(previousLine), "%s", line);
+    writeBytes(line, strlen(line));
+    writeBytes("\n", 1);
+    rows++;
+}
+
+// =======================================================
+//   SOURCES
+// =======================================================
+
+// Baca sampai size byte (kurang hanya di akhir file); -1 jika stream .lzs rusak
+int LogExporter::readSource(uint8_t* out, size_t size) {
+    size_t total = 0;
+    while (total < size) {
+        int got = sourceCompressed ? reader.read(out + total, size - total)
+                                   : (int)source.read(out + total, size - total);
+        if (got < 0) return -1;
+        if (got == 0) break;
+        total += got;
+    }
+    return total;
+}
+
+void LogExporter::exportBinaryBlock() {
+    if (!isBinaryLogBlockValid(readBuffer)) return;
+
+    char line[BINARY_LOG_CSV_LINE_SIZE];
+    for (uint8_t i = 0; i < readBuffer[3]; i++) {
+        BinaryLogRecord record;
+        memcpy(&record, readBuffer + sizeof(BinaryLogBlockHeader) + i * sizeof(BinaryLogRecord),
+               sizeof(record));
+        formatBinaryLogRecordCsv(record, line, sizeof(line));
+        writeRow(line);
+    }
+}
+
+void LogExporter::exportCsvChunk(size_t length) {
+    // Log CSV lama tidak punya kolom uptime_ms - ditambah kolom kosong
+    for (size_t i = 0; i < length; i++) {
+        char c = readBuffer[i];
+        if (c != '\n') {
+            if (csvLength < sizeof(csvLine) - 2) {
+                csvLine[csvLength++] = c;
+            } else {
+                csvOverflow = true;
+            }
+            continue;
+        }
+
+        if (csvLength > 0 && csvLine[csvLength - 1] == '\r') csvLength--;
+        csvLine[csvLength] = '\0';
+
+        if (csvFirstLine && strncmp(csvLine, "timestamp", 9) == 0) {
+            csvAppendUptime = strstr(csvLine, "uptime_ms") == NULL;
+        } else if (csvLength > 0 && !csvOverflow) {
+            if (csvAppendUptime) {
+                csvLine[csvLength++] = ',';
+                csvLine[csvLength] = '\0';
+            }
+            writeRow(csvLine);
+        }
+        csvFirstLine = false;
+        csvOverflow = false;
+        csvLength = 0;
+    }
+}
+
+// Buka sumber hari dayIndex; hari yang tidak bisa dibuka langsung dilewati
+void LogExporter::openDay() {
+    uint8_t kind = LOG_FILE_KIND_COUNT;
+    for (size_t p = 0; p < sizeof(EXPORT_SOURCE_PRIORITY); p++) {
+        if (days[dayIndex].kinds & (1 << EXPORT_SOURCE_PRIORITY[p])) {
+            kind = EXPORT_SOURCE_PRIORITY[p];
+            break;
+        }
+    }
+
+    time_t dayStart = (time_t)days[dayIndex].day * 86400;
+    struct tm tm;
+    gmtime_r(&dayStart, &tm);
+    String path = generateLogFileName(tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+                                      LogRetention::getExtension(kind));
+    snprintf(sourcePath, sizeof(sourcePath), "%s", path.c_str());
+
+    sourceCompressed = kind == LOG_FILE_CSV_LZS || kind == LOG_FILE_BIN_LZS;
+    sourceBinary = kind == LOG_FILE_BIN || kind == LOG_FILE_BIN_LZS;
+    if (sourceCompressed) {
+        sourceOpen = reader.open(sourcePath);
+    } else {
+        source = SD.open(sourcePath, FILE_READ);
+        sourceOpen = (bool)source;
+    }
+    if (!sourceOpen) {
+        Serial.printf("📤 [%u/%u] %s: 0 rows ❌ cannot open\n", (unsigned)(dayIndex + 1),
+                      (unsigned)dayCount, sourcePath);
+        dayIndex++;
+        return;
+    }
+
+    sourceOk = true;
+    sourceRows = rows;
+    csvLength = 0;
+    csvFirstLine = true;
+    csvOverflow = false;
+    csvAppendUptime = true;
+}
+
+void LogExporter::closeDay() {
+    if (sourceCompressed) {
+        sourceOk &= reader.isComplete();
+        reader.close();
+    } else {
+        source.close();
+    }
+    sourceOpen = false;
+
+    Serial.printf("📤 [%u/%u] %s: %lu rows%s\n", (unsigned)(dayIndex + 1), (unsigned)dayCount, sourcePath,
+                  (unsigned long)(rows - sourceRows), sourceOk ? "" : " ⚠️ corrupt/truncated");
+    dayIndex++;
+}
+
+// =======================================================
+//   DAY INDEX
+// =======================================================
+
+// Kumpulkan tanggal log di root, urut naik
+size_t LogExporter::scanDays(bool& truncated) {
+    size_t count = 0;
+    truncated = false;
+
+    File dir = SD.open("/");
+    if (!dir || !dir.isDirectory()) return 0;
+
+    File entry = dir.openNextFile();
+    while (entry) {
+        uint32_t day;
+        uint8_t kind;
+        if (!entry.isDirectory() && LogRetention::parseLogFileName(entry.name(), day, kind)) {
+            size_t position = count;
+            while (position > 0 && days[position - 1].day > day) position--;
+
+            if (position > 0 && days[position - 1].day == day) {
+                days[position - 1].kinds |= 1 << kind;
+            } else if (count < LOG_EXPORT_MAX_DAYS || position < count) {
+                // Index penuh - hari terbaru dibuang agar export tetap urut dari awal
+                if (count == LOG_EXPORT_MAX_DAYS) {
+                    count--;
+                    truncated = true;
+                }
+                memmove(&days[position + 1], &days[position], (count - position) * sizeof(Day));
+                days[position].day = day;
+                days[position].kinds = 1 << kind;
+                count++;
+            } else {
+                truncated = true;
+            }
+        }
+        entry.close();
+        entry = dir.openNextFile();
+    }
+    dir.close();
+    return count;
+}
+
+// =======================================================
+//   LIFECYCLE
+// =======================================================
+
+bool LogExporter::start(const char* exportPath) {
+    abort();
+    lastResult = false;
+    startMs = millis();
+
+    bool truncated;
+    dayCount = scanDays(truncated);
+    dayIndex = 0;
+
+    Serial.print("📤 Merging ");
+    Serial.print(dayCount);
+    Serial.print(" daily logs -> ");
+    Serial.println(exportPath);
+    if (truncated) {
+        Serial.println("⚠️ More than LOG_EXPORT_MAX_DAYS days on card - newest days skipped");
+    }
+
+    output = SD.open(exportPath, FILE_WRITE);
+    if (!output) {
+        Serial.print("❌ Cannot create export file: ");
+        Serial.println(exportPath);
+        return false;
+    }
+    used = 0;
+    writeError = false;
+    lastTimestamp[0] = '\0';
+    previousLine[0] = '\0';
+    rows = 0;
+    duplicates = 0;
+    bytes = 0;
+    sourceOpen = false;
+    state = EXPORTING;
+
+    writeBytes(BINARY_LOG_CSV_HEADER "\n", strlen(BINARY_LOG_CSV_HEADER) + 1);
+    return true;
+}
+
+bool LogExporter::step() {
+    size_t processed = 0;
+    while (state == EXPORTING && processed < LOG_EXPORT_STEP_BYTES) {
+        if (!sourceOpen) {
+            if (dayIndex >= dayCount || writeError) {
+                finish();
+            } else {
+                openDay();
+            }
+            continue;
+        }
+
+        // .bin per blok 512 byte (blok terakhir yang tidak utuh diabaikan), CSV per potongan
+        int got = readSource(readBuffer, sizeof(readBuffer));
+        if (sourceBinary && got == BINARY_LOG_BLOCK_SIZE) {
+            exportBinaryBlock();
+        } else if (!sourceBinary && got > 0) {
+            exportCsvChunk(got);
+        } else {
+            if (got < 0) sourceOk = false;
+            closeDay();
+            continue;
+        }
+        processed += got;
+    }
+    return state != IDLE;
+}
+
+void LogExporter::finish() {
+    flushOutput();
+    output.close();
+    state = IDLE;
+
+    unsigned long elapsed = millis() - startMs;
+    if (writeError) {
+        Serial.println("❌ ERROR: Failed to write export file!");
+        lastResult = false;
+        return;
+    }
+
+    Serial.printf("✅ Export done: %lu rows, %lu duplicates skipped, %lu bytes in %lu ms (%.1f KB/s)\n",
+                  (unsigned long)rows, (unsigned long)duplicates, (unsigned long)bytes,
+                  elapsed, elapsed > 0 ? bytes / 1.024f / elapsed : 0.0f);
+    lastResult = true;
+}
+
+void LogExporter::abort() {
+    if (state == IDLE) return;
+    if (sourceOpen) {
+        if (sourceCompressed) {
+            reader.close();
+        } else {
+            source.close();
+        }
+        sourceOpen = false;
+    }
+    output.close();
+    state = IDLE;
+    lastResult = false;
+    Serial.println("⚠️ Export aborted");
+}
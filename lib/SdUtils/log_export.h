@@ -0,0 +1,112 @@
+#ifndef LOG_EXPORT_H
+#define LOG_EXPORT_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include "FS.h"
+#include "../include/config.h"
+#include "binary_log.h"
+#include "log_compress.h"
+#include "../Telemetry/telemetry_json.h"
+
+// =======================================================
+//   MERGED EXPORT
+//   Semua log harian (/vatlog_YYYY-MM-DD .csv/.bin, terkompres .lzs atau tidak)
+//   digabung urut tanggal ke satu CSV dengan satu header (kolom BINARY_LOG_CSV_HEADER).
+//   Per hari dipakai satu sumber: .bin > .bin.lzs > .csv > .csv.lzs
+//   (CSV di hari yang sama dengan .bin biasanya hasil command exportlog).
+// =======================================================
+
+#define LOG_EXPORT_DEFAULT_FILE "/export_all.csv"
+
+/**
+ * @brief Export gabungan secara bertahap: start() lalu step() sampai false
+ *
+ * Streaming dengan buffer tetap (tanpa String untuk isi file). Baris dengan
+ * timestamp lebih tua dari baris terakhir yang ditulis, atau baris identik
+ * dengan timestamp sama, dianggap duplikat dan dilewati. Progress dicetak per hari.
+ * Setiap step() membaca maksimal LOG_EXPORT_STEP_BYTES dari log sumber, jadi
+ * pemanggil bisa melepas lock SD di antara langkah. Tidak thread-safe.
+ */
+class LogExporter {
+private:
+    enum State { IDLE, EXPORTING };
+
+    struct Day {
+        uint32_t day;           // Hari sejak 1970-01-01
+        uint8_t kinds;          // Bitmask LogFileKind yang ada di kartu
+    };
+
+    State state;
+    bool lastResult;
+    unsigned long startMs;
+
+    // Index hari (diisi start(), urut naik)
+    Day days[LOG_EXPORT_MAX_DAYS];
+    size_t dayCount;
+    size_t dayIndex;
+
+    // Sumber hari yang sedang dibaca
+    File source;
+    LzssReader reader;
+    bool sourceOpen;
+    bool sourceCompressed;
+    bool sourceBinary;
+    bool sourceOk;
+    char sourcePath[40];
+    uint32_t sourceRows;
+    uint8_t readBuffer[BINARY_LOG_BLOCK_SIZE];
+
+    // Parser CSV - baris boleh terpotong di antara dua step()
+    char csvLine[BINARY_LOG_CSV_LINE_SIZE];
+    size_t csvLength;
+    bool csvFirstLine;
+    bool csvOverflow;
+    bool csvAppendUptime;
+
+    // Output (buffer tetap + deduplikasi)
+    File output;
+    uint8_t buffer[LOG_EXPORT_BUFFER_SIZE];
+    size_t used;
+    bool writeError;
+    char lastTimestamp[WIB_TIMESTAMP_SIZE];
+    char previousLine[BINARY_LOG_CSV_LINE_SIZE];
+    uint32_t rows;
+    uint32_t duplicates;
+    uint32_t bytes;
+
+    size_t scanDays(bool& truncated);
+    void openDay();
+    void closeDay();
+    int readSource(uint8_t* out, size_t size);
+    void exportBinaryBlock();
+    void exportCsvChunk(size_t length);
+    void writeBytes(const char* data, size_t length);
+    void flushOutput();
+    void writeRow(const char* line);
+    void finish();
+
+public:
+    LogExporter();
+
+    /**
+     * @brief Scan log harian dan buat exportPath (ditimpa)
+     * @return false jika file export tidak bisa dibuat
+     */
+    bool start(const char* exportPath);
+
+    /**
+     * @brief Proses satu potongan; true selama export belum selesai
+     */
+    bool step();
+
+    /**
+     * @brief Batalkan export (file export yang belum lengkap dibiarkan)
+     */
+    void abort();
+
+    bool isRunning() const { return state != IDLE; }
+    bool getLastResult() const { return lastResult; }
+};
+
+#endif // LOG_EXPORT_H
@@ -0,0 +1,175 @@
+#include "log_retention.h"
+#include <string.h>
+#include <stdio.h>
+#include "sd_utils.h"
+#include "log_compress.h"
+#include "../Telemetry/telemetry_json.h"
+
+// Urutan sama dengan LogFileKind
+static const char* const RETENTION_EXTENSIONS[LOG_FILE_KIND_COUNT] = {
+    ".csv", ".bin", ".csv" LOG_COMPRESS_EXTENSION, ".bin" LOG_COMPRESS_EXTENSION
+};
+
+LogRetention::LogRetention() {
+    state = IDLE;
+    entryCount = 0;
+    deleteIndex = 0;
+    newestDay = 0;
+    purging = false;
+    lastPassMs = 0;
+    hasRun = false;
+    filesDeleted = 0;
+}
+
+bool LogRetention::parseLogFileName(const char* name, uint32_t& day, uint8_t& extension) {
+    const char* base = strrchr(name, '/');
+    base = base ? base + 1 : name;
+
+    // DAILY_LOG_PREFIX tanpa '/' di depan
+    const char* prefix = DAILY_LOG_PREFIX + 1;
+    size_t prefixLength = strlen(prefix);
+    if (strncmp(base, prefix, prefixLength) != 0) return false;
+
+    int year, month, date, consumed = 0;
+    if (sscanf(base + prefixLength, "%4d-%2d-%2d%n", &year, &month, &date, &consumed) != 3 ||
+        consumed != 10 || year < 2000 || month < 1 || month > 12 || date < 1 || date > 31) {
+        return false;
+    }
+
+    const char* suffix = base + prefixLength + consumed;
+    for (uint8_t i = 0; i < LOG_FILE_KIND_COUNT; i++) {
+        if (strcmp(suffix, RETENTION_EXTENSIONS[i]) == 0) {
+            struct tm tm = {0};
+            tm.tm_year = year - 1900;
+            tm.tm_mon = month - 1;
+            tm.tm_mday = date;
+            day = (uint32_t)(timegm_custom(&tm) / 86400);
+            extension = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* LogRetention::getExtension(uint8_t extension) {
+    return extension < LOG_FILE_KIND_COUNT ? RETENTION_EXTENSIONS[extension] : "";
+}
+
+uint8_t LogRetention::freeSpacePercent() {
+    uint64_t total = SD.totalBytes();
+    if (total == 0) return 100;  // Tidak diketahui - jangan hapus karena space
+    uint64_t used = SD.usedBytes();
+    if (used >= total) return 0;
+    return (uint8_t)((total - used) * 100 / total);
+}
+
+// Simpan urut tanggal; jika penuh, entri terbaru dibuang (dihapus paling akhir, ikut pass berikutnya)
+void LogRetention::insertEntry(uint32_t day, uint8_t extension) {
+    size_t position = entryCount;
+    while (position > 0 && entries[position - 1].day > day) position--;
+
+    if (entryCount == LOG_RETENTION_MAX_FILES) {
+        if (position == entryCount) return;
+        entryCount--;
+    }
+
+    memmove(&entries[position + 1], &entries[position], (entryCount - position) * sizeof(RetentionEntry));
+    entries[position].day = day;
+    entries[position].extension = extension;
+    entryCount++;
+}
+
+// =======================================================
+//   PASS: SCAN -> DELETE
+// =======================================================
+
+void LogRetention::startScan() {
+    dir = SD.open("/");
+    if (!dir || !dir.isDirectory()) {
+        if (dir) dir.close();
+        lastPassMs = millis();
+        return;
+    }
+
+    entryCount = 0;
+    deleteIndex = 0;
+    newestDay = 0;
+    state = SCANNING;
+}
+
+void LogRetention::scanStep() {
+    for (size_t n = 0; n < LOG_RETENTION_FILES_PER_TICK; n++) {
+        File entry = dir.openNextFile();
+        if (!entry) {
+            dir.close();
+            state = DELETING;
+            return;
+        }
+
+        uint32_t day;
+        uint8_t extension;
+        if (!entry.isDirectory() && parseLogFileName(entry.name(), day, extension)) {
+            insertEntry(day, extension);
+            if (day > newestDay) newestDay = day;
+        }
+        entry.close();
+    }
+}
+
+void LogRetention::deleteStep(int daysToKeep) {
+    // Tanpa jam sistem, tanggal log terbaru dianggap hari ini
+    time_t now;
+    uint32_t today = system_clock_epoch(now) ? (uint32_t)(now / 86400) : newestDay;
+
+    for (size_t n = 0; n < LOG_RETENTION_FILES_PER_TICK; n++) {
+        const RetentionEntry* entry = deleteIndex < entryCount ? &entries[deleteIndex] : NULL;
+
+        // Log hari ini / terbaru sedang ditulis - tidak pernah dihapus
+        bool done = entry == NULL || entry->day >= today || entry->day >= newestDay;
+        if (!done) {
+            uint8_t freePercent = freeSpacePercent();
+            if (freePercent < LOG_RETENTION_LOW_FREE_PERCENT) purging = true;
+            if (freePercent >= LOG_RETENTION_HIGH_FREE_PERCENT) purging = false;
+
+            bool expired = daysToKeep > 0 && today - entry->day > (uint32_t)daysToKeep;
+            done = !expired && !purging;  // Urut tertua dulu - sisanya juga belum perlu dihapus
+        }
+
+        if (done) {
+            state = IDLE;
+            lastPassMs = millis();
+            return;
+        }
+
+        time_t dayStart = (time_t)entry->day * 86400;
+        struct tm tm;
+        gmtime_r(&dayStart, &tm);
+        String path = generateLogFileName(tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+                                          RETENTION_EXTENSIONS[entry->extension]);
+        if (SD.remove(path.c_str())) {
+            filesDeleted++;
+            Serial.print("🧹 Deleted old log ");
+            Serial.println(path);
+        } else {
+            Serial.print("⚠️ Cannot delete old log ");
+            Serial.println(path);
+        }
+        deleteIndex++;
+    }
+}
+
+void LogRetention::tick(int daysToKeep) {
+    switch (state) {
+        case IDLE:
+            if (hasRun && millis() - lastPassMs < LOG_RETENTION_INTERVAL) return;
+            hasRun = true;
+            startScan();
+            break;
+        case SCANNING:
+            scanStep();
+            break;
+        case DELETING:
+            deleteStep(daysToKeep);
+            break;
+    }
+}
@@ -0,0 +1,84 @@
+#ifndef LOG_RETENTION_H
+#define LOG_RETENTION_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include "FS.h"
+#include "../include/config.h"
+
+// =======================================================
+//   LOG RETENTION
+//   Log harian /vatlog_YYYY-MM-DD.<ext> (termasuk hasil kompresi .lzs) dihapus
+//   dari yang tertua jika umurnya melebihi daysToKeep, atau selama free space
+//   di bawah watermark.
+//   Satu pass = scan direktori root lalu hapus, dikerjakan bertahap
+//   (LOG_RETENTION_FILES_PER_TICK entri per tick) agar task storage tidak terblokir.
+// =======================================================
+
+// Jenis file log harian (index ekstensi hasil parseLogFileName)
+enum LogFileKind {
+    LOG_FILE_CSV = 0,           // .csv
+    LOG_FILE_BIN,               // .bin
+    LOG_FILE_CSV_LZS,           // .csv.lzs
+    LOG_FILE_BIN_LZS,           // .bin.lzs
+    LOG_FILE_KIND_COUNT
+};
+
+struct RetentionEntry {
+    uint32_t day;               // Hari sejak 1970-01-01 (dari nama file)
+    uint8_t extension;          // LogFileKind
+};
+
+/**
+ * @brief Mesin retensi log harian yang berjalan sedikit demi sedikit
+ *
+ * Panggil tick() secara berkala dari task yang sama dengan penulis log.
+ * File dengan tanggal hari ini (atau file terbaru jika jam belum sinkron)
+ * tidak pernah dihapus.
+ */
+class LogRetention {
+private:
+    enum State { IDLE, SCANNING, DELETING };
+
+    State state;
+    File dir;
+    RetentionEntry entries[LOG_RETENTION_MAX_FILES];   // Urut dari tanggal tertua
+    size_t entryCount;
+    size_t deleteIndex;
+    uint32_t newestDay;         // Tanggal terbaru yang terlihat saat scan (termasuk yang tidak muat)
+    bool purging;               // Sedang hapus karena free space (hysteresis low/high watermark)
+    unsigned long lastPassMs;
+    bool hasRun;
+    uint32_t filesDeleted;
+
+    void startScan();
+    void scanStep();
+    void deleteStep(int daysToKeep);
+    void insertEntry(uint32_t day, uint8_t extension);
+    uint8_t freeSpacePercent();
+
+public:
+    LogRetention();
+
+    /**
+     * @brief Kerjakan satu langkah kecil (buka pass baru setiap LOG_RETENTION_INTERVAL)
+     * @param daysToKeep Umur maksimal log dalam hari
+     */
+    void tick(int daysToKeep);
+
+    /**
+     * @brief Parse nama file log harian ("vatlog_2025-01-15.bin" atau dengan path)
+     * @return true jika nama cocok; day = hari sejak 1970, extension = index ekstensi
+     */
+    static bool parseLogFileName(const char* name, uint32_t& day, uint8_t& extension);
+
+    /**
+     * @brief Ekstensi file untuk LogFileKind (".csv", ".bin.lzs", ...)
+     */
+    static const char* getExtension(uint8_t extension);
+
+    bool isRunning() const { return state != IDLE; }
+    uint32_t getFilesDeleted() const { return filesDeleted; }
+};
+
+#endif // LOG_RETENTION_H
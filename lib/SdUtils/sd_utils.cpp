@@ -1,9 +1,48 @@
 #include "sd_utils.h"
-#include <ArduinoJson.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "crc32.h"
+#include "../Telemetry/telemetry_json.h"
 
 // Global flag untuk status SD Card
 bool isSdCardOk = false;
 
+// Antrean offline (segmen di /queue), dibuka oleh initSdCard()
+static SegmentedQueue offlineQueue;
+static LogRetention logRetention;
+static LogCompressor logCompressor;
+static LogExporter logExporter;
+static uint32_t compressCheckedDay = 0;   // Hari (sejak 1970) yang semua log lamanya sudah dicek
+
+// Laju drain antrean (record/detik, EWMA) dari selang peek -> ack
+static unsigned long lastPeekMs = 0;
+static float drainRecordsPerSecond = 0;
+
+// Cache timestamp record tertua, berlaku selama head antrean tidak berubah
+static uint32_t oldestCacheSegment = 0xFFFFFFFFUL;
+static uint32_t oldestCacheOffset = 0;
+static char oldestCacheTimestamp[WIB_TIMESTAMP_SIZE] = "";
+
+// Clock SPI hasil negosiasi (0 = belum mount) dan berapa kali diturunkan
+static uint32_t sdBusFrequency = 0;
+static uint32_t sdBusDowngrades = 0;
+
+#define SD_BUS_PROBE_FILE "/sdbus_probe.tmp"
+
+// Entry point di file ini dipanggil dari task storage, task network dan loop (serial command).
+// SegmentedQueue, LogRetention, LogCompressor, LogExporter, log harian dan cache di atas tidak thread-safe -
+// satu mutex rekursif (entry point saling memanggil) melindungi semuanya. Dibuat oleh initSdCard()
+// sebelum task pipeline berjalan.
+static SemaphoreHandle_t sdMutex = NULL;
+
+class SdLock {
+public:
+    SdLock() { if (sdMutex) xSemaphoreTakeRecursive(sdMutex, portMAX_DELAY); }
+    ~SdLock() { if (sdMutex) xSemaphoreGiveRecursive(sdMutex); }
+};
+
+static void closeLogFiles();
+
 // =======================================================
 //   FUNGSI KUSTOM timegm
 // =======================================================
@@ -31,11 +70,94 @@ time_t timegm_custom(struct tm *tm) {
     return (days * 86400L) + (tm->tm_hour * 3600L) + (tm->tm_min * 60L) + tm->tm_sec;
 }
 
+// =======================================================
+//   SD BUS NEGOTIATION
+// =======================================================
+
+// Langkah negosiasi berikutnya: setengah clock, tidak di bawah SD_SPI_MIN_FREQUENCY (0 = habis)
+static uint32_t lowerSdFrequency(uint32_t frequency) {
+    if (frequency <= SD_SPI_MIN_FREQUENCY) return 0;
+    return frequency / 2 > SD_SPI_MIN_FREQUENCY ? frequency / 2 : SD_SPI_MIN_FREQUENCY;
+}
+
+static void fillProbeBlock(uint8_t* block, size_t size, size_t offset) {
+    for (size_t i = 0; i < size; i++) {
+        size_t position = offset + i;
+        block[i] = (uint8_t)(position * 167 + (position >> 8));
+    }
+}
+
+// Clock yang terlalu tinggi untuk kartu/kabel sering lolos mount tetapi merusak
+// transfer sektor beruntun - tulis pola beberapa sektor lalu bandingkan CRC hasil baca
+static bool probeSdBus() {
+    uint8_t block[512];
+    uint32_t writtenCrc = 0;
+    uint32_t readCrc = 0;
+
+    File file = SD.open(SD_BUS_PROBE_FILE, FILE_WRITE);
+    if (!file) return false;
+    bool ok = true;
+    for (size_t offset = 0; offset < SD_BUS_PROBE_BYTES && ok; offset += sizeof(block)) {
+        fillProbeBlock(block, sizeof(block), offset);
+        writtenCrc = crc32Compute(block, sizeof(block), writtenCrc);
+        ok = file.write(block, sizeof(block)) == sizeof(block);
+    }
+    file.close();
+
+    if (ok) {
+        file = SD.open(SD_BUS_PROBE_FILE, FILE_READ);
+        ok = (bool)file;
+        for (size_t offset = 0; offset < SD_BUS_PROBE_BYTES && ok; offset += sizeof(block)) {
+            ok = file.read(block, sizeof(block)) == sizeof(block);
+            readCrc = crc32Compute(block, sizeof(block), readCrc);
+        }
+        if (file) file.close();
+    }
+    SD.remove(SD_BUS_PROBE_FILE);
+    return ok && readCrc == writtenCrc;
+}
+
+static bool mountSdBus(uint32_t frequency) {
+    SD.end();
+    if (!SD.begin(SD_CS, SPI, frequency, "/sd", SD_MAX_OPEN_FILES)) return false;
+    if (probeSdBus()) return true;
+    SD.end();
+    return false;
+}
+
+// Mount ulang mulai dari clock di bawah clock sekarang
+static bool renegotiateSdBus() {
+    closeLogFiles();
+    for (uint32_t frequency = lowerSdFrequency(sdBusFrequency); frequency != 0;
+         frequency = lowerSdFrequency(frequency)) {
+        sdBusDowngrades++;
+        Serial.printf("⚠️ Remounting SD Card at %.1f MHz...\n", frequency / 1e6f);
+        if (mountSdBus(frequency)) {
+            sdBusFrequency = frequency;
+            isSdCardOk = true;
+            Serial.println("✅ SD Card OK at lower clock");
+            return true;
+        }
+    }
+    Serial.println("❌ SD Card failed at every clock");
+    SD.end();
+    sdBusFrequency = 0;
+    isSdCardOk = false;
+    return false;
+}
+
+uint32_t getSdBusFrequency() {
+    return sdBusFrequency;
+}
+
 // =======================================================
 //   CORE SD CARD FUNCTIONS
 // =======================================================
 
 bool initSdCard() {
+    if (sdMutex == NULL) sdMutex = xSemaphoreCreateRecursiveMutex();
+    SdLock lock;
+    
     Serial.println("💾 Initializing SD Card...");
     Serial.print("  SD_CS pin: ");
     Serial.println(SD_CS);
@@ -47,8 +169,20 @@ bool initSdCard() {
     Serial.println(SD_SCLK);
     
     SPI.begin(SD_SCLK, SD_MISO, SD_MOSI, SD_CS);
+    closeLogFiles();
+    
+    // Negosiasi clock: mulai dari SD_SPI_MAX_FREQUENCY, turun jika mount / uji tulis-baca gagal
+    sdBusFrequency = 0;
+    for (uint32_t frequency = SD_SPI_MAX_FREQUENCY; frequency != 0; frequency = lowerSdFrequency(frequency)) {
+        if (mountSdBus(frequency)) {
+            sdBusFrequency = frequency;
+            break;
+        }
+        Serial.printf("⚠️ SD mount/verify failed at %.1f MHz - lowering clock\n", frequency / 1e6f);
+        sdBusDowngrades++;
+    }
     
-    if (!SD.begin(SD_CS)) {
+    if (sdBusFrequency == 0) {
         Serial.println("❌ FATAL: SD Card Mount Failed!");
         Serial.println("  Possible causes:");
         Serial.println("  - No SD card inserted");
@@ -60,7 +194,7 @@ bool initSdCard() {
         return false;
     }
     
-    Serial.println("✅ SD Card mounted successfully!");
+    Serial.printf("✅ SD Card mounted successfully at %.1f MHz!\n", sdBusFrequency / 1e6f);
     
     // Test SD card properties
     uint64_t cardSize = SD.cardSize() / (1024 * 1024);
@@ -81,20 +215,19 @@ bool initSdCard() {
     Serial.println(" MB");
     
     isSdCardOk = true;
+    
+    if (!offlineQueue.begin()) {
+        Serial.println("⚠️ Offline queue unavailable");
+    }
     return true;
 }
 
-bool checkSdCardStatus() {
-    if (!isSdCardOk) {
-        Serial.println("❌ SD Card not initialized");
-        return false;
-    }
-    
+// Uji tulis-baca file kecil
+static bool testSdCardReadWrite() {
     // Test write operation
     File testFile = SD.open("/test_write.tmp", FILE_WRITE);
     if (!testFile) {
         Serial.println("❌ SD Card write test failed");
-        isSdCardOk = false;
         return false;
     }
     
@@ -105,7 +238,6 @@ bool checkSdCardStatus() {
     testFile = SD.open("/test_write.tmp", FILE_READ);
     if (!testFile) {
         Serial.println("❌ SD Card read test failed");
-        isSdCardOk = false;
         return false;
     }
     
@@ -115,7 +247,20 @@ bool checkSdCardStatus() {
     
     if (testContent.indexOf("test") == -1) {
         Serial.println("❌ SD Card data integrity test failed");
-        isSdCardOk = false;
+        return false;
+    }
+    return true;
+}
+
+bool checkSdCardStatus() {
+    SdLock lock;
+    if (!isSdCardOk) {
+        Serial.println("❌ SD Card not initialized");
+        return false;
+    }
+    
+    // Error transfer biasanya karena clock terlalu tinggi - coba clock lebih rendah dulu
+    if (!testSdCardReadWrite() && !renegotiateSdBus()) {
         return false;
     }
     
@@ -138,6 +283,7 @@ bool formatSdCard() {
 // =======================================================
 
 void createCsvHeader(const char* filePath) {
+    SdLock lock;
     if (!isSdCardOk) return;
     
     File file = SD.open(filePath, FILE_READ);
@@ -159,13 +305,46 @@ void createCsvHeader(const char* filePath) {
     }
 }
 
-String generateLogFileName(int year, int month, int day) {
+String generateLogFileName(int year, int month, int day, const char* extension) {
     char fileName[30];
-    sprintf(fileName, "/vatlog_%04d-%02d-%02d.csv", year, month, day);
+    snprintf(fileName, sizeof(fileName), DAILY_LOG_PREFIX "%04d-%02d-%02d%s", year, month, day, extension);
     return String(fileName);
 }
 
+#if DAILY_LOG_FORMAT == DAILY_LOG_FORMAT_BINARY
+
+// File log tetap terbuka di antara sampel; hanya diakses dari task storage
+static BinaryLogWriter dailyLog;
+
+static void closeLogFiles() {
+    dailyLog.close();
+    logCompressor.abort();
+    logExporter.abort();
+}
+
+void writeToDailyLog(const VatSensorData& data) {
+    SdLock lock;
+    if (!isSdCardOk) {
+        Serial.println("⚠️ SD Card not available - data not logged");
+        return;
+    }
+    
+    if (!dailyLog.append(data)) {
+        Serial.println("❌ ERROR: Writing to daily log failed!");
+        // Uji baca/tulis, turunkan clock SPI bila bus bermasalah
+        checkSdCardStatus();
+    }
+}
+
+#else
+
+static void closeLogFiles() {
+    logCompressor.abort();
+    logExporter.abort();
+}
+
 void writeToDailyLog(const VatSensorData& data) {
+    SdLock lock;
     if (!isSdCardOk || !data.isValid) {
         if (!isSdCardOk) {
             Serial.println("⚠️ SD Card not available - data not logged");
@@ -183,6 +362,7 @@ void writeToDailyLog(const VatSensorData& data) {
     File file = SD.open(logFileName.c_str(), FILE_APPEND);
     if (!file) {
         Serial.println("❌ Failed to open daily log for appending");
+        checkSdCardStatus();
         return;
     }
     
@@ -204,133 +384,77 @@ void writeToDailyLog(const VatSensorData& data) {
              data.hdop);
     
     // Write to file
-    if (file.println(csvLine) == 0) {
+    bool written = file.println(csvLine) != 0;
+    file.close();
+    
+    if (!written) {
         Serial.println("❌ ERROR: Writing to daily log failed!");
+        // Uji baca/tulis, turunkan clock SPI bila bus bermasalah
+        checkSdCardStatus();
     } else {
         Serial.println("💾 Data logged to daily CSV");
     }
-    
-    file.close();
 }
 
-// =======================================================
-//   OFFLINE QUEUE FUNCTIONS
-// =======================================================
+#endif
 
-unsigned long readProgress() {
-    if (!isSdCardOk) return 0;
-    
-    File file = SD.open(PROGRESS_FILE, FILE_READ);
-    if (file) {
-        unsigned long pos = file.readString().toInt();
-        file.close();
-        return pos;
-    }
-    return 0;
+bool exportDailyLogToCsv(int year, int month, int day) {
+    SdLock lock;
+    String binPath = generateLogFileName(year, month, day, BINARY_LOG_EXTENSION);
+    String csvPath = generateLogFileName(year, month, day);
+    return exportBinaryLogToCsv(binPath.c_str(), csvPath.c_str());
 }
 
-void writeProgress(unsigned long position) {
-    if (!isSdCardOk) return;
-    
-    File file = SD.open(PROGRESS_FILE, FILE_WRITE);
-    if (file) {
-        file.print(position);
-        file.close();
-    } else {
-        Serial.println("❌ ERROR: Failed to write progress file!");
-    }
-}
+// =======================================================
+//   OFFLINE QUEUE FUNCTIONS
+// =======================================================
 
 bool isOfflineQueueNotEmpty() {
+    SdLock lock;
     if (!isSdCardOk) return false;
-    
-    if (!SD.exists(QUEUE_FILE)) {
-        return false;
-    }
-    
-    File file = SD.open(QUEUE_FILE, FILE_READ);
-    if (file) {
-        bool hasContent = file.size() > readProgress();
-        file.close();
-        return hasContent;
-    }
-    
-    return false;
+    return !offlineQueue.isEmpty();
 }
 
 void addToOfflineQueue(const char* payload) {
+    SdLock lock;
     if (!isSdCardOk) {
         Serial.println("⚠️ Cannot add to offline queue - SD Card not available");
         return;
     }
     
-    File file = SD.open(QUEUE_FILE, FILE_APPEND);
-    if (!file) {
-        Serial.println("❌ Failed to open offline_queue.txt for writing");
-        return;
-    }
-    
-    if (file.println(payload) == 0) {
-        Serial.println("❌ ERROR: Failed to write to offline queue!");
-    } else {
+    if (offlineQueue.enqueue(payload, strlen(payload))) {
         Serial.println("📝 Data added to offline queue");
     }
-    
-    file.close();
 }
 
-String readNextLineFromQueue() {
-    if (!isSdCardOk) return "";
-    
-    File file = SD.open(QUEUE_FILE, FILE_READ);
-    if (!file) {
-        Serial.println("❌ Cannot open queue file for reading");
-        return "";
-    }
-    
-    unsigned long currentPos = readProgress();
-    if (currentPos >= file.size()) {
-        Serial.println("✅ Queue is fully synced. Cleaning up files.");
-        file.close();
-        clearOfflineQueue();
-        return "";
-    }
-    
-    file.seek(currentPos);
-    String line = file.readStringUntil('\n');
-    line.trim();
-    
-    // Save new position for next attempt
-    writeProgress(file.position());
-    
-    file.close();
-    return line;
+size_t peekOfflineQueue(size_t maxRecords, char* buffer, size_t size,
+                        const char** records, size_t* lengths) {
+    SdLock lock;
+    if (!isSdCardOk) return 0;
+    lastPeekMs = millis();
+    return offlineQueue.peek(maxRecords, buffer, size, records, lengths);
 }
 
-void revertProgress(const String& line) {
-    if (!isSdCardOk) return;
-    
-    unsigned long currentPos = readProgress();
-    // Calculate position before reading this line (add 2 for \r\n)
-    unsigned long previousPos = currentPos > (line.length() + 2) ? 
-                               currentPos - (line.length() + 2) : 0;
-    
-    writeProgress(previousPos);
-    Serial.println("↩️ Progress reverted due to send failure");
+bool ackOfflineQueue(size_t count) {
+    SdLock lock;
+    if (!isSdCardOk) return false;
+
+    unsigned long elapsed = millis() - lastPeekMs;
+    if (count > 0 && elapsed > 0) {
+        float rate = count * 1000.0f / elapsed;
+        drainRecordsPerSecond = drainRecordsPerSecond > 0
+                                ? drainRecordsPerSecond * 0.7f + rate * 0.3f
+                                : rate;
+    }
+    return offlineQueue.ack(count);
 }
 
 void clearOfflineQueue() {
+    SdLock lock;
     if (!isSdCardOk) return;
     
-    if (SD.exists(QUEUE_FILE)) {
-        SD.remove(QUEUE_FILE);
-        Serial.println("🗑️ Offline queue file cleared");
-    }
-    
-    if (SD.exists(PROGRESS_FILE)) {
-        SD.remove(PROGRESS_FILE);
-        Serial.println("🗑️ Progress file cleared");
-    }
+    offlineQueue.clear();
+    Serial.println("🗑️ Offline queue cleared");
 }
 
 // =======================================================
@@ -338,78 +462,108 @@ void clearOfflineQueue() {
 // =======================================================
 
 String sensorDataToJson(const VatSensorData& data) {
-    DynamicJsonDocument doc(1024);
-    
-    doc["device_id"] = DEVICE_ID;
-    doc["data"]["distance1"] = round(data.distance1 * 10) / 10.0;
-    doc["data"]["distance2"] = round(data.distance2 * 10) / 10.0;
-    doc["data"]["latitude"] = data.latitude;
-    doc["data"]["longitude"] = data.longitude;
-    doc["data"]["depth"] = round(data.depth * 10) / 10.0;
-    doc["timestamp"] = getWibTimestamp(data);
-    
-    String jsonString;
-    serializeJson(doc, jsonString);
-    return jsonString;
+    char json[PRODUCTION_JSON_MAX_SIZE];
+    encode_production_json(data, DEVICE_ID, NULL, json, sizeof(json));
+    return String(json);
 }
 
 String getWibTimestamp(const VatSensorData& data) {
-    struct tm utc_tm = {0};
-    utc_tm.tm_year = data.year - 1900;
-    utc_tm.tm_mon = data.month - 1;
-    utc_tm.tm_mday = data.day;
-    utc_tm.tm_hour = data.hour;
-    utc_tm.tm_min = data.minute;
-    utc_tm.tm_sec = data.second;
-    
-    time_t utc_time = timegm_custom(&utc_tm);
-    time_t wib_time = utc_time + (7 * 3600); // UTC+7
-    struct tm* wib_tm_ptr = gmtime(&wib_time);
-    
-    char wibTimestampStr[30];
-    strftime(wibTimestampStr, sizeof(wibTimestampStr), 
-             "%Y-%m-%dT%H:%M:%S+07:00", wib_tm_ptr);
-    
-    return String(wibTimestampStr);
+    // Sampel tanpa waktu GPS memakai jam sistem (kosong jika belum sinkron)
+    char timestamp[WIB_TIMESTAMP_SIZE];
+    if (format_wib_timestamp(data, timestamp, sizeof(timestamp)) == 0 &&
+        format_wib_timestamp_now(timestamp, sizeof(timestamp)) == 0) {
+        timestamp[0] = '\0';
+    }
+    return String(timestamp);
 }
 
 size_t getQueueFileSize() {
-    if (!isSdCardOk || !SD.exists(QUEUE_FILE)) return 0;
-    
-    File file = SD.open(QUEUE_FILE, FILE_READ);
-    if (file) {
-        size_t size = file.size();
-        file.close();
-        return size;
-    }
-    return 0;
+    SdLock lock;
+    if (!isSdCardOk) return 0;
+    return offlineQueue.pendingBytes();
 }
 
 int getQueueLineCount() {
-    if (!isSdCardOk || !SD.exists(QUEUE_FILE)) return 0;
-    
-    File file = SD.open(QUEUE_FILE, FILE_READ);
-    if (!file) return 0;
-    
-    int lineCount = 0;
-    unsigned long progressPos = readProgress();
-    
-    // Skip to progress position
-    file.seek(progressPos);
-    
-    // Count remaining lines
-    while (file.available()) {
-        String line = file.readStringUntil('\n');
-        if (line.length() > 0) {
-            lineCount++;
+    SdLock lock;
+    if (!isSdCardOk) return 0;
+    return (int)offlineQueue.pendingRecords();
+}
+
+bool getOldestPendingTimestamp(char* out, size_t size) {
+    SdLock lock;
+    if (!isSdCardOk || size == 0 || offlineQueue.isEmpty()) return false;
+
+    // Hanya baca SD saat head berpindah (setelah ack)
+    if (offlineQueue.getHeadSegment() != oldestCacheSegment ||
+        offlineQueue.getHeadOffset() != oldestCacheOffset) {
+        char record[QUEUE_RECORD_MAX_SIZE + 2];
+        oldestCacheTimestamp[0] = '\0';
+
+        if (offlineQueue.readHead(record, sizeof(record)) > 0) {
+            const char* key = strstr(record, "\"timestamp\":\"");
+            if (key != NULL) {
+                key += strlen("\"timestamp\":\"");
+                const char* end = strchr(key, '"');
+                size_t length = end ? (size_t)(end - key) : 0;
+                if (length > 0 && length < sizeof(oldestCacheTimestamp)) {
+                    memcpy(oldestCacheTimestamp, key, length);
+                    oldestCacheTimestamp[length] = '\0';
+                }
+            }
         }
+        oldestCacheSegment = offlineQueue.getHeadSegment();
+        oldestCacheOffset = offlineQueue.getHeadOffset();
+    }
+
+    if (oldestCacheTimestamp[0] == '\0') return false;
+    snprintf(out, size, "%s", oldestCacheTimestamp);
+    return true;
+}
+
+long estimateQueueDrainSeconds() {
+    SdLock lock;
+    if (!isSdCardOk) return -1;
+    uint32_t pending = offlineQueue.pendingRecords();
+    if (pending == 0) return 0;
+    if (drainRecordsPerSecond <= 0) return -1;
+    return (long)(pending / drainRecordsPerSecond + 0.5f);
+}
+
+void printOfflineQueueStats() {
+    SdLock lock;
+    Serial.println("\n📋 OFFLINE QUEUE:");
+    if (!isSdCardOk) {
+        Serial.println("❌ SD Card not available");
+        return;
+    }
+
+    Serial.print("📋 Segments: ");
+    Serial.print(offlineQueue.getHeadSegment());
+    Serial.print("..");
+    Serial.println(offlineQueue.getTailSegment());
+    Serial.print("📝 Pending Records: ");
+    Serial.println(offlineQueue.pendingRecords());
+    Serial.print("📦 Pending Bytes: ");
+    Serial.println(offlineQueue.pendingBytes());
+
+    char oldest[WIB_TIMESTAMP_SIZE];
+    Serial.print("🕒 Oldest Pending: ");
+    Serial.println(getOldestPendingTimestamp(oldest, sizeof(oldest)) ? oldest : "-");
+
+    long drainSeconds = estimateQueueDrainSeconds();
+    Serial.print("⏱️ Est. Drain Time: ");
+    if (drainSeconds < 0) {
+        Serial.println("unknown (no drain yet)");
+    } else {
+        Serial.print(drainSeconds);
+        Serial.print(" s (");
+        Serial.print(drainRecordsPerSecond, 2);
+        Serial.println(" rec/s)");
     }
-    
-    file.close();
-    return lineCount;
 }
 
 void printSdCardStats() {
+    SdLock lock;
     Serial.println("\n📊 SD CARD STATISTICS:");
     Serial.println("========================================");
     
@@ -435,30 +589,26 @@ void printSdCardStats() {
     Serial.print("🆓 Free Space: ");
     Serial.print(totalBytes - usedBytes);
     Serial.println(" MB");
+    Serial.printf("⚡ SPI Clock: %.1f MHz (max %.1f MHz, %lu downgrades)\n",
+                  sdBusFrequency / 1e6f, SD_SPI_MAX_FREQUENCY / 1e6f, (unsigned long)sdBusDowngrades);
     
     // Queue info
-    Serial.print("📋 Queue File Size: ");
-    Serial.print(getQueueFileSize());
-    Serial.println(" bytes");
-    Serial.print("📝 Pending Lines: ");
-    Serial.println(getQueueLineCount());
-    
-    // Progress info
-    Serial.print("🎯 Sync Progress: ");
-    Serial.println(readProgress());
+    printOfflineQueueStats();
     
     Serial.println("========================================");
 }
 
 void backupCriticalData(const VatSensorData& data) {
+    SdLock lock;
     if (!isSdCardOk) return;
     
     // Primary log
     writeToDailyLog(data);
     
-    // Backup to queue for API sync
-    String jsonPayload = sensorDataToJson(data);
-    addToOfflineQueue(jsonPayload.c_str());
+    // Backup to queue for API sync (production schema)
+    char jsonPayload[PRODUCTION_JSON_MAX_SIZE];
+    encode_production_json(data, DEVICE_ID, NULL, jsonPayload, sizeof(jsonPayload));
+    addToOfflineQueue(jsonPayload);
     
     // Critical backup file (overwrites - keeps only latest)
     File criticalFile = SD.open("/critical_backup.json", FILE_WRITE);
@@ -473,40 +623,72 @@ void backupCriticalData(const VatSensorData& data) {
 // =======================================================
 
 void cleanupOldLogs(int daysToKeep) {
-    if (!isSdCardOk) return;
-    
-    Serial.print("🧹 Cleaning up logs older than ");
-    Serial.print(daysToKeep);
-    Serial.println(" days...");
-    
-    // Get current time
-    time_t now = millis() / 1000; // Simplified - should use RTC
-    time_t cutoffTime = now - (daysToKeep * 24 * 3600);
-    
-    // TODO: Implement file enumeration and cleanup
-    // This would require iterating through files and checking dates
-    
-    Serial.println("✅ Log cleanup completed");
+    SdLock lock;
+    // Ditunda selama export - log yang sedang/akan dibaca tidak boleh dihapus
+    if (!isSdCardOk || logExporter.isRunning()) return;
+    logRetention.tick(daysToKeep);
 }
 
 bool compressLogFile(const char* filePath) {
-    // TODO: Implement compression algorithm
-    // Could use simple RLE or LZ compression
-    Serial.print("🗜️ Compressing file: ");
-    Serial.println(filePath);
-    
-    // Placeholder
-    return false;
+    SdLock lock;
+    if (!isSdCardOk) return false;
+    if (!logCompressor.start(filePath)) return false;
+
+    while (logCompressor.step()) {
+        yield();
+    }
+    return logCompressor.getLastResult();
+}
+
+void compressClosedLogs(const VatSensorData& latest) {
+    SdLock lock;
+    // Ditunda selama export - kompresi mengganti file log yang diindeks export
+    if (!isSdCardOk || logExporter.isRunning()) return;
+
+    if (logCompressor.isRunning()) {
+        if (!logCompressor.step() && !logCompressor.getLastResult()) {
+            // Gagal - coba lagi besok agar tidak mengulang file yang sama terus
+            compressCheckedDay = 0xFFFFFFFFUL;
+        }
+        return;
+    }
+
+    time_t now;
+    if (!sample_utc_epoch(latest, now)) return;
+    uint32_t today = now / 86400;
+    if (compressCheckedDay == 0xFFFFFFFFUL) compressCheckedDay = today;
+    if (today == compressCheckedDay) return;
+
+    static const char* const extensions[] = {".bin", ".csv"};
+    for (int back = 1; back <= LOG_COMPRESS_LOOKBACK_DAYS; back++) {
+        time_t dayStart = now - (time_t)back * 86400;
+        struct tm tm;
+        gmtime_r(&dayStart, &tm);
+        for (size_t i = 0; i < sizeof(extensions) / sizeof(extensions[0]); i++) {
+            String path = generateLogFileName(tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, extensions[i]);
+            if (SD.exists(path.c_str())) {
+                logCompressor.start(path.c_str());
+                return;
+            }
+        }
+    }
+    compressCheckedDay = today;
 }
 
 bool exportAllData(const char* exportPath) {
-    if (!isSdCardOk) return false;
-    
-    Serial.print("📤 Exporting all data to: ");
-    Serial.println(exportPath);
-    
-    // TODO: Implement data export
-    // Combine all CSV files into single export file
+    {
+        SdLock lock;
+        if (!isSdCardOk || !logExporter.start(exportPath)) return false;
+    }
     
-    return false;
+    // Lock dilepas antar langkah agar task storage tetap bisa menulis log harian
+    bool running = true;
+    while (running) {
+        {
+            SdLock lock;
+            running = logExporter.step();
+        }
+        delay(1);
+    }
+    return logExporter.getLastResult();
 }
@@ -9,33 +9,23 @@
 
 // Include unified config file
 #include "../include/config.h"
-
-// File definitions untuk queue system
-#define QUEUE_FILE "/offline_queue.txt"
-#define PROGRESS_FILE "/queue_progress.txt"
+#include "../VatSensor/vat_sensor_data.h"
+#include "binary_log.h"
+#include "log_compress.h"
+#include "log_export.h"
+#include "log_retention.h"
+#include "segmented_queue.h"
+
+// File definitions untuk daily log (antrean offline: lihat segmented_queue.h)
 #define DAILY_LOG_PREFIX "/vatlog_"
 
-// Struktur data untuk sensor readings
-struct VatSensorData {
-    bool isValid;
-    float distance1;
-    float distance2;
-    float latitude;
-    float longitude;
-    float depth;
-    uint16_t year;
-    uint8_t month;
-    uint8_t day;
-    uint8_t hour;
-    uint8_t minute;
-    uint8_t second;
-    uint8_t satellites;
-    float hdop;
-};
-
 // Flag status global untuk keamanan operasi SD Card
 extern bool isSdCardOk;
 
+// Semua fungsi di bawah aman dipanggil dari task storage, task network dan loop:
+// akses SD Card, antrean offline dan state retensi/kompresi diserialkan oleh satu mutex
+// (dibuat initSdCard()). Operasi panjang (export) membuat task lain menunggu sampai selesai.
+
 // =======================================================
 //   FUNGSI KUSTOM timegm
 //   Mengkonversi struct tm (UTC) ke Unix timestamp.
@@ -55,10 +45,20 @@ bool initSdCard();
 
 /**
  * @brief Cek status SD Card dan tampilkan info
+ *
+ * Jika uji tulis-baca gagal, clock SPI diturunkan dan kartu di-mount ulang
+ * (log harian & kompresi yang sedang terbuka ditutup). Panggil dari task storage
+ * atau saat task lain tidak sedang mengakses SD Card.
  * @return true jika SD Card OK, false jika bermasalah
  */
 bool checkSdCardStatus();
 
+/**
+ * @brief Clock SPI SD Card hasil negosiasi initSdCard()
+ * @return Frekuensi dalam Hz, 0 jika kartu belum ter-mount
+ */
+uint32_t getSdBusFrequency();
+
 /**
  * @brief Format ulang SD Card (HATI-HATI: Menghapus semua data!)
  * @return true jika berhasil
@@ -70,7 +70,11 @@ bool formatSdCard();
 // =======================================================
 
 /**
- * @brief Menulis data sensor ke log harian di SD Card dalam format waktu WIB (UTC+7)
+ * @brief Menulis data sensor ke log harian di SD Card
+ *
+ * DAILY_LOG_FORMAT_BINARY: record biner di /vatlog_YYYY-MM-DD.bin (lihat BinaryLogWriter),
+ * DAILY_LOG_FORMAT_CSV: satu baris CSV dengan waktu WIB (UTC+7) di /vatlog_YYYY-MM-DD.csv.
+ * Hanya dipanggil dari task storage.
  * @param data Struktur data sensor yang akan disimpan
  */
 void writeToDailyLog(const VatSensorData& data);
@@ -86,52 +90,47 @@ void createCsvHeader(const char* filePath);
  * @param year Tahun
  * @param month Bulan
  * @param day Hari
+ * @param extension Ekstensi file (".csv" atau BINARY_LOG_EXTENSION)
  * @return String path file log
  */
-String generateLogFileName(int year, int month, int day);
-
-// =======================================================
-//   OFFLINE QUEUE FUNCTIONS
-// =======================================================
+String generateLogFileName(int year, int month, int day, const char* extension = ".csv");
 
 /**
- * @brief Membaca posisi byte terakhir dari file progres
- * @return Posisi byte terakhir yang telah di-sync
+ * @brief Export log biner satu hari ke CSV (/vatlog_YYYY-MM-DD.csv) untuk dibaca manusia
+ * @return true jika berhasil
  */
-unsigned long readProgress();
+bool exportDailyLogToCsv(int year, int month, int day);
 
-/**
- * @brief Menulis posisi byte baru ke file progres
- * @param position Posisi byte baru
- */
-void writeProgress(unsigned long position);
+// =======================================================
+//   OFFLINE QUEUE FUNCTIONS
+// =======================================================
 
 /**
- * @brief Memeriksa apakah file antrean offline ada dan tidak kosong
+ * @brief Memeriksa apakah antrean offline masih berisi record yang belum di-ack
  * @return true jika ada data yang belum di-sync
  */
 bool isOfflineQueueNotEmpty();
 
 /**
- * @brief Menambahkan satu baris payload JSON ke file antrean offline
+ * @brief Menambahkan satu baris payload JSON ke segmen tail antrean offline
  * @param payload JSON string yang akan ditambahkan ke queue
  */
 void addToOfflineQueue(const char* payload);
 
 /**
- * @brief Membaca baris berikutnya dari antrean berdasarkan pointer progres
- * @return String JSON payload atau empty string jika queue kosong
+ * @brief Baca sampai maxRecords record tertua tanpa menghapusnya (lihat SegmentedQueue::peek)
+ * @return Jumlah record; lengths[i] == 0 berarti record rusak yang cukup di-ack
  */
-String readNextLineFromQueue();
+size_t peekOfflineQueue(size_t maxRecords, char* buffer, size_t size,
+                        const char** records, size_t* lengths);
 
 /**
- * @brief Mengembalikan pointer ke posisi sebelumnya jika pengiriman gagal
- * @param line String yang gagal dikirim
+ * @brief Hapus count record pertama hasil peekOfflineQueue() (sudah terkirim)
  */
-void revertProgress(const String& line);
+bool ackOfflineQueue(size_t count);
 
 /**
- * @brief Bersihkan file queue setelah semua data berhasil di-sync
+ * @brief Hapus semua segmen antrean offline
  */
 void clearOfflineQueue();
 
@@ -140,7 +139,7 @@ void clearOfflineQueue();
 // =======================================================
 
 /**
- * @brief Konversi VatSensorData ke JSON string
+ * @brief Konversi VatSensorData ke JSON string (schema production API)
  * @param data Struktur data sensor
  * @return JSON string
  */
@@ -154,17 +153,34 @@ String sensorDataToJson(const VatSensorData& data);
 String getWibTimestamp(const VatSensorData& data);
 
 /**
- * @brief Hitung ukuran queue file dalam bytes
- * @return Ukuran file queue dalam bytes
+ * @brief Hitung byte antrean yang belum di-sync
+ * @return Ukuran data pending dalam bytes
  */
 size_t getQueueFileSize();
 
 /**
- * @brief Hitung jumlah baris dalam queue file
- * @return Jumlah baris yang belum di-sync
+ * @brief Jumlah record antrean yang belum di-sync (counter metadata, tanpa scan SD)
+ * @return Jumlah record yang belum di-sync
  */
 int getQueueLineCount();
 
+/**
+ * @brief Timestamp record tertua yang belum di-sync (di-cache per posisi head)
+ * @return false jika antrean kosong atau record tidak punya timestamp
+ */
+bool getOldestPendingTimestamp(char* out, size_t size);
+
+/**
+ * @brief Perkiraan waktu drain antrean dari laju ack terakhir
+ * @return Detik, 0 jika kosong, -1 jika belum pernah drain
+ */
+long estimateQueueDrainSeconds();
+
+/**
+ * @brief Tampilkan record/byte pending, timestamp tertua dan estimasi drain
+ */
+void printOfflineQueueStats();
+
 /**
  * @brief Tampilkan statistik SD Card dan queue
  */
@@ -181,22 +197,39 @@ void backupCriticalData(const VatSensorData& data);
 // =======================================================
 
 /**
- * @brief Bersihkan log file yang sudah terlalu lama (> 30 hari)
- * @param daysToKeep Jumlah hari untuk menyimpan log (default: 30)
+ * @brief Satu langkah retensi log harian (lihat LogRetention) - panggil berkala dari task storage
+ *
+ * Log lebih tua dari daysToKeep, atau log tertua selama free space di bawah
+ * LOG_RETENTION_LOW_FREE_PERCENT, dihapus beberapa file per panggilan.
+ * @param daysToKeep Jumlah hari untuk menyimpan log (default: LOG_RETENTION_DAYS)
  */
-void cleanupOldLogs(int daysToKeep = 30);
+void cleanupOldLogs(int daysToKeep = LOG_RETENTION_DAYS);
 
 /**
- * @brief Kompres log file untuk menghemat space
+ * @brief Kompres satu log ke <filePath>.lzs (blocking), verifikasi, lalu hapus file asli
  * @param filePath Path ke file yang akan dikompres
+ * @return true jika file .lzs terverifikasi dan file asli sudah dihapus
  */
 bool compressLogFile(const char* filePath);
 
 /**
- * @brief Export semua data ke file untuk backup eksternal
- * @param exportPath Path file export
+ * @brief Satu langkah kompresi log hari-hari sebelumnya (lihat LogCompressor)
+ *
+ * Panggil dari task storage setelah writeToDailyLog(); tanggal sampel dipakai
+ * sebagai "hari ini" sehingga log yang masih ditulis tidak pernah dikompres.
+ * @param latest Sampel terakhir yang disimpan
+ */
+void compressClosedLogs(const VatSensorData& latest);
+
+/**
+ * @brief Export semua log harian ke satu CSV urut tanggal (lihat LogExporter)
+ *
+ * Blocking - panggil dari loop / command serial. Lock SD dilepas setiap
+ * LOG_EXPORT_STEP_BYTES sehingga task storage tetap menulis log harian;
+ * retensi dan kompresi log ditunda sampai export selesai.
+ * @param exportPath Path file export (default LOG_EXPORT_DEFAULT_FILE)
  * @return true jika berhasil
  */
-bool exportAllData(const char* exportPath);
+bool exportAllData(const char* exportPath = LOG_EXPORT_DEFAULT_FILE);
 
 #endif // SD_UTILS_H
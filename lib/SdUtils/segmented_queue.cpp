@@ -0,0 +1,610 @@
+#include "segmented_queue.h"
+#include <string.h>
+#include <stdio.h>
+#include <stddef.h>
+#include "crc32.h"
+
+// Potongan baca untuk scan segmen (hitung record, migrasi file lama)
+#define QUEUE_SCAN_CHUNK 256
+
+SegmentedQueue::SegmentedQueue() {
+    memset(&meta, 0, sizeof(meta));
+    ready = false;
+    tailSize = 0;
+    tailRecords = 0;
+    countersValid = true;
+    peekCount = 0;
+}
+
+void SegmentedQueue::segmentPath(uint32_t segment, char* out, size_t size) {
+    snprintf(out, size, QUEUE_SEGMENT_PREFIX "%06lu.txt", (unsigned long)segment);
+}
+
+// =======================================================
+//   METADATA
+// =======================================================
+
+// Metadata format v1 (sebelum slot A/B) - hanya untuk migrasi
+struct QueueMetaV1 {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t headSegment;
+    uint32_t headOffset;
+    uint32_t tailSegment;
+};
+
+// Metadata format v2 (slot A/B tanpa counter) - counter dihitung ulang sekali
+struct QueueMetaV2 {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t sequence;
+    uint32_t headSegment;
+    uint32_t headOffset;
+    uint32_t tailSegment;
+    uint32_t crc;
+};
+
+static uint32_t metaCrc(const QueueMeta& meta) {
+    return crc32Compute(&meta, offsetof(QueueMeta, crc));
+}
+
+// Baca satu slot; upgraded = true jika slot masih format v2 (tanpa counter)
+static bool readMetaSlot(const char* path, QueueMeta& out, bool& upgraded) {
+    File file = SD.open(path, FILE_READ);
+    if (!file) return false;
+
+    memset(&out, 0, sizeof(out));
+    size_t got = file.read((uint8_t*)&out, sizeof(out));
+    file.close();
+    upgraded = false;
+
+    if (got == sizeof(QueueMetaV2) && out.magic == QUEUE_META_MAGIC && out.version == 2) {
+        QueueMetaV2 legacy;
+        memcpy(&legacy, &out, sizeof(legacy));
+        if (legacy.crc != crc32Compute(&legacy, offsetof(QueueMetaV2, crc))) return false;
+
+        memset(&out, 0, sizeof(out));
+        out.magic = QUEUE_META_MAGIC;
+        out.version = QUEUE_META_VERSION;
+        out.sequence = legacy.sequence;
+        out.headSegment = legacy.headSegment;
+        out.headOffset = legacy.headOffset;
+        out.tailSegment = legacy.tailSegment;
+        upgraded = true;
+        return out.headSegment <= out.tailSegment;
+    }
+
+    return got == sizeof(out) && out.magic == QUEUE_META_MAGIC && out.version == QUEUE_META_VERSION &&
+           out.crc == metaCrc(out) && out.headSegment <= out.tailSegment;
+}
+
+bool SegmentedQueue::loadMeta() {
+    QueueMeta a, b;
+    bool upgradedA, upgradedB;
+    bool validA = readMetaSlot(QUEUE_META_FILE_A, a, upgradedA);
+    bool validB = readMetaSlot(QUEUE_META_FILE_B, b, upgradedB);
+
+    if (validA || validB) {
+        // Selisih signed agar tetap benar setelah sequence wrap-around
+        bool useA = validA && (!validB || (int32_t)(a.sequence - b.sequence) > 0);
+        meta = useA ? a : b;
+        countersValid = !(useA ? upgradedA : upgradedB);
+        if (!validA || !validB) {
+            Serial.print("⚠️ Queue metadata slot ");
+            Serial.print(validA ? "B" : "A");
+            Serial.println(" invalid - using the other copy");
+        }
+        return true;
+    }
+
+    // Migrasi dari metadata v1 satu file
+    File file = SD.open(QUEUE_META_FILE_V1, FILE_READ);
+    if (!file) return false;
+
+    QueueMetaV1 legacy;
+    bool ok = file.read((uint8_t*)&legacy, sizeof(legacy)) == sizeof(legacy);
+    file.close();
+    if (!ok || legacy.magic != QUEUE_META_MAGIC || legacy.version != 1 ||
+        legacy.headSegment > legacy.tailSegment) {
+        return false;
+    }
+
+    memset(&meta, 0, sizeof(meta));
+    meta.magic = QUEUE_META_MAGIC;
+    meta.version = QUEUE_META_VERSION;
+    meta.headSegment = legacy.headSegment;
+    meta.headOffset = legacy.headOffset;
+    meta.tailSegment = legacy.tailSegment;
+    countersValid = false;  // File v1 dihapus di begin() setelah metadata baru tersimpan
+    return true;
+}
+
+bool SegmentedQueue::saveMeta() {
+    // Tulis ke slot yang tidak memegang salinan terbaru
+    meta.sequence++;
+    meta.crc = metaCrc(meta);
+    const char* path = (meta.sequence & 1) ? QUEUE_META_FILE_B : QUEUE_META_FILE_A;
+
+    File file = SD.open(path, FILE_WRITE);
+    bool ok = file && file.write((const uint8_t*)&meta, sizeof(meta)) == sizeof(meta);
+    if (file) file.close();
+
+    if (!ok) {
+        // Tulis ulang ke slot yang sama berikutnya - salinan lama di slot lain tetap utuh
+        meta.sequence--;
+        Serial.println("❌ ERROR: Failed to write queue metadata!");
+    }
+    return ok;
+}
+
+// Cari nomor segmen terkecil & terbesar di QUEUE_DIR (dipakai jika metadata hilang)
+static bool findSegments(uint32_t& first, uint32_t& last) {
+    File dir = SD.open(QUEUE_DIR);
+    if (!dir || !dir.isDirectory()) return false;
+
+    bool found = false;
+    File entry = dir.openNextFile();
+    while (entry) {
+        const char* name = entry.name();
+        const char* base = strrchr(name, '/');
+        base = base ? base + 1 : name;
+
+        unsigned long segment;
+        if (sscanf(base, "seg_%lu.txt", &segment) == 1) {
+            if (!found || segment < first) first = segment;
+            if (!found || segment > last) last = segment;
+            found = true;
+        }
+        entry.close();
+        entry = dir.openNextFile();
+    }
+    dir.close();
+    return found;
+}
+
+// Hapus segmen [first, end)
+void SegmentedQueue::removeSegments(uint32_t first, uint32_t end) {
+    char path[32];
+    for (uint32_t segment = first; segment < end; segment++) {
+        segmentPath(segment, path, sizeof(path));
+        SD.remove(path);
+    }
+}
+
+// Lewati segmen yang sudah habis dibaca; antrean kosong -> tutup segmen tail
+void SegmentedQueue::normalizeHead() {
+    char path[32];
+    while (meta.headSegment < meta.tailSegment) {
+        segmentPath(meta.headSegment, path, sizeof(path));
+        File file = SD.open(path, FILE_READ);
+        size_t size = file ? file.size() : 0;
+        if (file) file.close();
+
+        if (meta.headOffset < size) return;
+        meta.headSegment++;
+        meta.headOffset = 0;
+    }
+
+    if (tailSize > 0 && meta.headOffset >= tailSize) {
+        sealTail(0);
+        meta.headSegment = meta.tailSegment;
+        meta.headOffset = 0;
+    }
+
+    // Antrean kosong: samakan counter (mengoreksi selisih dari segmen yang hilang)
+    if (isEmpty()) {
+        meta.ackedRecords = meta.sealedRecords + tailRecords;
+        meta.ackedBytes = meta.sealedBytes + tailSize;
+    }
+}
+
+// Tutup segmen tail; extraRecords = record terpotong tanpa '\n' di akhir segmen
+void SegmentedQueue::sealTail(uint32_t extraRecords) {
+    meta.sealedRecords += tailRecords + extraRecords;
+    meta.sealedBytes += tailSize;
+    meta.tailSegment++;
+    tailSize = 0;
+    tailRecords = 0;
+}
+
+// =======================================================
+//   COUNTERS
+// =======================================================
+
+// Hitung '\n' di satu segmen mulai fromOffset; complete = false jika byte terakhir bukan '\n'
+bool SegmentedQueue::scanSegment(uint32_t segment, uint32_t fromOffset,
+                                 uint32_t& records, uint32_t& bytes, bool& complete) {
+    records = 0;
+    bytes = 0;
+    complete = true;
+
+    char path[32];
+    segmentPath(segment, path, sizeof(path));
+    File file = SD.open(path, FILE_READ);
+    if (!file) return false;
+
+    uint8_t chunk[QUEUE_SCAN_CHUNK];
+    uint8_t last = '\n';
+    size_t got;
+    file.seek(fromOffset);
+    while ((got = file.read(chunk, sizeof(chunk))) > 0) {
+        for (size_t i = 0; i < got; i++) {
+            if (chunk[i] == '\n') records++;
+        }
+        bytes += got;
+        last = chunk[got - 1];
+    }
+    file.close();
+
+    complete = last == '\n';
+    return true;
+}
+
+// Metadata tanpa counter (v1/v2 atau hilang) - hitung sekali dari isi segmen
+void SegmentedQueue::rebuildCounters() {
+    Serial.println("🔄 Rebuilding offline queue counters...");
+    meta.sealedRecords = 0;
+    meta.sealedBytes = 0;
+    meta.ackedRecords = 0;
+    meta.ackedBytes = 0;
+
+    uint32_t records, bytes;
+    bool complete;
+    for (uint32_t segment = meta.headSegment; segment < meta.tailSegment; segment++) {
+        if (!scanSegment(segment, segment == meta.headSegment ? meta.headOffset : 0,
+                         records, bytes, complete)) {
+            continue;
+        }
+        // Sisa tanpa '\n' di segmen lama dibaca peek() sebagai satu record rusak
+        meta.sealedRecords += records + (complete ? 0 : 1);
+        meta.sealedBytes += bytes;
+    }
+
+    // Segmen tail dihitung utuh di begin(); bagian sebelum head dianggap sudah di-ack
+    if (meta.headSegment == meta.tailSegment && meta.headOffset > 0 &&
+        scanSegment(meta.tailSegment, 0, records, bytes, complete)) {
+        uint32_t pendingRecords, pendingBytes;
+        scanSegment(meta.tailSegment, meta.headOffset, pendingRecords, pendingBytes, complete);
+        meta.ackedRecords = records - pendingRecords;
+        meta.ackedBytes = bytes - pendingBytes;
+    }
+    countersValid = true;
+}
+
+// =======================================================
+//   LIFECYCLE
+// =======================================================
+
+bool SegmentedQueue::begin() {
+    ready = false;
+    peekCount = 0;
+
+    if (!SD.exists(QUEUE_DIR) && !SD.mkdir(QUEUE_DIR)) {
+        Serial.println("❌ Cannot create queue directory " QUEUE_DIR);
+        return false;
+    }
+
+    countersValid = true;
+    if (!loadMeta()) {
+        memset(&meta, 0, sizeof(meta));
+        meta.magic = QUEUE_META_MAGIC;
+        meta.version = QUEUE_META_VERSION;
+
+        // Metadata hilang tapi segmen masih ada - mulai ulang dari segmen tertua
+        uint32_t first, last;
+        if (findSegments(first, last)) {
+            meta.headSegment = first;
+            meta.tailSegment = last;
+            countersValid = false;
+            Serial.println("⚠️ Queue metadata missing - replaying from oldest segment");
+        }
+    }
+
+    if (!countersValid) rebuildCounters();
+
+    // Record terakhir tanpa '\n' (listrik mati saat append) ditinggal di segmen lama
+    bool complete;
+    if (scanSegment(meta.tailSegment, 0, tailRecords, tailSize, complete) && !complete) {
+        Serial.println("⚠️ Torn record at queue tail - starting new segment");
+        sealTail(1);
+    }
+
+    normalizeHead();
+    if (!saveMeta()) return false;
+    if (SD.exists(QUEUE_META_FILE_V1)) SD.remove(QUEUE_META_FILE_V1);
+
+    char path[32];
+
+    // Segmen yang sudah di-ack tapi belum terhapus (listrik mati setelah metadata ditulis)
+    for (uint32_t segment = meta.headSegment; segment > 0; segment--) {
+        segmentPath(segment - 1, path, sizeof(path));
+        if (!SD.exists(path)) break;
+        SD.remove(path);
+    }
+    ready = true;
+
+    importLegacyQueue();
+
+    Serial.print("📋 Offline queue ready: segments ");
+    Serial.print(meta.headSegment);
+    Serial.print("..");
+    Serial.println(meta.tailSegment);
+    return true;
+}
+
+void SegmentedQueue::clear() {
+    if (!ready) return;
+
+    uint32_t first = meta.headSegment;
+    uint32_t end = meta.tailSegment + 1;
+    sealTail(0);
+    meta.headSegment = meta.tailSegment;
+    meta.headOffset = 0;
+    meta.ackedRecords = meta.sealedRecords;
+    meta.ackedBytes = meta.sealedBytes;
+    peekCount = 0;
+
+    saveMeta();
+    removeSegments(first, end);
+}
+
+// Pindahkan isi /offline_queue.txt (mulai dari progress offset) ke segmen lalu hapus
+void SegmentedQueue::importLegacyQueue() {
+    if (!SD.exists(LEGACY_QUEUE_FILE)) return;
+
+    unsigned long progress = 0;
+    File progressFile = SD.open(LEGACY_PROGRESS_FILE, FILE_READ);
+    if (progressFile) {
+        progress = progressFile.readString().toInt();
+        progressFile.close();
+    }
+
+    File legacy = SD.open(LEGACY_QUEUE_FILE, FILE_READ);
+    if (!legacy) return;
+
+    Serial.println("🔄 Migrating legacy offline queue to segments...");
+    char line[QUEUE_RECORD_MAX_SIZE + 2];
+    uint32_t offset = progress;
+    size_t imported = 0;
+    bool skipping = false;
+
+    while (true) {
+        legacy.seek(offset);
+        size_t got = legacy.read((uint8_t*)line, sizeof(line));
+        if (got == 0) break;
+
+        char* newline = (char*)memchr(line, '\n', got);
+        if (newline == NULL && got == sizeof(line)) {
+            // Baris lebih panjang dari record maksimal - lewati sampai '\n'
+            skipping = true;
+            offset += got;
+            continue;
+        }
+
+        size_t length = newline ? (size_t)(newline - line) : got;
+        offset += length + (newline ? 1 : 0);
+        if (length > 0 && line[length - 1] == '\r') length--;
+        if (!skipping && length > 0 && enqueue(line, length)) imported++;
+        skipping = false;
+        if (newline == NULL) break;
+    }
+    legacy.close();
+
+    SD.remove(LEGACY_QUEUE_FILE);
+    SD.remove(LEGACY_PROGRESS_FILE);
+    Serial.print("✅ Migrated ");
+    Serial.print(imported);
+    Serial.println(" pending records");
+}
+
+// =======================================================
+//   ENQUEUE / PEEK / ACK
+// =======================================================
+
+bool SegmentedQueue::isEmpty() const {
+    return meta.headSegment == meta.tailSegment && meta.headOffset >= tailSize;
+}
+
+bool SegmentedQueue::enqueue(const char* record, size_t length) {
+    if (!ready) return false;
+    if (length == 0 || length > QUEUE_RECORD_MAX_SIZE || memchr(record, '\n', length) != NULL) {
+        Serial.println("❌ Invalid record for offline queue");
+        return false;
+    }
+
+    // Segmen tail penuh - satu-satunya enqueue yang menulis metadata
+    if (tailSize > 0 && tailSize + length + 1 > QUEUE_SEGMENT_MAX_BYTES) {
+        bool wasEmpty = isEmpty();
+        QueueMeta previous = meta;
+        uint32_t previousSize = tailSize;
+        uint32_t previousRecords = tailRecords;
+        sealTail(0);
+        if (wasEmpty) {
+            meta.headSegment = meta.tailSegment;
+            meta.headOffset = 0;
+        }
+        if (!saveMeta()) {
+            meta = previous;
+            tailSize = previousSize;
+            tailRecords = previousRecords;
+            return false;
+        }
+    }
+
+    char path[32];
+    segmentPath(meta.tailSegment, path, sizeof(path));
+    File file = SD.open(path, FILE_APPEND);
+    if (!file) {
+        Serial.println("❌ Failed to open queue segment for writing");
+        return false;
+    }
+
+    size_t written = file.write((const uint8_t*)record, length);
+    written += file.write((uint8_t)'\n');
+    file.close();
+    tailSize += written;
+
+    if (written != length + 1) {
+        // Record terpotong - tutup segmen ini agar record berikutnya tidak tersambung
+        Serial.println("❌ ERROR: Failed to write to offline queue!");
+        sealTail(written > 0 ? 1 : 0);
+        saveMeta();
+        return false;
+    }
+    tailRecords++;
+    return true;
+}
+
+size_t SegmentedQueue::peek(size_t maxRecords, char* buffer, size_t size,
+                            const char** records, size_t* lengths) {
+    peekCount = 0;
+    if (!ready || buffer == NULL || size < 2) return 0;
+    if (maxRecords > QUEUE_PEEK_MAX_RECORDS) maxRecords = QUEUE_PEEK_MAX_RECORDS;
+
+    uint32_t segment = meta.headSegment;
+    uint32_t offset = meta.headOffset;
+    size_t used = 0;
+    uint32_t consumed = 0;      // Byte dari head sampai akhir record terakhir (untuk counter ack)
+    bool skipping = false;      // Sedang melewati record rusak yang lebih besar dari buffer
+    char path[32];
+    File file;
+
+    while (peekCount < maxRecords && segment <= meta.tailSegment) {
+        if (!file) {
+            segmentPath(segment, path, sizeof(path));
+            file = SD.open(path, FILE_READ);
+            if (!file) {
+                // Segmen hilang - lanjut ke segmen berikutnya
+                if (segment == meta.tailSegment) break;
+                segment++;
+                offset = 0;
+                continue;
+            }
+        }
+
+        size_t room = size - used - 1;
+        if (room == 0) break;
+
+        // Record di file berurutan, jadi bisa dibaca langsung ke buffer dan dipotong di '\n'
+        char* chunk = buffer + used;
+        file.seek(offset);
+        size_t got = file.read((uint8_t*)chunk, room);
+        if (got == 0) {
+            file.close();
+            if (segment == meta.tailSegment) break;
+            segment++;
+            offset = 0;
+            continue;
+        }
+
+        size_t parsed = 0;
+        while (peekCount < maxRecords) {
+            char* start = chunk + parsed;
+            char* newline = (char*)memchr(start, '\n', got - parsed);
+            if (newline == NULL) break;
+
+            size_t lineLength = newline - start;
+            parsed += lineLength + 1;
+            offset += lineLength + 1;
+            consumed += lineLength + 1;
+
+            size_t length = lineLength;
+            if (length > 0 && start[length - 1] == '\r') length--;
+            if (skipping || length > QUEUE_RECORD_MAX_SIZE) length = 0;
+            start[length] = '\0';
+            skipping = false;
+
+            records[peekCount] = start;
+            lengths[peekCount] = length;
+            peekSegment[peekCount] = segment;
+            peekOffset[peekCount] = offset;
+            peekBytes[peekCount] = consumed;
+            peekCount++;
+        }
+        used += parsed;
+        if (parsed > 0) continue;
+
+        if (got < room) {
+            // Akhir segmen tanpa '\n': di tail berarti record belum lengkap
+            if (segment == meta.tailSegment) break;
+
+            // Record terpotong di segmen lama (listrik mati saat append) - di-ack tanpa dikirim
+            offset += got;
+            consumed += got;
+            chunk[0] = '\0';
+            records[peekCount] = chunk;
+            lengths[peekCount] = 0;
+            peekSegment[peekCount] = segment;
+            peekOffset[peekCount] = offset;
+            peekBytes[peekCount] = consumed;
+            peekCount++;
+            used += 1;
+            skipping = false;
+        } else if (used > 0) {
+            break;  // Buffer penuh - sisa record di peek berikutnya
+        } else {
+            // Satu record lebih besar dari buffer (data rusak) - lewati sampai '\n'
+            skipping = true;
+            offset += got;
+            consumed += got;
+        }
+    }
+
+    if (file) file.close();
+    return peekCount;
+}
+
+bool SegmentedQueue::ack(size_t count) {
+    if (!ready || count == 0) return true;
+    if (count > peekCount) count = peekCount;
+    if (count == 0) return false;
+
+    uint32_t previousHead = meta.headSegment;
+    meta.headSegment = peekSegment[count - 1];
+    meta.headOffset = peekOffset[count - 1];
+    meta.ackedRecords += count;
+    meta.ackedBytes += peekBytes[count - 1];
+    peekCount = 0;
+
+    normalizeHead();
+    bool ok = saveMeta();
+
+    // Segmen yang sudah habis dihapus setelah metadata aman
+    removeSegments(previousHead, meta.headSegment);
+    return ok;
+}
+
+// =======================================================
+//   STATISTICS
+// =======================================================
+
+uint32_t SegmentedQueue::pendingRecords() const {
+    if (!ready || isEmpty()) return 0;
+    return meta.sealedRecords + tailRecords - meta.ackedRecords;
+}
+
+uint32_t SegmentedQueue::pendingBytes() const {
+    if (!ready || isEmpty()) return 0;
+    return meta.sealedBytes + tailSize - meta.ackedBytes;
+}
+
+size_t SegmentedQueue::readHead(char* out, size_t size) {
+    if (!ready || out == NULL || size < 2 || isEmpty()) return 0;
+
+    char path[32];
+    segmentPath(meta.headSegment, path, sizeof(path));
+    File file = SD.open(path, FILE_READ);
+    if (!file) return 0;
+
+    file.seek(meta.headOffset);
+    size_t got = file.read((uint8_t*)out, size - 1);
+    file.close();
+
+    char* newline = (char*)memchr(out, '\n', got);
+    if (newline == NULL) return 0;
+
+    size_t length = newline - out;
+    if (length > 0 && out[length - 1] == '\r') length--;
+    out[length] = '\0';
+    return length;
+}
@@ -0,0 +1,143 @@
+#ifndef SEGMENTED_QUEUE_H
+#define SEGMENTED_QUEUE_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include "FS.h"
+#include "../include/config.h"
+
+// =======================================================
+//   SEGMENTED OFFLINE QUEUE
+//   Record (satu baris teks, biasanya JSON production) ditambahkan ke segmen
+//   tail /queue/seg_NNNNNN.txt. Segmen baru dibuat jika tail melebihi
+//   QUEUE_SEGMENT_MAX_BYTES. Metadata hanya menyimpan posisi head dan nomor
+//   segmen tail; segmen yang sudah di-ack seluruhnya dihapus tanpa menulis ulang data.
+// =======================================================
+
+#define QUEUE_DIR "/queue"
+#define QUEUE_SEGMENT_PREFIX "/queue/seg_"
+#define QUEUE_META_MAGIC 0x51544156UL  // "VATQ"
+#define QUEUE_META_VERSION 3
+
+// Metadata ditulis bergantian ke slot A/B (sequence genap -> A, ganjil -> B).
+// Saat boot dipakai salinan valid (magic + CRC) dengan sequence terbesar, jadi
+// write yang terpotong listrik mati hanya mengembalikan posisi ke ack sebelumnya.
+#define QUEUE_META_FILE_A "/queue/meta_a.bin"
+#define QUEUE_META_FILE_B "/queue/meta_b.bin"
+#define QUEUE_META_FILE_V1 "/queue/meta.bin"   // Format lama tanpa CRC - dimigrasi saat begin()
+
+// File antrean lama (satu file teks + progress offset) - dimigrasi saat begin()
+#define LEGACY_QUEUE_FILE "/offline_queue.txt"
+#define LEGACY_PROGRESS_FILE "/queue_progress.txt"
+
+struct QueueMeta {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t sequence;          // Naik setiap kali metadata ditulis
+    uint32_t headSegment;       // Segmen record tertua yang belum di-ack
+    uint32_t headOffset;        // Offset byte record tersebut di segmennya
+    uint32_t tailSegment;       // Segmen tempat enqueue berikutnya
+
+    // Counter kumulatif (modulo 2^32): pending = sealed + isi segmen tail - acked
+    uint32_t sealedRecords;     // Record di segmen sebelum tail
+    uint32_t sealedBytes;
+    uint32_t ackedRecords;      // Record yang sudah di-ack
+    uint32_t ackedBytes;
+
+    uint32_t crc;               // CRC32 semua field di atas
+};
+
+/**
+ * @brief Antrean offline persisten di SD Card dengan enqueue O(1) dan peek/ack per batch
+ *
+ * Pola pemakaian: peek(n) membaca sampai n record dari head tanpa menghapusnya,
+ * kirim ke server, lalu ack(k) untuk k record pertama yang berhasil.
+ * Record yang tidak di-ack akan muncul lagi di peek berikutnya.
+ * Tidak thread-safe - panggil dari satu task, atau lewat sd_utils (diserialkan mutex SD).
+ */
+class SegmentedQueue {
+private:
+    QueueMeta meta;
+    bool ready;
+    uint32_t tailSize;          // Ukuran segmen tail (cache, tanpa membuka file)
+    uint32_t tailRecords;       // Jumlah record di segmen tail
+    bool countersValid;         // false jika metadata lama tanpa counter (dihitung ulang di begin)
+
+    // Posisi setelah setiap record hasil peek() terakhir, dipakai oleh ack()
+    uint32_t peekSegment[QUEUE_PEEK_MAX_RECORDS];
+    uint32_t peekOffset[QUEUE_PEEK_MAX_RECORDS];
+    uint32_t peekBytes[QUEUE_PEEK_MAX_RECORDS];  // Byte kumulatif dari head sampai record ini
+    size_t peekCount;
+
+    bool loadMeta();
+    bool saveMeta();
+    void segmentPath(uint32_t segment, char* out, size_t size);
+    void removeSegments(uint32_t first, uint32_t end);
+    void normalizeHead();
+    void sealTail(uint32_t extraRecords);
+    bool scanSegment(uint32_t segment, uint32_t fromOffset, uint32_t& records, uint32_t& bytes, bool& complete);
+    void rebuildCounters();
+    void importLegacyQueue();
+
+public:
+    SegmentedQueue();
+
+    /**
+     * @brief Buka / buat antrean di QUEUE_DIR (panggil setelah SD Card mount)
+     * @return false jika metadata tidak bisa dibuat
+     */
+    bool begin();
+
+    /**
+     * @brief Tambah satu record di akhir antrean
+     * @param record Teks tanpa '\n', maksimal QUEUE_RECORD_MAX_SIZE byte
+     */
+    bool enqueue(const char* record, size_t length);
+
+    /**
+     * @brief Baca sampai maxRecords record tertua tanpa menghapusnya
+     * @param buffer Tempat record disalin (setiap record diakhiri '\0')
+     * @param records Diisi pointer ke awal setiap record di buffer
+     * @param lengths Diisi panjang setiap record; 0 = record rusak, cukup di-ack
+     * @return Jumlah record yang terbaca
+     */
+    size_t peek(size_t maxRecords, char* buffer, size_t size, const char** records, size_t* lengths);
+
+    /**
+     * @brief Hapus count record pertama dari hasil peek() terakhir
+     *
+     * Metadata ditulis sekali per ack; segmen yang terlewati dihapus.
+     * Hasil peek() sebelumnya tidak berlaku lagi setelah ack.
+     */
+    bool ack(size_t count);
+
+    bool isEmpty() const;
+
+    /**
+     * @brief Hapus semua segmen dan mulai dari segmen baru
+     */
+    void clear();
+
+    uint32_t getHeadSegment() const { return meta.headSegment; }
+    uint32_t getHeadOffset() const { return meta.headOffset; }
+    uint32_t getMetaSequence() const { return meta.sequence; }
+    uint32_t getTailSegment() const { return meta.tailSegment; }
+
+    /**
+     * @brief Jumlah record yang belum di-ack (dari counter metadata, O(1))
+     */
+    uint32_t pendingRecords() const;
+
+    /**
+     * @brief Byte yang belum di-ack (dari counter metadata, O(1))
+     */
+    uint32_t pendingBytes() const;
+
+    /**
+     * @brief Salin record tertua tanpa mengubah hasil peek()
+     * @return Panjang record, 0 jika antrean kosong atau record belum lengkap
+     */
+    size_t readHead(char* out, size_t size);
+};
+
+#endif // SEGMENTED_QUEUE_H
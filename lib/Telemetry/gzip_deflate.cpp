@@ -0,0 +1,231 @@
+#include "gzip_deflate.h"
+#include <string.h>
+#include "../SdUtils/crc32.h"
+
+// Tabel deflate (RFC 1951 3.2.5): simbol 257..285 untuk panjang, 0..29 untuk jarak
+static const uint16_t LENGTH_BASE[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint8_t LENGTH_EXTRA[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const uint16_t DISTANCE_BASE[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const uint8_t DISTANCE_EXTRA[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+static inline uint16_t hash3(const uint8_t* data) {
+    return ((data[0] << 6) ^ (data[1] << 3) ^ data[2]) & (GZIP_HASH_SIZE - 1);
+}
+
+// Kode Huffman ditulis mulai bit paling signifikan, stream deflate mulai bit terendah
+static inline uint16_t reverseBits(uint16_t code, uint8_t count) {
+    uint16_t result = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        result = (result << 1) | (code & 1);
+        code >>= 1;
+    }
+    return result;
+}
+
+GzipEncoder::GzipEncoder() {
+    windowPos = 0;
+    windowEnd = 0;
+    out = NULL;
+    capacity = 0;
+    outLength = 0;
+    overflow = false;
+    bitBuffer = 0;
+    bitCount = 0;
+    inputSize = 0;
+    inputCrc = 0;
+}
+
+// =======================================================
+//   BIT WRITER
+// =======================================================
+
+void GzipEncoder::putByte(uint8_t value) {
+    if (outLength < capacity) {
+        out[outLength++] = value;
+    } else {
+        overflow = true;
+    }
+}
+
+void GzipEncoder::putBits(uint32_t value, uint8_t count) {
+    bitBuffer |= value << bitCount;
+    bitCount += count;
+    while (bitCount >= 8) {
+        putByte(bitBuffer & 0xFF);
+        bitBuffer >>= 8;
+        bitCount -= 8;
+    }
+}
+
+// Kode literal/panjang Huffman tetap (RFC 1951 3.2.6)
+void GzipEncoder::putSymbol(uint16_t symbol) {
+    if (symbol < 144) {
+        putBits(reverseBits(0x30 + symbol, 8), 8);
+    } else if (symbol < 256) {
+        putBits(reverseBits(0x190 + symbol - 144, 9), 9);
+    } else if (symbol < 280) {
+        putBits(reverseBits(symbol - 256, 7), 7);
+    } else {
+        putBits(reverseBits(0xC0 + symbol - 280, 8), 8);
+    }
+}
+
+// =======================================================
+//   LZ77
+// =======================================================
+
+// Buang separuh window tertua; posisi di hash chain ikut digeser
+void GzipEncoder::slideWindow() {
+    memmove(window, window + GZIP_WINDOW_SIZE, windowEnd - GZIP_WINDOW_SIZE);
+    windowPos -= GZIP_WINDOW_SIZE;
+    windowEnd -= GZIP_WINDOW_SIZE;
+
+    for (size_t i = 0; i < GZIP_HASH_SIZE; i++) {
+        head[i] = (head[i] != GZIP_NIL && head[i] >= GZIP_WINDOW_SIZE) ? head[i] - GZIP_WINDOW_SIZE : GZIP_NIL;
+    }
+    for (size_t i = 0; i < GZIP_WINDOW_SIZE; i++) {
+        prev[i] = (prev[i] != GZIP_NIL && prev[i] >= GZIP_WINDOW_SIZE) ? prev[i] - GZIP_WINDOW_SIZE : GZIP_NIL;
+    }
+}
+
+void GzipEncoder::insertHash(size_t position) {
+    uint16_t hash = hash3(window + position);
+    prev[position & (GZIP_WINDOW_SIZE - 1)] = head[hash];
+    head[hash] = position;
+}
+
+size_t GzipEncoder::findMatch(size_t& distance) {
+    size_t available = windowEnd - windowPos;
+    if (available < GZIP_MIN_MATCH) return 0;
+
+    size_t maxLength = available < GZIP_MAX_MATCH ? available : GZIP_MAX_MATCH;
+    size_t limit = windowPos > GZIP_WINDOW_SIZE ? windowPos - GZIP_WINDOW_SIZE : 0;
+    const uint8_t* current = window + windowPos;
+    uint16_t candidate = head[hash3(current)];
+    size_t best = 0;
+
+    for (int chain = GZIP_MAX_CHAIN; chain > 0 && candidate != GZIP_NIL && candidate >= limit; chain--) {
+        const uint8_t* match = window + candidate;
+        if (match[best] == current[best]) {
+            size_t length = 0;
+            while (length < maxLength && match[length] == current[length]) length++;
+            if (length > best) {
+                best = length;
+                distance = windowPos - candidate;
+                if (best == maxLength) break;
+            }
+        }
+
+        // Slot prev bisa sudah ditimpa posisi yang lebih baru - chain harus selalu mundur
+        uint16_t next = prev[candidate & (GZIP_WINDOW_SIZE - 1)];
+        if (next >= candidate) break;
+        candidate = next;
+    }
+    return best >= GZIP_MIN_MATCH ? best : 0;
+}
+
+void GzipEncoder::emitMatch(size_t distance, size_t length) {
+    int code = 28;
+    while (LENGTH_BASE[code] > length) code--;
+    putSymbol(257 + code);
+    putBits(length - LENGTH_BASE[code], LENGTH_EXTRA[code]);
+
+    code = 29;
+    while (DISTANCE_BASE[code] > distance) code--;
+    putBits(reverseBits(code, 5), 5);   // Kode jarak tetap: 5 bit
+    putBits(distance - DISTANCE_BASE[code], DISTANCE_EXTRA[code]);
+}
+
+// Greedy seperti LogCompressor; tanpa flush, lookahead GZIP_MAX_MATCH dijaga untuk write() berikutnya
+void GzipEncoder::compress(bool flush) {
+    while (windowPos < windowEnd && (flush || windowEnd - windowPos >= GZIP_MAX_MATCH)) {
+        size_t distance = 0;
+        size_t length = findMatch(distance);
+        if (length > 0) {
+            emitMatch(distance, length);
+        } else {
+            putSymbol(window[windowPos]);
+            length = 1;
+        }
+
+        for (size_t i = 0; i < length; i++, windowPos++) {
+            if (windowEnd - windowPos >= GZIP_MIN_MATCH) insertHash(windowPos);
+        }
+    }
+}
+
+// =======================================================
+//   STREAM
+// =======================================================
+
+void GzipEncoder::begin(uint8_t* out, size_t capacity) {
+    this->out = out;
+    this->capacity = capacity;
+    outLength = 0;
+    overflow = false;
+    bitBuffer = 0;
+    bitCount = 0;
+    inputSize = 0;
+    inputCrc = 0;
+
+    memset(head, 0xFF, sizeof(head));   // GZIP_NIL
+    memset(prev, 0xFF, sizeof(prev));
+    windowPos = 0;
+    windowEnd = 0;
+
+    // ID1 ID2 CM=deflate FLG=0 MTIME=0 XFL=0 OS=255 (unknown)
+    static const uint8_t header[10] = {0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 255};
+    for (size_t i = 0; i < sizeof(header); i++) putByte(header[i]);
+
+    // Satu blok untuk seluruh stream: BFINAL=1, BTYPE=01 (Huffman tetap)
+    putBits(1, 1);
+    putBits(1, 2);
+}
+
+bool GzipEncoder::write(const void* data, size_t length) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    inputCrc = crc32Compute(bytes, length, inputCrc);
+    inputSize += length;
+
+    while (length > 0 && !overflow) {
+        if (windowEnd == sizeof(window)) slideWindow();
+
+        size_t count = sizeof(window) - windowEnd;
+        if (count > length) count = length;
+        memcpy(window + windowEnd, bytes, count);
+        windowEnd += count;
+        bytes += count;
+        length -= count;
+
+        compress(false);
+    }
+    return !overflow;
+}
+
+size_t GzipEncoder::finish() {
+    compress(true);
+    putSymbol(256);                     // End of block
+    if (bitCount > 0) putBits(0, 8 - bitCount);
+
+    for (int i = 0; i < 4; i++) putByte(inputCrc >> (8 * i));
+    for (int i = 0; i < 4; i++) putByte(inputSize >> (8 * i));
+    return overflow ? 0 : outLength;
+}
+
+size_t gzip_compress(GzipEncoder& encoder, const void* data, size_t length, uint8_t* out, size_t capacity) {
+    encoder.begin(out, capacity);
+    if (!encoder.write(data, length)) return 0;
+    return encoder.finish();
+}
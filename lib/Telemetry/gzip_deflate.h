@@ -0,0 +1,83 @@
+#ifndef GZIP_DEFLATE_H
+#define GZIP_DEFLATE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// =======================================================
+//   GZIP (RFC 1952 / deflate RFC 1951)
+//   Encoder streaming untuk body upload (Content-Encoding: gzip):
+//   LZ77 greedy dengan window kecil + satu blok Huffman tetap (BTYPE=01),
+//   jadi tidak perlu tabel frekuensi atau buffer blok. Output langsung ke
+//   buffer caller; RAM encoder tetap ~6 KB, tanpa malloc.
+//   Hasil bisa dibaca decoder gzip standar (zlib, server HTTP).
+// =======================================================
+
+#define GZIP_WINDOW_BITS 10         // Jarak match maksimal 1 KB (deflate mengizinkan sampai 32 KB)
+#define GZIP_WINDOW_SIZE (1 << GZIP_WINDOW_BITS)
+#define GZIP_MIN_MATCH 3
+#define GZIP_MAX_MATCH 258
+#define GZIP_HASH_BITS 10
+#define GZIP_HASH_SIZE (1 << GZIP_HASH_BITS)
+#define GZIP_MAX_CHAIN 16           // Kandidat match maksimal per posisi
+#define GZIP_NIL 0xFFFF
+#define GZIP_OVERHEAD 18            // Header 10 byte + trailer CRC32/ISIZE 8 byte
+
+class GzipEncoder {
+private:
+    // Window geser 2x ukuran window + hash chain posisi (sama dengan LogCompressor)
+    uint8_t window[2 * GZIP_WINDOW_SIZE];
+    uint16_t head[GZIP_HASH_SIZE];
+    uint16_t prev[GZIP_WINDOW_SIZE];
+    size_t windowPos;
+    size_t windowEnd;
+
+    uint8_t* out;
+    size_t capacity;
+    size_t outLength;
+    bool overflow;
+    uint32_t bitBuffer;
+    uint8_t bitCount;
+
+    uint32_t inputSize;
+    uint32_t inputCrc;
+
+    void putByte(uint8_t value);
+    void putBits(uint32_t value, uint8_t count);
+    void putSymbol(uint16_t symbol);
+    void slideWindow();
+    void insertHash(size_t position);
+    size_t findMatch(size_t& distance);
+    void emitMatch(size_t distance, size_t length);
+    void compress(bool flush);
+
+public:
+    GzipEncoder();
+
+    /**
+     * @brief Mulai stream gzip baru ke buffer out (header langsung ditulis)
+     */
+    void begin(uint8_t* out, size_t capacity);
+
+    /**
+     * @brief Tambahkan data; boleh dipanggil berkali-kali dengan potongan kecil
+     * @return false jika buffer output sudah penuh (hasil tidak bisa dipakai)
+     */
+    bool write(const void* data, size_t length);
+
+    /**
+     * @brief Tutup blok deflate dan tulis trailer CRC32 + ukuran asli
+     * @return Panjang stream gzip, 0 jika tidak muat di buffer output
+     */
+    size_t finish();
+
+    uint32_t getInputSize() const { return inputSize; }
+};
+
+/**
+ * @brief Kompres satu buffer utuh sebagai gzip
+ * @return Panjang hasil, 0 jika tidak muat di capacity (caller kirim body asli)
+ */
+size_t gzip_compress(GzipEncoder& encoder, const void* data, size_t length, uint8_t* out, size_t capacity);
+
+#endif // GZIP_DEFLATE_H
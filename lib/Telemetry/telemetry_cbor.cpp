@@ -0,0 +1,138 @@
+#include "telemetry_cbor.h"
+#include <string.h>
+#include <math.h>
+#include "telemetry_json.h"
+
+// Major type CBOR (RFC 8949)
+#define CBOR_MAJOR_UINT 0
+#define CBOR_MAJOR_NEGINT 1
+#define CBOR_MAJOR_TEXT 3
+#define CBOR_MAJOR_ARRAY 4
+#define CBOR_MAJOR_MAP 5
+#define CBOR_NULL 0xF6
+#define CBOR_ARRAY_INDEFINITE 0x9F
+#define CBOR_BREAK 0xFF
+
+// =======================================================
+//   BUFFER WRITER
+// =======================================================
+
+struct CborWriter {
+    uint8_t* pos;
+    uint8_t* end;
+    bool ok;
+};
+
+static void put_byte(CborWriter& w, uint8_t value) {
+    if (w.pos >= w.end) {
+        w.ok = false;
+        return;
+    }
+    *w.pos++ = value;
+}
+
+// Header item: major type + argument dalam bentuk terpendek
+static void put_head(CborWriter& w, uint8_t major, uint64_t value) {
+    uint8_t type = major << 5;
+    if (value < 24) {
+        put_byte(w, type | (uint8_t)value);
+    } else if (value <= 0xFF) {
+        put_byte(w, type | 24);
+        put_byte(w, (uint8_t)value);
+    } else if (value <= 0xFFFF) {
+        put_byte(w, type | 25);
+        put_byte(w, (uint8_t)(value >> 8));
+        put_byte(w, (uint8_t)value);
+    } else if (value <= 0xFFFFFFFFULL) {
+        put_byte(w, type | 26);
+        for (int shift = 24; shift >= 0; shift -= 8) put_byte(w, (uint8_t)(value >> shift));
+    } else {
+        put_byte(w, type | 27);
+        for (int shift = 56; shift >= 0; shift -= 8) put_byte(w, (uint8_t)(value >> shift));
+    }
+}
+
+static void put_int(CborWriter& w, int64_t value) {
+    if (value >= 0) {
+        put_head(w, CBOR_MAJOR_UINT, (uint64_t)value);
+    } else {
+        put_head(w, CBOR_MAJOR_NEGINT, (uint64_t)(-1 - value));
+    }
+}
+
+static void put_text(CborWriter& w, const char* text) {
+    size_t length = strlen(text);
+    put_head(w, CBOR_MAJOR_TEXT, length);
+    for (size_t i = 0; i < length; i++) put_byte(w, (uint8_t)text[i]);
+}
+
+// Nilai float sebagai integer fixed-point (value x scale), NaN/Inf sebagai null
+static void put_fixed(CborWriter& w, double value, double scale) {
+    if (isnan(value) || isinf(value)) {
+        put_byte(w, CBOR_NULL);
+        return;
+    }
+    put_int(w, (int64_t)llround(value * scale));
+}
+
+// =======================================================
+//   BATCH ENCODER
+// =======================================================
+
+static size_t encode_sample(const VatSensorData& sample, uint8_t* out, size_t size) {
+    CborWriter w = {out, out + size, true};
+    put_head(w, CBOR_MAJOR_MAP, 6);
+
+    // Sampel tanpa waktu GPS memakai jam sistem (null jika belum sinkron)
+    time_t timestamp;
+    put_int(w, CBOR_KEY_TIMESTAMP);
+    if (sample_utc_epoch(sample, timestamp) || system_clock_epoch(timestamp)) {
+        put_int(w, (int64_t)timestamp);
+    } else {
+        put_byte(w, CBOR_NULL);
+    }
+
+    put_int(w, CBOR_KEY_LAT);
+    put_fixed(w, sample.latitude, 1e7);
+    put_int(w, CBOR_KEY_LON);
+    put_fixed(w, sample.longitude, 1e7);
+    put_int(w, CBOR_KEY_ALT);
+    put_fixed(w, sample.depth, 100);
+    put_int(w, CBOR_KEY_DIST1);
+    put_fixed(w, sample.distance1, 100);
+    put_int(w, CBOR_KEY_DIST2);
+    put_fixed(w, sample.distance2, 100);
+
+    return w.ok ? (size_t)(w.pos - out) : 0;
+}
+
+size_t encode_cbor_batch(const VatSensorData* samples, size_t count, const char* device_id,
+                         uint8_t* out, size_t size, size_t& packed) {
+    packed = 0;
+    if (out == NULL || count == 0) return 0;
+
+    CborWriter w = {out, out + size, true};
+    put_head(w, CBOR_MAJOR_MAP, 3);
+    put_int(w, CBOR_KEY_VERSION);
+    put_int(w, TELEMETRY_CBOR_VERSION);
+    put_int(w, CBOR_KEY_DEVICE_ID);
+    put_text(w, device_id);
+    put_int(w, CBOR_KEY_SAMPLES);
+    put_byte(w, CBOR_ARRAY_INDEFINITE);
+    if (!w.ok) return 0;
+
+    // Tambahkan sampel selama masih ada ruang untuk sampel + byte break
+    uint8_t item[CBOR_SAMPLE_MAX_SIZE];
+    for (size_t i = 0; i < count; i++) {
+        size_t length = encode_sample(samples[i], item, sizeof(item));
+        if (length == 0 || (size_t)(w.end - w.pos) < length + 1) break;
+
+        memcpy(w.pos, item, length);
+        w.pos += length;
+        packed++;
+    }
+
+    if (packed == 0) return 0;
+    put_byte(w, CBOR_BREAK);
+    return (size_t)(w.pos - out);
+}
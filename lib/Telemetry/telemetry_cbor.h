@@ -0,0 +1,45 @@
+#ifndef TELEMETRY_CBOR_H
+#define TELEMETRY_CBOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../VatSensor/vat_sensor_data.h"
+
+// Versi format batch CBOR (key 0 di map utama)
+#define TELEMETRY_CBOR_VERSION 1
+
+// Key map utama
+#define CBOR_KEY_VERSION 0
+#define CBOR_KEY_DEVICE_ID 1
+#define CBOR_KEY_SAMPLES 2
+
+// Key per sampel (nilai fixed-point integer)
+#define CBOR_KEY_TIMESTAMP 0    // Detik Unix UTC, null jika waktu tidak diketahui
+#define CBOR_KEY_LAT 1          // Derajat x 1e7
+#define CBOR_KEY_LON 2          // Derajat x 1e7
+#define CBOR_KEY_ALT 3          // Depth x 100
+#define CBOR_KEY_DIST1 4        // Jarak x 100
+#define CBOR_KEY_DIST2 5        // Jarak x 100
+
+// Satu sampel CBOR paling besar (map 6 key, semua nilai 32-bit)
+#define CBOR_SAMPLE_MAX_SIZE 40
+
+/**
+ * @brief Encode batch sampel sebagai CBOR (lihat docs/API.md, "Binary Batch Request")
+ *
+ * Struktur: {0: versi, 1: deviceId, 2: [ {0: ts, 1: lat, 2: lon, 3: alt, 4: dist1, 5: dist2}, ... ]}.
+ * Array sampel memakai indefinite-length sehingga sampel bisa ditambahkan sampai
+ * buffer penuh tanpa menghitung jumlahnya lebih dulu.
+ *
+ * @param samples Sampel berurutan dari yang tertua
+ * @param count Jumlah sampel tersedia
+ * @param device_id ID device
+ * @param out Buffer tujuan
+ * @param size Ukuran buffer
+ * @param packed Diisi jumlah sampel (dari awal array) yang masuk ke body
+ * @return Panjang body dalam byte, 0 jika tidak ada sampel yang muat
+ */
+size_t encode_cbor_batch(const VatSensorData* samples, size_t count, const char* device_id,
+                         uint8_t* out, size_t size, size_t& packed);
+
+#endif // TELEMETRY_CBOR_H
@@ -0,0 +1,140 @@
+#include "telemetry_delta.h"
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "telemetry_json.h"
+
+// Kolom dalam urutan penulisan
+enum DeltaColumn {
+    COLUMN_TIMESTAMP,
+    COLUMN_LAT,
+    COLUMN_LON,
+    COLUMN_DEPTH,
+    COLUMN_DIST1,
+    COLUMN_DIST2,
+    COLUMN_COUNT
+};
+
+// =======================================================
+//   FIXED-POINT
+// =======================================================
+
+static int32_t to_e7(double degrees) {
+    if (isnan(degrees) || isinf(degrees) || fabs(degrees) > 180.0) return DELTA_MISSING_COORD;
+    return (int32_t)llround(degrees * 1e7);
+}
+
+// Jarak/depth dalam cm (float) ke milimeter int16
+static int16_t to_mm(float centimeters) {
+    if (isnan(centimeters) || isinf(centimeters)) return DELTA_MISSING_MM;
+    long mm = lroundf(centimeters * 10.0f);
+    if (mm <= INT16_MIN) return INT16_MIN + 1;
+    if (mm > INT16_MAX) return INT16_MAX;
+    return (int16_t)mm;
+}
+
+void to_fixed_sample(const VatSensorData& sample, uint32_t nowUtc, FixedSample& fixed) {
+    time_t timestamp;
+    fixed.timestamp = sample_utc_epoch(sample, timestamp) ? (uint32_t)timestamp : nowUtc;
+    fixed.latitudeE7 = to_e7(sample.latitude);
+    fixed.longitudeE7 = to_e7(sample.longitude);
+    fixed.depthMm = to_mm(sample.depth);
+    fixed.distance1Mm = to_mm(sample.distance1);
+    fixed.distance2Mm = to_mm(sample.distance2);
+}
+
+static int64_t column_value(const FixedSample& fixed, uint8_t column) {
+    switch (column) {
+        case COLUMN_TIMESTAMP: return fixed.timestamp;
+        case COLUMN_LAT:       return fixed.latitudeE7;
+        case COLUMN_LON:       return fixed.longitudeE7;
+        case COLUMN_DEPTH:     return fixed.depthMm;
+        case COLUMN_DIST1:     return fixed.distance1Mm;
+        default:               return fixed.distance2Mm;
+    }
+}
+
+// =======================================================
+//   VARINT
+// =======================================================
+
+static uint64_t zigzag(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static size_t varint_size(uint64_t value) {
+    size_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+static uint8_t* put_varint(uint8_t* pos, uint64_t value) {
+    while (value >= 0x80) {
+        *pos++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *pos++ = (uint8_t)value;
+    return pos;
+}
+
+// =======================================================
+//   BATCH ENCODER
+// =======================================================
+
+size_t encode_delta_batch(const VatSensorData* samples, size_t count, const char* device_id,
+                          uint8_t* out, size_t size, size_t& packed) {
+    packed = 0;
+    if (out == NULL || count == 0) return 0;
+
+    // Satu "sekarang" untuk seluruh batch agar ukuran pass 1 dan isi pass 2 sama
+    time_t now;
+    uint32_t nowUtc = system_clock_epoch(now) ? (uint32_t)now : DELTA_MISSING_TIME;
+
+    size_t idLength = strlen(device_id);
+    size_t header = 3 + varint_size(idLength) + idLength + varint_size(count);
+    if (header > size) return 0;
+
+    // Pass 1: hitung berapa sampel yang muat (kolom tidak bisa dipotong setelah ditulis)
+    FixedSample previous = {0};
+    FixedSample current;
+    size_t total = header;
+    for (size_t i = 0; i < count; i++) {
+        to_fixed_sample(samples[i], nowUtc, current);
+
+        size_t cost = 0;
+        for (uint8_t column = 0; column < COLUMN_COUNT; column++) {
+            cost += varint_size(zigzag(column_value(current, column) - column_value(previous, column)));
+        }
+        if (total + cost > size) break;
+
+        total += cost;
+        previous = current;
+        packed++;
+    }
+    if (packed == 0) return 0;
+
+    // Pass 2: tulis header lalu kolom satu per satu
+    uint8_t* pos = out;
+    *pos++ = TELEMETRY_DELTA_MAGIC0;
+    *pos++ = TELEMETRY_DELTA_MAGIC1;
+    *pos++ = TELEMETRY_DELTA_VERSION;
+    pos = put_varint(pos, idLength);
+    memcpy(pos, device_id, idLength);
+    pos += idLength;
+    pos = put_varint(pos, packed);
+
+    for (uint8_t column = 0; column < COLUMN_COUNT; column++) {
+        int64_t last = 0;
+        for (size_t i = 0; i < packed; i++) {
+            to_fixed_sample(samples[i], nowUtc, current);
+            int64_t value = column_value(current, column);
+            pos = put_varint(pos, zigzag(value - last));
+            last = value;
+        }
+    }
+
+    return (size_t)(pos - out);
+}
@@ -0,0 +1,55 @@
+#ifndef TELEMETRY_DELTA_H
+#define TELEMETRY_DELTA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../VatSensor/vat_sensor_data.h"
+
+// Header frame: 'V' 'D' <versi>
+#define TELEMETRY_DELTA_MAGIC0 'V'
+#define TELEMETRY_DELTA_MAGIC1 'D'
+#define TELEMETRY_DELTA_VERSION 1
+#define TELEMETRY_DELTA_CONTENT_TYPE "application/vnd.vatsubsoil.delta"
+
+// Nilai tidak tersedia (NaN / waktu tidak diketahui)
+#define DELTA_MISSING_COORD INT32_MIN
+#define DELTA_MISSING_MM INT16_MIN
+#define DELTA_MISSING_TIME 0
+
+/**
+ * @brief Satu sampel dalam bentuk fixed-point (tanpa kehilangan presisi sensor)
+ *
+ * lat/lon: derajat x 1e7 (~1 cm), jarak/depth: milimeter, waktu: detik Unix UTC.
+ */
+struct FixedSample {
+    uint32_t timestamp;
+    int32_t latitudeE7;
+    int32_t longitudeE7;
+    int16_t depthMm;
+    int16_t distance1Mm;
+    int16_t distance2Mm;
+};
+
+/**
+ * @brief Konversi sampel ke fixed-point
+ * @param nowUtc Waktu pengganti untuk sampel tanpa waktu GPS (DELTA_MISSING_TIME jika tidak ada)
+ */
+void to_fixed_sample(const VatSensorData& sample, uint32_t nowUtc, FixedSample& fixed);
+
+/**
+ * @brief Encode batch secara kolom: setiap kolom di-delta terhadap sampel sebelumnya
+ *        lalu ditulis sebagai zigzag varint (lihat docs/API.md, "Delta Batch Request")
+ *
+ * Layout: 'V' 'D' versi | varint len + deviceId | varint jumlah |
+ *         kolom timestamp | lat | lon | depth | dist1 | dist2
+ *
+ * Sampel traktor yang berurutan hanya berbeda beberapa cm / mikro-derajat sehingga
+ * kebanyakan delta muat di 1 byte.
+ *
+ * @param packed Diisi jumlah sampel (dari awal array) yang muat di buffer
+ * @return Panjang frame dalam byte, 0 jika tidak ada sampel yang muat
+ */
+size_t encode_delta_batch(const VatSensorData* samples, size_t count, const char* device_id,
+                          uint8_t* out, size_t size, size_t& packed);
+
+#endif // TELEMETRY_DELTA_H
@@ -0,0 +1,184 @@
+#include "telemetry_json.h"
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include "../../include/config.h"
+
+// =======================================================
+//   BUFFER WRITER
+// =======================================================
+
+// Penulis sekuensial ke buffer caller; ok = false begitu ada yang tidak muat
+struct JsonWriter {
+    char* pos;
+    char* end;      // Posisi terakhir yang boleh ditulis ('\0' disisakan)
+    bool ok;
+};
+
+static void put_char(JsonWriter& w, char c) {
+    if (w.pos >= w.end) {
+        w.ok = false;
+        return;
+    }
+    *w.pos++ = c;
+}
+
+static void put_raw(JsonWriter& w, const char* s) {
+    while (*s) put_char(w, *s++);
+}
+
+static void put_string(JsonWriter& w, const char* s) {
+    put_char(w, '"');
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') put_char(w, '\\');
+        if ((uint8_t)*s < 0x20) continue;  // Karakter kontrol dibuang
+        put_char(w, *s);
+    }
+    put_char(w, '"');
+}
+
+static void put_uint(JsonWriter& w, uint64_t value, uint8_t min_digits) {
+    char digits[20];
+    uint8_t count = 0;
+    do {
+        digits[count++] = '0' + (value % 10);
+        value /= 10;
+    } while (value > 0 && count < sizeof(digits));
+
+    while (count < min_digits) digits[count++] = '0';
+    while (count > 0) put_char(w, digits[--count]);
+}
+
+// Angka fixed-point: dibulatkan ke 'decimals' desimal, NaN/Inf ditulis null
+static void put_fixed(JsonWriter& w, double value, uint8_t decimals) {
+    if (isnan(value) || isinf(value)) {
+        put_raw(w, "null");
+        return;
+    }
+
+    uint64_t scale = 1;
+    for (uint8_t i = 0; i < decimals; i++) scale *= 10;
+
+    // Di luar jangkauan uint64 (cast-nya UB) - sama seperti Inf, ditulis null
+    double scaled = fabs(value) * (double)scale + 0.5;
+    if (scaled >= 9223372036854775808.0) {  // 2^63
+        put_raw(w, "null");
+        return;
+    }
+    uint64_t units = (uint64_t)scaled;
+    if (value < 0 && units > 0) put_char(w, '-');
+
+    put_uint(w, units / scale, 1);
+    if (decimals > 0) {
+        put_char(w, '.');
+        put_uint(w, units % scale, decimals);
+    }
+}
+
+// =======================================================
+//   TIMESTAMP
+// =======================================================
+
+// Jumlah hari sejak 1970-01-01 untuk tanggal Gregorian (tanpa tabel, tanpa heap)
+static int32_t days_from_civil(int32_t y, uint32_t m, uint32_t d) {
+    y -= m <= 2;
+    int32_t era = (y >= 0 ? y : y - 399) / 400;
+    uint32_t yoe = (uint32_t)(y - era * 400);
+    uint32_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int32_t)doe - 719468;
+}
+
+size_t format_wib_epoch(time_t utc_seconds, char* out, size_t size) {
+    if (size < WIB_TIMESTAMP_SIZE) return 0;
+
+    time_t wib_seconds = utc_seconds + TIMEZONE_OFFSET;
+    struct tm wib_tm;
+    gmtime_r(&wib_seconds, &wib_tm);
+
+    JsonWriter w = {out, out + size - 1, true};
+    put_uint(w, wib_tm.tm_year + 1900, 4);
+    put_char(w, '-');
+    put_uint(w, wib_tm.tm_mon + 1, 2);
+    put_char(w, '-');
+    put_uint(w, wib_tm.tm_mday, 2);
+    put_char(w, 'T');
+    put_uint(w, wib_tm.tm_hour, 2);
+    put_char(w, ':');
+    put_uint(w, wib_tm.tm_min, 2);
+    put_char(w, ':');
+    put_uint(w, wib_tm.tm_sec, 2);
+    put_raw(w, "+07:00");
+    *w.pos = '\0';
+    return w.ok ? (size_t)(w.pos - out) : 0;
+}
+
+bool sample_utc_epoch(const VatSensorData& sample, time_t& utc_seconds) {
+    if (!sample.isValid || sample.month < 1 || sample.month > 12) return false;
+
+    int64_t days = days_from_civil(sample.year, sample.month, sample.day);
+    utc_seconds = (time_t)(days * 86400 + sample.hour * 3600 + sample.minute * 60 + sample.second);
+    return true;
+}
+
+size_t format_wib_timestamp(const VatSensorData& sample, char* out, size_t size) {
+    time_t utc_seconds;
+    if (!sample_utc_epoch(sample, utc_seconds)) return 0;
+    return format_wib_epoch(utc_seconds, out, size);
+}
+
+bool system_clock_epoch(time_t& utc_seconds) {
+    utc_seconds = time(NULL);
+    return utc_seconds >= 1577836800;  // Sebelum 2020-01-01 = jam belum disinkronkan
+}
+
+size_t format_wib_timestamp_now(char* out, size_t size) {
+    time_t now;
+    if (!system_clock_epoch(now)) return 0;
+    return format_wib_epoch(now, out, size);
+}
+
+// =======================================================
+//   PRODUCTION SCHEMA
+// =======================================================
+
+size_t encode_production_json(const VatSensorData& sample, const char* device_id,
+                              const char* timestamp, char* out, size_t size) {
+    if (out == NULL || size == 0) return 0;
+
+    char sampleTime[WIB_TIMESTAMP_SIZE];
+    if (timestamp == NULL) {
+        size_t length = sample.isValid ? format_wib_timestamp(sample, sampleTime, sizeof(sampleTime))
+                                       : format_wib_timestamp_now(sampleTime, sizeof(sampleTime));
+        if (length > 0) timestamp = sampleTime;
+    }
+
+    JsonWriter w = {out, out + size - 1, true};
+    put_raw(w, "{\"type\":\"sensor\",\"deviceId\":");
+    put_string(w, device_id);
+
+    put_raw(w, ",\"gps\":{\"lat\":");
+    put_fixed(w, sample.latitude, 7);
+    put_raw(w, ",\"lon\":");
+    put_fixed(w, sample.longitude, 7);
+    put_raw(w, ",\"alt\":");
+    put_fixed(w, sample.depth, 2);  // Pakai depth sebagai altitude
+    put_raw(w, ",\"sog\":0,\"cog\":0}");
+
+    put_raw(w, ",\"ultrasonic\":{\"dist1\":");
+    put_fixed(w, sample.distance1, 2);
+    put_raw(w, ",\"dist2\":");
+    put_fixed(w, sample.distance2, 2);
+
+    put_raw(w, "},\"timestamp\":");
+    if (timestamp != NULL) {
+        put_string(w, timestamp);
+    } else {
+        put_raw(w, "null");
+    }
+    put_char(w, '}');
+
+    *w.pos = '\0';
+    return w.ok ? (size_t)(w.pos - out) : 0;
+}
@@ -0,0 +1,60 @@
+#ifndef TELEMETRY_JSON_H
+#define TELEMETRY_JSON_H
+
+#include <stddef.h>
+#include <time.h>
+#include "../VatSensor/vat_sensor_data.h"
+
+// "YYYY-MM-DDTHH:MM:SS+07:00" + '\0'
+#define WIB_TIMESTAMP_SIZE 26
+
+// Satu sampel production schema (deviceId <= 32 karakter) selalu muat di buffer ini
+#define PRODUCTION_JSON_MAX_SIZE 256
+
+/**
+ * @brief Waktu sampel (field UTC di VatSensorData) sebagai detik Unix
+ * @return false jika sampel tidak punya waktu
+ */
+bool sample_utc_epoch(const VatSensorData& sample, time_t& utc_seconds);
+
+/**
+ * @brief Jam sistem saat ini sebagai detik Unix
+ * @return false jika jam sistem belum disinkronkan (GPS/NTP/GSM)
+ */
+bool system_clock_epoch(time_t& utc_seconds);
+
+/**
+ * @brief Tulis detik Unix UTC sebagai ISO 8601 WIB ("YYYY-MM-DDTHH:MM:SS+07:00")
+ * @return Panjang string, 0 jika buffer terlalu kecil
+ */
+size_t format_wib_epoch(time_t utc_seconds, char* out, size_t size);
+
+/**
+ * @brief Tulis waktu sampel (UTC di VatSensorData) sebagai ISO 8601 WIB
+ * @return Panjang string, 0 jika sampel tidak punya waktu atau buffer terlalu kecil
+ */
+size_t format_wib_timestamp(const VatSensorData& sample, char* out, size_t size);
+
+/**
+ * @brief Tulis jam sistem (GPS/NTP/GSM) saat ini sebagai ISO 8601 WIB
+ * @return Panjang string, 0 jika jam sistem belum disinkronkan
+ */
+size_t format_wib_timestamp_now(char* out, size_t size);
+
+/**
+ * @brief Encode satu sampel ke body JSON production API tanpa heap
+ *
+ * Format: {"type":"sensor","deviceId":..,"gps":{"lat","lon","alt","sog","cog"},
+ * "ultrasonic":{"dist1","dist2"},"timestamp":..}. Angka ditulis fixed-point
+ * (lat/lon 7 desimal, alt/dist 2 desimal) tanpa printf float.
+ *
+ * @param device_id ID device (di-escape sebagai string JSON)
+ * @param timestamp Timestamp ISO yang dipakai; NULL = waktu sampel, atau jam sistem
+ *                  jika sampel tidak punya waktu (null jika keduanya tidak ada)
+ * @param out Buffer tujuan, selalu diakhiri '\0' jika berhasil
+ * @return Panjang JSON tanpa '\0', 0 jika buffer tidak cukup
+ */
+size_t encode_production_json(const VatSensorData& sample, const char* device_id,
+                              const char* timestamp, char* out, size_t size);
+
+#endif // TELEMETRY_JSON_H
@@ -0,0 +1,214 @@
+#include "sensor_transport.h"
+
+// =======================================================
+//   SOFTWARE SERIAL TRANSPORT
+// =======================================================
+
+SoftSerialTransport::SoftSerialTransport(int rx_pin, int tx_pin)
+    : serial(rx_pin, tx_pin) {
+}
+
+bool SoftSerialTransport::begin(unsigned long baud) {
+    serial.begin(baud);
+    return true;
+}
+
+int SoftSerialTransport::available() {
+    return serial.available();
+}
+
+int SoftSerialTransport::read() {
+    return serial.read();
+}
+
+// =======================================================
+//   HARDWARE UART TRANSPORT
+// =======================================================
+
+HardwareUartTransport::HardwareUartTransport(int uart_num, int rx_pin, int tx_pin)
+    : serial(uart_num), rxPin(rx_pin), txPin(tx_pin) {
+}
+
+bool HardwareUartTransport::begin(unsigned long baud) {
+    serial.begin(baud, SERIAL_8N1, rxPin, txPin);
+    return true;
+}
+
+int HardwareUartTransport::available() {
+    return serial.available();
+}
+
+int HardwareUartTransport::read() {
+    return serial.read();
+}
+
+// =======================================================
+//   RMT UART TRANSPORT
+// =======================================================
+
+RmtUartTransport::RmtUartTransport(int rmt_channel, int rx_pin) {
+    channel = (rmt_channel_t)rmt_channel;
+    rxPin = (gpio_num_t)rx_pin;
+    ringbuf = NULL;
+    bitTicks = 0;
+    started = false;
+    bitIndex = -1;
+    currentByte = 0;
+    framingErrors = 0;
+    fifoHead = 0;
+    fifoCount = 0;
+}
+
+bool RmtUartTransport::begin(unsigned long baud) {
+    // 1 tick = 1 us (APB 80 MHz / 80)
+    bitTicks = 1000000UL / baud;
+
+    rmt_config_t config = RMT_DEFAULT_CONFIG_RX(rxPin, channel);
+    config.clk_div = 80;
+    config.mem_block_num = 1;
+    config.rx_config.filter_en = true;
+    config.rx_config.filter_ticks_thresh = RMT_UART_FILTER_APB_TICKS;
+    config.rx_config.idle_threshold = bitTicks * RMT_UART_IDLE_BITS;
+
+    if (rmt_config(&config) != ESP_OK) {
+        Serial.println("❌ RMT config failed");
+        return false;
+    }
+    if (rmt_driver_install(channel, RMT_UART_RINGBUF_SIZE, 0) != ESP_OK) {
+        Serial.println("❌ RMT driver install failed");
+        return false;
+    }
+    if (rmt_get_ringbuf_handle(channel, &ringbuf) != ESP_OK || ringbuf == NULL) {
+        Serial.println("❌ RMT ringbuffer unavailable");
+        return false;
+    }
+
+    rmt_rx_start(channel, true);
+    started = true;
+    return true;
+}
+
+int RmtUartTransport::available() {
+    pump();
+    return fifoCount;
+}
+
+int RmtUartTransport::read() {
+    if (fifoCount == 0) {
+        pump();
+        if (fifoCount == 0) return -1;
+    }
+
+    uint8_t value = fifo[fifoHead];
+    fifoHead = (fifoHead + 1) % RMT_UART_FIFO_SIZE;
+    fifoCount--;
+    return value;
+}
+
+void RmtUartTransport::pump() {
+    if (!started) return;
+
+    // Ambil semua burst yang sudah selesai direkam, tanpa menunggu (timeout 0)
+    size_t rxSize = 0;
+    rmt_item32_t* items = (rmt_item32_t*)xRingbufferReceive(ringbuf, &rxSize, 0);
+    while (items != NULL) {
+        decodeItems(items, rxSize / sizeof(rmt_item32_t));
+        vRingbufferReturnItem(ringbuf, (void*)items);
+        items = (rmt_item32_t*)xRingbufferReceive(ringbuf, &rxSize, 0);
+    }
+}
+
+void RmtUartTransport::decodeItems(const rmt_item32_t* items, size_t count) {
+    bitIndex = -1;
+
+    for (size_t i = 0; i < count; i++) {
+        uint32_t durations[2] = {items[i].duration0, items[i].duration1};
+        uint8_t levels[2] = {(uint8_t)items[i].level0, (uint8_t)items[i].level1};
+
+        for (int half = 0; half < 2; half++) {
+            if (durations[half] == 0) {
+                // Akhir burst: garis kembali idle (high), selesaikan byte yang tertunda
+                pushLevel(1, 10);
+                bitIndex = -1;
+                return;
+            }
+
+            uint32_t bits = (durations[half] + bitTicks / 2) / bitTicks;
+            pushLevel(levels[half], bits == 0 ? 1 : bits);
+        }
+    }
+
+    // Burst terpotong tanpa penanda akhir - anggap idle
+    pushLevel(1, 10);
+    bitIndex = -1;
+}
+
+void RmtUartTransport::pushLevel(uint8_t level, uint32_t bits) {
+    for (uint32_t b = 0; b < bits; b++) {
+        if (bitIndex < 0) {
+            // Idle high - sisa bit di level yang sama tidak perlu diproses
+            if (level) return;
+
+            // Start bit
+            bitIndex = 0;
+            currentByte = 0;
+            continue;
+        }
+
+        if (bitIndex < 8) {
+            currentByte |= (level & 0x01) << bitIndex;
+            bitIndex++;
+            continue;
+        }
+
+        // Stop bit harus high
+        if (level) {
+            pushByte(currentByte);
+        } else {
+            framingErrors++;
+        }
+        bitIndex = -1;
+    }
+}
+
+void RmtUartTransport::pushByte(uint8_t value) {
+    if (fifoCount >= RMT_UART_FIFO_SIZE) {
+        // FIFO penuh - buang byte tertua, parser akan resync sendiri
+        fifoHead = (fifoHead + 1) % RMT_UART_FIFO_SIZE;
+        fifoCount--;
+    }
+
+    uint16_t tail = (fifoHead + fifoCount) % RMT_UART_FIFO_SIZE;
+    fifo[tail] = value;
+    fifoCount++;
+}
+
+// =======================================================
+//   FACTORY
+// =======================================================
+
+// UART hardware yang sudah dipakai (bit per nomor UART)
+static uint8_t claimedUarts = (1 << 0) | (1 << GPS_UART_NUM)   // Console + GPS
+#if USE_GSM
+                            | (1 << 1)                          // Modem SIM800 (gsmSerial)
+#endif
+                            ;
+
+SensorTransport* create_sensor_transport(int transport, int rx_pin, int tx_pin, int uart_num, int rmt_channel) {
+    switch (transport) {
+        case SENSOR_TRANSPORT_UART:
+            if (uart_num < 0 || uart_num > 2 ||   // ESP32: UART0..UART2
+                (claimedUarts & (1 << uart_num))) {
+                Serial.printf("⚠️ UART%d unavailable (invalid or in use) - sensor on pin %d falls back to RMT channel %d\n",
+                              uart_num, rx_pin, rmt_channel);
+                return new RmtUartTransport(rmt_channel, rx_pin);
+            }
+            claimedUarts |= 1 << uart_num;
+            return new HardwareUartTransport(uart_num, rx_pin, tx_pin);
+        case SENSOR_TRANSPORT_RMT:
+            return new RmtUartTransport(rmt_channel, rx_pin);
+        case SENSOR_TRANSPORT_SOFTSERIAL:
+        default:
+            return new SoftSerialTransport(rx_pin, tx_pin);
+    }
+}
@@ -0,0 +1,107 @@
+#ifndef SENSOR_TRANSPORT_H
+#define SENSOR_TRANSPORT_H
+
+#include <Arduino.h>
+#include <HardwareSerial.h>
+#include <SoftwareSerial.h>
+#include "driver/rmt.h"
+#include "freertos/ringbuf.h"
+#include "../../include/config.h"
+
+/**
+ * @brief Sumber byte untuk satu sensor ultrasonik (A02YYUW-style, 9600 8N1)
+ *
+ * Semua implementasi non-blocking: available()/read() hanya mengambil byte yang
+ * sudah diterima hardware, sehingga UltrasonicFrameParser bisa dipakai di atasnya
+ * tanpa peduli transport yang dipilih di config.h.
+ */
+class SensorTransport {
+public:
+    virtual ~SensorTransport() {}
+    virtual bool begin(unsigned long baud) = 0;
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual const char* name() const = 0;
+};
+
+// EspSoftwareSerial - bit-bang di interrupt, hanya untuk kompatibilitas
+class SoftSerialTransport : public SensorTransport {
+public:
+    SoftSerialTransport(int rx_pin, int tx_pin);
+    bool begin(unsigned long baud) override;
+    int available() override;
+    int read() override;
+    const char* name() const override { return "SoftwareSerial"; }
+
+private:
+    SoftwareSerial serial;
+};
+
+// UART hardware ESP32 (UART0 = console, UART2 = GPS, UART1 dipakai modem di build GSM)
+class HardwareUartTransport : public SensorTransport {
+public:
+    HardwareUartTransport(int uart_num, int rx_pin, int tx_pin);
+    bool begin(unsigned long baud) override;
+    int available() override;
+    int read() override;
+    const char* name() const override { return "HardwareUART"; }
+
+private:
+    HardwareSerial serial;
+    int rxPin;
+    int txPin;
+};
+
+/**
+ * @brief Penerima UART berbasis RMT
+ *
+ * Periferal RMT merekam durasi level pin RX tanpa interrupt per bit. Setiap burst
+ * (frame sensor) diakhiri idle > RMT_UART_IDLE_BITS bit, lalu didekode menjadi byte
+ * 8N1 saat available()/read() dipanggil.
+ */
+class RmtUartTransport : public SensorTransport {
+public:
+    RmtUartTransport(int rmt_channel, int rx_pin);
+    bool begin(unsigned long baud) override;
+    int available() override;
+    int read() override;
+    const char* name() const override { return "RMT"; }
+
+    uint32_t getFramingErrors() const { return framingErrors; }
+
+private:
+    void pump();
+    void decodeItems(const rmt_item32_t* items, size_t count);
+    void pushLevel(uint8_t level, uint32_t bits);
+    void pushByte(uint8_t value);
+
+    rmt_channel_t channel;
+    gpio_num_t rxPin;
+    RingbufHandle_t ringbuf;
+    uint32_t bitTicks;
+    bool started;
+
+    // Decoder state
+    int8_t bitIndex;  // -1 = menunggu start bit, 0..7 = data bit, 8 = stop bit
+    uint8_t currentByte;
+    uint32_t framingErrors;
+
+    // FIFO byte hasil decode
+    uint8_t fifo[RMT_UART_FIFO_SIZE];
+    uint16_t fifoHead;
+    uint16_t fifoCount;
+};
+
+/**
+ * @brief Buat transport sesuai pilihan config.h
+ * @param transport SENSOR_TRANSPORT_SOFTSERIAL / SENSOR_TRANSPORT_UART / SENSOR_TRANSPORT_RMT
+ * @param rx_pin Pin ESP32 yang menerima data (pin TX sensor)
+ * @param tx_pin Pin ESP32 ke RX sensor (tidak dipakai oleh RMT)
+ * @param uart_num Nomor UART hardware (untuk SENSOR_TRANSPORT_UART); UART yang sudah dipakai
+ *                 (console, GPS, modem, sensor lain) ditolak dan diganti transport RMT
+ * @param rmt_channel Channel RMT (untuk SENSOR_TRANSPORT_RMT)
+ * @return Transport baru (tidak pernah dihapus, umur sama dengan firmware)
+ */
+SensorTransport* create_sensor_transport(int transport, int rx_pin, int tx_pin, int uart_num, int rmt_channel);
+
+#endif // SENSOR_TRANSPORT_H
@@ -1,27 +1,48 @@
 #include <Arduino.h>
 #include <HardwareSerial.h>
-#include <SoftwareSerial.h>
 #include <TinyGPS++.h>
+#include <time.h>
 #include "../../include/config.h"
 #include "sensors.h"
+#include "sensor_transport.h"
 
 // --- OBJEK SENSOR & GPS ---
 TinyGPSPlus gps;
-HardwareSerial gpsSerial(2);     // Use Serial2 for GPS seperti kode yang bekerja
-SoftwareSerial sensorSerial1(32, 33); // Pin order seperti kode yang bekerja: (TX, RX)
-SoftwareSerial sensorSerial2(19, 18); // Pin order seperti kode yang bekerja: (TX, RX)
+HardwareSerial gpsSerial(GPS_UART_NUM);     // Use Serial2 for GPS seperti kode yang bekerja
 
 // --- VARIABEL DATA SENSOR ---
 float distance1 = 0.0;
 float distance2 = 0.0;
-float latitude = 0.0;
-float longitude = 0.0;
+double latitude = 0.0;   // double: float 32-bit hanya ~7 digit (lebih kasar dari 1e-7 derajat)
+double longitude = 0.0;
 float altitude = 0.0;
 
-byte data_buffer1[4];
-byte CS1;
-byte data_buffer2[4];
-byte CS2;
+// Konfigurasi kanal sensor ultrasonik (transport dipilih per sensor di config.h)
+struct UltrasonicChannelConfig {
+    int transport;
+    int rxPin;      // Pin TX sensor -> RX ESP32
+    int txPin;      // Pin RX sensor
+    int uartNum;
+    int rmtChannel;
+};
+
+static const UltrasonicChannelConfig ultrasonicConfig[ULTRASONIC_SENSOR_COUNT] = {
+    {SENSOR1_TRANSPORT, SENSOR1_TX_PIN, SENSOR1_RX_PIN, SENSOR1_UART_NUM, SENSOR1_RMT_CHANNEL},
+    {SENSOR2_TRANSPORT, SENSOR2_TX_PIN, SENSOR2_RX_PIN, SENSOR2_UART_NUM, SENSOR2_RMT_CHANNEL},
+#if ULTRASONIC_SENSOR_COUNT > 2
+    {SENSOR3_TRANSPORT, SENSOR3_TX_PIN, SENSOR3_RX_PIN, SENSOR3_UART_NUM, SENSOR3_RMT_CHANNEL},
+#endif
+};
+
+// Transport + parser frame untuk masing-masing sensor ultrasonik
+static SensorTransport* ultrasonicTransports[ULTRASONIC_SENSOR_COUNT];
+static UltrasonicFrameParser ultrasonicParsers[ULTRASONIC_SENSOR_COUNT] = {
+    UltrasonicFrameParser(1),
+    UltrasonicFrameParser(2),
+#if ULTRASONIC_SENSOR_COUNT > 2
+    UltrasonicFrameParser(3),
+#endif
+};
 
 void setup_sensors() {
     Serial.println("🔧 Starting sensor setup...");
@@ -36,76 +57,88 @@ void setup_sensors() {
     gpsSerial.begin(GPS_BAUD, SERIAL_8N1, GPS_RX_PIN, GPS_TX_PIN);
     delay(100);
     
-    // Setup Sensor Serial - menggunakan konstanta dari config.h
+    // Setup transport sensor ultrasonik - menggunakan konfigurasi dari config.h
     Serial.println("📏 Setting up Ultrasonic Sensors...");
-    Serial.print("  Sensor1: TX=");
-    Serial.print(SENSOR1_TX_PIN);
-    Serial.print(", RX=");
-    Serial.println(SENSOR1_RX_PIN);
-    Serial.print("  Sensor2: TX=");
-    Serial.print(SENSOR2_TX_PIN);
-    Serial.print(", RX=");
-    Serial.println(SENSOR2_RX_PIN);
+    for (int i = 0; i < ULTRASONIC_SENSOR_COUNT; i++) {
+        const UltrasonicChannelConfig& cfg = ultrasonicConfig[i];
+        ultrasonicTransports[i] = create_sensor_transport(cfg.transport, cfg.rxPin, cfg.txPin,
+                                                          cfg.uartNum, cfg.rmtChannel);
+        bool ok = ultrasonicTransports[i]->begin(SENSOR_BAUD_RATE);
+        
+        Serial.print("  Sensor");
+        Serial.print(i + 1);
+        Serial.print(": ");
+        Serial.print(ultrasonicTransports[i]->name());
+        Serial.print(", TX=");
+        Serial.print(cfg.rxPin);
+        Serial.print(", RX=");
+        Serial.print(cfg.txPin);
+        Serial.println(ok ? " ✅" : " ❌");
+    }
     Serial.print("  Baud Rate: ");
     Serial.println(SENSOR_BAUD_RATE);
-    
-    sensorSerial1.begin(SENSOR_BAUD_RATE);
-    sensorSerial2.begin(SENSOR_BAUD_RATE);
     delay(100);
     
     Serial.println("✅ Sensor setup completed!");
 }
 
+static size_t poll_ultrasonic_sensor(SensorTransport& transport, UltrasonicFrameParser& parser,
+                                     UltrasonicFrame* frames, size_t maxFrames) {
+    size_t count = 0;
+    // Kuras semua byte yang sudah diterima transport tanpa menunggu (non-blocking)
+    while (count < maxFrames && transport.available() > 0) {
+        int value = transport.read();
+        if (value < 0) break;
+        if (parser.feed((uint8_t)value, millis(), frames[count])) {
+            count++;
+        }
+    }
+    return count;
+}
+
+size_t read_ultrasonic_frames(UltrasonicFrame* frames, size_t maxFrames) {
+    size_t count = 0;
+    for (int i = 0; i < ULTRASONIC_SENSOR_COUNT; i++) {
+        if (ultrasonicTransports[i] == NULL) continue;
+        count += poll_ultrasonic_sensor(*ultrasonicTransports[i], ultrasonicParsers[i],
+                                        frames + count, maxFrames - count);
+    }
+
+    // Update variabel global dengan frame terbaru dari masing-masing sensor
+    for (size_t i = 0; i < count; i++) {
+        float distanceCm = frames[i].distanceMm / 10.0; // Convert to cm
+        if (frames[i].sensorId == 1) {
+            distance1 = distanceCm;
+        } else if (frames[i].sensorId == 2) {
+            distance2 = distanceCm;
+        }
+    }
+    return count;
+}
+
+const UltrasonicParserStats& get_ultrasonic_stats(uint8_t sensorId) {
+    if (sensorId < 1 || sensorId > ULTRASONIC_SENSOR_COUNT) sensorId = 1;
+    return ultrasonicParsers[sensorId - 1].getStats();
+}
+
 void read_ultrasonic_sensors() {
     static unsigned long lastDebug = 0;
     bool debug = (millis() - lastDebug > SENSOR_DEBUG_INTERVAL);
     
+    UltrasonicFrame frames[ULTRASONIC_MAX_FRAMES_PER_READ];
+    size_t count = read_ultrasonic_frames(frames, ULTRASONIC_MAX_FRAMES_PER_READ);
+    
     if (debug) {
-        Serial.println("📏 Reading ultrasonic sensors...");
         lastDebug = millis();
-    }
-    
-    // Baca Sensor 1 - mengikuti kode yang bekerja
-    if (sensorSerial1.available() > 0) {
-        delay(SENSOR_READ_DELAY); // Delay dari config.h untuk stabilitas
-        if (sensorSerial1.read() == 0xff) {
-            data_buffer1[0] = 0xff;
-            for (int i = 1; i < 4; i++) {
-                data_buffer1[i] = sensorSerial1.read();
-            }
-            CS1 = data_buffer1[0] + data_buffer1[1] + data_buffer1[2];
-            if (data_buffer1[3] == CS1) {
-                distance1 = (data_buffer1[1] << 8) + data_buffer1[2];
-                distance1 = distance1 / 10.0; // Convert to cm
-                if (debug) {
-                    Serial.print("✅ Sensor1 valid reading: ");
-                    Serial.println(distance1);
-                }
-            } else if (debug) {
-                Serial.println("❌ Sensor1 checksum failed");
-            }
-        }
-    }
-
-    // Baca Sensor 2 - mengikuti kode yang bekerja
-    if (sensorSerial2.available() > 0) {
-        delay(SENSOR_READ_DELAY); // Delay dari config.h untuk stabilitas
-        if (sensorSerial2.read() == 0xff) {
-            data_buffer2[0] = 0xff;
-            for (int i = 1; i < 4; i++) {
-                data_buffer2[i] = sensorSerial2.read();
-            }
-            CS2 = data_buffer2[0] + data_buffer2[1] + data_buffer2[2];
-            if (data_buffer2[3] == CS2) {
-                distance2 = (data_buffer2[1] << 8) + data_buffer2[2];
-                distance2 = distance2 / 10.0; // Convert to cm
-                if (debug) {
-                    Serial.print("✅ Sensor2 valid reading: ");
-                    Serial.println(distance2);
-                }
-            } else if (debug) {
-                Serial.println("❌ Sensor2 checksum failed");
-            }
+        Serial.print("📏 Ultrasonic frames this read: ");
+        Serial.println(count);
+        for (uint8_t id = 1; id <= ULTRASONIC_SENSOR_COUNT; id++) {
+            const UltrasonicParserStats& stats = get_ultrasonic_stats(id);
+            Serial.printf("  Sensor%u: ok=%lu, checksum_err=%lu, discarded=%lu\n",
+                          id,
+                          (unsigned long)stats.framesOk,
+                          (unsigned long)stats.checksumErrors,
+                          (unsigned long)stats.bytesDiscarded);
         }
     }
 }
@@ -144,16 +177,60 @@ float calculate_depth() {
     return 2.84 * distance2 - 16.6;
 }
 
-void display_sensor_data() {
-    read_gps_data(); // pastikan data GPS terbaru
+void build_sensor_record(VatSensorData& record) {
+    record.distance1 = distance1;
+    record.distance2 = distance2;
+    record.latitude = latitude;
+    record.longitude = longitude;
+    record.depth = calculate_depth();
+    record.satellites = gps.satellites.isValid() ? gps.satellites.value() : 0;
+    record.hdop = gps.hdop.isValid() ? gps.hdop.hdop() : 0.0;
+    record.capturedAtMs = millis();
+    
+    // Waktu UTC: utamakan GPS, fallback ke jam sistem (NTP di build WiFi)
+    if (gps.date.isValid() && gps.time.isValid() && gps.date.year() >= 2020) {
+        record.year = gps.date.year();
+        record.month = gps.date.month();
+        record.day = gps.date.day();
+        record.hour = gps.time.hour();
+        record.minute = gps.time.minute();
+        record.second = gps.time.second();
+        record.isValid = true;
+        return;
+    }
+    
+    time_t now = time(NULL);
+    struct tm utc_tm;
+    if (now > 1577836800L && gmtime_r(&now, &utc_tm) != NULL) { // > 2020-01-01
+        record.year = utc_tm.tm_year + 1900;
+        record.month = utc_tm.tm_mon + 1;
+        record.day = utc_tm.tm_mday;
+        record.hour = utc_tm.tm_hour;
+        record.minute = utc_tm.tm_min;
+        record.second = utc_tm.tm_sec;
+        record.isValid = true;
+        return;
+    }
+    
+    record.year = 0;
+    record.month = 0;
+    record.day = 0;
+    record.hour = 0;
+    record.minute = 0;
+    record.second = 0;
+    record.isValid = false;
+}
+
+void display_sensor_data(const VatSensorData& sample) {
+    // Salinan sampel dari get_latest_sample() - global sensor hanya milik task akuisisi
     Serial.print("D1: ");
-    Serial.print(distance1);
+    Serial.print(sample.distance1);
     Serial.print(" cm, D2: ");
-    Serial.print(distance2);
+    Serial.print(sample.distance2);
     Serial.print(" cm, Lat: ");
-    Serial.print(latitude, 7);
+    Serial.print(sample.latitude, 7);
     Serial.print(", Lon: ");
-    Serial.print(longitude, 7);
+    Serial.print(sample.longitude, 7);
     Serial.print(", Kedalaman: ");
-    Serial.println(calculate_depth());
+    Serial.println(sample.depth);
 }
\ No newline at end of file
@@ -1,16 +1,28 @@
 #ifndef SENSORS_H
 #define SENSORS_H
 
+#include <TinyGPS++.h>
+#include "ultrasonic_frame.h"
+#include "vat_sensor_data.h"
+
+// Kapasitas frame per panggilan read_ultrasonic_sensors() (FIFO 64 byte per sensor = 16 frame)
+#define ULTRASONIC_MAX_FRAMES_PER_READ 32
+
 void setup_sensors();
 void read_ultrasonic_sensors();
+size_t read_ultrasonic_frames(UltrasonicFrame* frames, size_t maxFrames);
+const UltrasonicParserStats& get_ultrasonic_stats(uint8_t sensorId);
 void read_gps_data();
-void display_sensor_data();
+void display_sensor_data(const VatSensorData& sample);
 float calculate_depth();
+void build_sensor_record(VatSensorData& record);
 
+// Ditulis task akuisisi (read_*/build_sensor_record). Task lain membaca lewat
+// get_latest_sample() (task_pipeline.h) agar tidak melihat nilai setengah-tertulis.
 extern float distance1;
 extern float distance2;
-extern float latitude;
-extern float longitude;
+extern double latitude;
+extern double longitude;
 extern float altitude;
 extern TinyGPSPlus gps;
 
@@ -0,0 +1,89 @@
+#include "ultrasonic_frame.h"
+
+UltrasonicFrameParser::UltrasonicFrameParser(uint8_t sensor_id) {
+    sensorId = sensor_id;
+    stats.framesOk = 0;
+    stats.checksumErrors = 0;
+    stats.bytesDiscarded = 0;
+    reset();
+}
+
+void UltrasonicFrameParser::reset() {
+    state = WAIT_HEADER;
+    length = 0;
+    headerTimestampMs = 0;
+}
+
+bool UltrasonicFrameParser::feed(uint8_t byte, unsigned long nowMs, UltrasonicFrame& frame) {
+    switch (state) {
+        case WAIT_HEADER:
+            if (byte != ULTRASONIC_FRAME_HEADER) {
+                stats.bytesDiscarded++;
+                return false;
+            }
+            buffer[0] = byte;
+            byteTimestampMs[0] = nowMs;
+            length = 1;
+            headerTimestampMs = nowMs;
+            state = WAIT_HIGH;
+            return false;
+
+        case WAIT_HIGH:
+            byteTimestampMs[length] = nowMs;
+            buffer[length++] = byte;
+            state = WAIT_LOW;
+            return false;
+
+        case WAIT_LOW:
+            byteTimestampMs[length] = nowMs;
+            buffer[length++] = byte;
+            state = WAIT_CHECKSUM;
+            return false;
+
+        case WAIT_CHECKSUM: {
+            byteTimestampMs[length] = nowMs;
+            buffer[length++] = byte;
+            uint8_t checksum = (uint8_t)(buffer[0] + buffer[1] + buffer[2]);
+            if (checksum != byte) {
+                stats.checksumErrors++;
+                resync();
+                return false;
+            }
+
+            frame.sensorId = sensorId;
+            frame.distanceMm = ((uint16_t)buffer[1] << 8) | buffer[2];
+            frame.timestampMs = headerTimestampMs;
+            stats.framesOk++;
+            reset();
+            return true;
+        }
+    }
+
+    reset();
+    return false;
+}
+
+void UltrasonicFrameParser::resync() {
+    // Cari header 0xFF berikutnya di dalam frame yang gagal (header pertama dilewati)
+    uint8_t start = 1;
+    while (start < length && buffer[start] != ULTRASONIC_FRAME_HEADER) {
+        start++;
+    }
+
+    stats.bytesDiscarded += start;
+    if (start >= length) {
+        reset();
+        return;
+    }
+
+    // Geser sisa byte ke awal buffer dan lanjutkan dari state yang sesuai.
+    // Waktu frame tetap waktu tiba header yang ditemukan, bukan waktu byte checksum.
+    uint8_t remaining = length - start;
+    for (uint8_t i = 0; i < remaining; i++) {
+        buffer[i] = buffer[start + i];
+        byteTimestampMs[i] = byteTimestampMs[start + i];
+    }
+    length = remaining;
+    headerTimestampMs = byteTimestampMs[0];
+    state = (length == 1) ? WAIT_HIGH : (length == 2) ? WAIT_LOW : WAIT_CHECKSUM;
+}
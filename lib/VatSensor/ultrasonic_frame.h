@@ -0,0 +1,68 @@
+#ifndef ULTRASONIC_FRAME_H
+#define ULTRASONIC_FRAME_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Frame sensor A02YYUW: [0xFF][DATA_H][DATA_L][SUM]
+// SUM = (0xFF + DATA_H + DATA_L) & 0xFF, jarak dalam milimeter
+#define ULTRASONIC_FRAME_HEADER 0xFF
+#define ULTRASONIC_FRAME_SIZE 4
+
+// Satu frame valid beserta waktu tangkapnya
+struct UltrasonicFrame {
+    uint8_t sensorId;
+    uint16_t distanceMm;
+    unsigned long timestampMs;  // millis() saat byte header diterima
+};
+
+struct UltrasonicParserStats {
+    uint32_t framesOk;
+    uint32_t checksumErrors;
+    uint32_t bytesDiscarded;
+};
+
+/**
+ * @brief State machine byte-per-byte untuk frame A02YYUW (header -> hi -> lo -> checksum)
+ *
+ * Parser tidak pernah blocking: setiap byte dari UART langsung diumpankan ke feed().
+ * Jika checksum gagal, parser mencari header 0xFF berikutnya di dalam byte yang sudah
+ * diterima sehingga frame yang bergeser tetap tertangkap tanpa kehilangan sinkronisasi.
+ */
+class UltrasonicFrameParser {
+public:
+    explicit UltrasonicFrameParser(uint8_t sensor_id);
+
+    /**
+     * @brief Umpankan satu byte ke parser
+     * @param byte Byte yang diterima dari UART
+     * @param nowMs Waktu penerimaan byte (millis())
+     * @param frame Diisi jika byte ini melengkapi frame valid
+     * @return true jika frame valid selesai diterima
+     */
+    bool feed(uint8_t byte, unsigned long nowMs, UltrasonicFrame& frame);
+
+    void reset();
+    uint8_t getSensorId() const { return sensorId; }
+    const UltrasonicParserStats& getStats() const { return stats; }
+
+private:
+    enum State {
+        WAIT_HEADER,
+        WAIT_HIGH,
+        WAIT_LOW,
+        WAIT_CHECKSUM
+    };
+
+    void resync();
+
+    uint8_t sensorId;
+    State state;
+    uint8_t buffer[ULTRASONIC_FRAME_SIZE];
+    uint8_t length;
+    unsigned long byteTimestampMs[ULTRASONIC_FRAME_SIZE];  // Waktu tiba tiap byte di buffer
+    unsigned long headerTimestampMs;
+    UltrasonicParserStats stats;
+};
+
+#endif // ULTRASONIC_FRAME_H
@@ -0,0 +1,25 @@
+#ifndef VAT_SENSOR_DATA_H
+#define VAT_SENSOR_DATA_H
+
+#include <stdint.h>
+
+// Struktur data untuk sensor readings (satu sampel pipeline)
+struct VatSensorData {
+    bool isValid;                // true jika waktu sampel diketahui (GPS/NTP)
+    float distance1;
+    float distance2;
+    double latitude;             // Derajat (double agar presisi 1e-7 tidak hilang)
+    double longitude;
+    float depth;
+    uint16_t year;               // Waktu UTC
+    uint8_t month;
+    uint8_t day;
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t second;
+    uint8_t satellites;
+    float hdop;
+    uint32_t capturedAtMs;       // millis() saat sampel diambil
+};
+
+#endif // VAT_SENSOR_DATA_H
@@ -0,0 +1,509 @@
+// =======================================================
+//   DELTA ENCODING ROUND-TRIP - HOST (env:deltabench-native)
+//   encode_delta_batch (encoder firmware) + decoder yang mengikuti
+//   tools/decode_telemetry_delta.py baris per baris. Memeriksa:
+//     - nilai ekstrem zigzag (lat/lon +-180, jarak clamp int16, timestamp 2106)
+//     - counter reset: timestamp mundur / hilang lalu kembali, frame baru mulai dari 0
+//     - GPS NaN/Inf/di luar rentang dan jarak NaN -> nilai "tidak tersedia"
+//     - frame terpotong / byte sisa ditolak seperti decoder Python
+//   lalu round-trip trace rekaman dan rasio ukuran body vs JSON dan CBOR per
+//   batch GSM_BATCH_MAX_BYTES (seperti GSMApiHandler::sendBatch).
+//   Input: log harian biner /vatlog_YYYY-MM-DD.bin dari SD Card.
+//   Tanpa argumen: trace sintetis production schema (1 sampel/detik, 1 jam).
+//     pio run -e deltabench-native && .pio/build/deltabench-native/program /path/vatlog_*.bin
+//   Exit code 1 jika ada pemeriksaan yang gagal.
+// =======================================================
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include "../tools/host/host_arduino.cpp"
+#include "../lib/SdUtils/binary_log.h"
+#include "../lib/SdUtils/crc32.cpp"
+#include "../lib/Telemetry/telemetry_json.cpp"
+#include "../lib/Telemetry/telemetry_cbor.cpp"
+#include "../lib/Telemetry/telemetry_delta.cpp"
+
+#define DELTA_BENCH_NOW 1736935200UL     // 2025-01-15 10:00:00 UTC - jam sistem simulasi
+
+static unsigned long checks = 0;
+static unsigned long failures = 0;
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+static void check(bool ok, const char* expression, int line) {
+    checks++;
+    if (ok) return;
+    failures++;
+    printf("  FAIL line %d: %s\n", line, expression);
+}
+
+// =======================================================
+//   DECODER (tools/decode_telemetry_delta.py)
+// =======================================================
+
+struct DeltaRow {
+    int64_t timestamp;
+    int64_t lat;
+    int64_t lon;
+    int64_t depth;
+    int64_t dist1;
+    int64_t dist2;
+};
+
+struct DeltaReader {
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+    const char* error;
+
+    uint8_t byte() {
+        if (pos >= size) {
+            if (!error) error = "frame terpotong";
+            return 0;
+        }
+        return data[pos++];
+    }
+
+    uint64_t varint() {
+        uint64_t result = 0;
+        unsigned shift = 0;
+        while (!error) {
+            uint8_t value = byte();
+            result |= (uint64_t)(value & 0x7F) << shift;
+            if (value < 0x80) return result;
+            shift += 7;
+            if (shift > 63) error = "varint terlalu panjang";
+        }
+        return 0;
+    }
+
+    int64_t zigzag() {
+        uint64_t value = varint();
+        return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+    }
+};
+
+static bool decodeDeltaFrame(const uint8_t* data, size_t size, std::string& deviceId,
+                             std::vector<DeltaRow>& rows, const char** error) {
+    DeltaReader reader = {data, size, 0, NULL};
+    rows.clear();
+    if (reader.byte() != 'V' || reader.byte() != 'D') {
+        if (!reader.error) reader.error = "magic bukan 'VD'";
+    } else if (reader.byte() != TELEMETRY_DELTA_VERSION && !reader.error) {
+        reader.error = "versi tidak dikenal";
+    }
+
+    uint64_t idLength = reader.error ? 0 : reader.varint();
+    deviceId.clear();
+    for (uint64_t i = 0; i < idLength && !reader.error; i++) deviceId += (char)reader.byte();
+    uint64_t count = reader.error ? 0 : reader.varint();
+    if (!reader.error && count > size) reader.error = "jumlah sampel tidak masuk akal";
+
+    if (!reader.error) rows.resize(count);
+    int64_t DeltaRow::* columns[] = {&DeltaRow::timestamp, &DeltaRow::lat, &DeltaRow::lon,
+                                     &DeltaRow::depth, &DeltaRow::dist1, &DeltaRow::dist2};
+    for (size_t column = 0; column < 6 && !reader.error; column++) {
+        int64_t last = 0;
+        for (uint64_t i = 0; i < count && !reader.error; i++) {
+            last += reader.zigzag();
+            rows[i].*columns[column] = last;
+        }
+    }
+
+    if (!reader.error && reader.pos != size) reader.error = "ada byte sisa setelah kolom terakhir";
+    *error = reader.error;
+    return reader.error == NULL;
+}
+
+// to_production() di decoder Python: nilai kembali ke derajat / cm, NAN = null
+static double decodedCoord(int64_t value) {
+    return value == DELTA_MISSING_COORD ? NAN : value / 1e7;
+}
+
+static double decodedCm(int64_t value) {
+    return value == DELTA_MISSING_MM ? NAN : value / 10.0;
+}
+
+// =======================================================
+//   EXPECTATION (dari VatSensorData, bukan dari to_fixed_sample)
+// =======================================================
+
+static bool coordMatches(double original, double decoded) {
+    if (isnan(original) || isinf(original) || fabs(original) > 180.0) return isnan(decoded);
+    return !isnan(decoded) && fabs(original - decoded) <= 0.5e-7 + 1e-12;
+}
+
+static bool cmMatches(float original, double decoded) {
+    if (isnan(original) || isinf(original)) return isnan(decoded);
+    double clamped = original > 3276.7 ? 3276.7 : (original < -3276.7 ? -3276.7 : original);
+    return !isnan(decoded) && fabs(clamped - decoded) <= 0.05 + 1e-4;
+}
+
+static bool timestampMatches(const VatSensorData& sample, int64_t decoded, uint32_t nowUtc) {
+    time_t expected;
+    if (!sample_utc_epoch(sample, expected)) expected = nowUtc;
+    return decoded == (int64_t)(uint32_t)expected;
+}
+
+// Encode samples[0..count) ke satu atau lebih frame (sisa di frame berikutnya), decode, bandingkan
+static bool roundTrip(const VatSensorData* samples, size_t count, size_t frameBytes,
+                      uint32_t nowUtc, size_t* totalBytes, size_t* frames) {
+    std::vector<uint8_t> frame(frameBytes);
+    std::vector<DeltaRow> rows;
+    std::string deviceId;
+    bool ok = true;
+    size_t offset = 0;
+
+    while (offset < count) {
+        size_t packed = 0;
+        size_t length = encode_delta_batch(samples + offset, count - offset, DEVICE_ID,
+                                           &frame[0], frame.size(), packed);
+        if (length == 0 || packed == 0) return false;
+
+        const char* error = NULL;
+        if (!decodeDeltaFrame(&frame[0], length, deviceId, rows, &error)) {
+            printf("  decode error: %s\n", error);
+            return false;
+        }
+        ok = ok && deviceId == DEVICE_ID && rows.size() == packed;
+        for (size_t i = 0; i < rows.size() && ok; i++) {
+            const VatSensorData& sample = samples[offset + i];
+            bool match = timestampMatches(sample, rows[i].timestamp, nowUtc) &&
+                         coordMatches(sample.latitude, decodedCoord(rows[i].lat)) &&
+                         coordMatches(sample.longitude, decodedCoord(rows[i].lon)) &&
+                         cmMatches(sample.depth, decodedCm(rows[i].depth)) &&
+                         cmMatches(sample.distance1, decodedCm(rows[i].dist1)) &&
+                         cmMatches(sample.distance2, decodedCm(rows[i].dist2));
+            if (!match) {
+                printf("  mismatch sample %u: ts %lld lat %lld lon %lld depth %lld d1 %lld d2 %lld\n",
+                       (unsigned)(offset + i), (long long)rows[i].timestamp, (long long)rows[i].lat,
+                       (long long)rows[i].lon, (long long)rows[i].depth, (long long)rows[i].dist1,
+                       (long long)rows[i].dist2);
+                ok = false;
+            }
+        }
+
+        if (totalBytes) *totalBytes += length;
+        if (frames) (*frames)++;
+        offset += packed;
+    }
+    return ok;
+}
+
+static void setTime(VatSensorData& sample, uint32_t utc) {
+    time_t seconds = utc;
+    struct tm tm;
+    gmtime_r(&seconds, &tm);
+    sample.isValid = true;
+    sample.year = tm.tm_year + 1900;
+    sample.month = tm.tm_mon + 1;
+    sample.day = tm.tm_mday;
+    sample.hour = tm.tm_hour;
+    sample.minute = tm.tm_min;
+    sample.second = tm.tm_sec;
+}
+
+static VatSensorData baseSample(uint32_t utc) {
+    VatSensorData sample;
+    memset(&sample, 0, sizeof(sample));
+    setTime(sample, utc);
+    sample.latitude = -6.175392;
+    sample.longitude = 106.827153;
+    sample.distance1 = 25.4f;
+    sample.distance2 = 31.2f;
+    sample.depth = 2.84f * sample.distance2 - 16.6f;
+    sample.satellites = 9;
+    sample.hdop = 0.9f;
+    return sample;
+}
+
+// =======================================================
+//   TESTS
+// =======================================================
+
+static void testZigzagExtremes() {
+    printf("zigzag extremes\n");
+    std::vector<VatSensorData> samples;
+    VatSensorData sample = baseSample(DELTA_BENCH_NOW);
+
+    // Lompatan koordinat penuh (+-180 -> selisih 3.6e9, di luar int32)
+    double coords[][2] = {{90.0, 180.0}, {-90.0, -180.0}, {90.0, 180.0}, {-89.9999999, -179.9999999},
+                          {0.0, 0.0}, {1e-7, -1e-7}, {-1e-7, 1e-7}, {180.0, -180.0}};
+    for (size_t i = 0; i < sizeof(coords) / sizeof(coords[0]); i++) {
+        sample.latitude = coords[i][0];
+        sample.longitude = coords[i][1];
+        samples.push_back(sample);
+    }
+
+    // Jarak di batas int16 milimeter dan di luar (clamp)
+    float distances[] = {3276.7f, -3276.6f, 3276.7f, 1e9f, -1e9f, 0.0f, -0.04f, 0.05f, 3276.8f, -3276.8f};
+    for (size_t i = 0; i < sizeof(distances) / sizeof(distances[0]); i++) {
+        sample.distance1 = distances[i];
+        sample.distance2 = -distances[i];
+        sample.depth = distances[(i + 3) % 10];
+        samples.push_back(sample);
+    }
+
+    // Timestamp dari 0 (tidak diketahui) ke akhir rentang uint32 dan kembali
+    VatSensorData late = sample;
+    setTime(late, 4294967295UL);    // 2106-02-07 06:28:15
+    VatSensorData noTime = sample;
+    noTime.isValid = false;
+    samples.push_back(late);
+    samples.push_back(noTime);
+    samples.push_back(late);
+
+    host_set_time(0);
+    CHECK(roundTrip(&samples[0], samples.size(), GSM_BATCH_MAX_BYTES, DELTA_MISSING_TIME, NULL, NULL));
+
+    // Satu sampel per frame: delta pertama selalu terhadap 0
+    for (size_t i = 0; i < samples.size(); i++) {
+        CHECK(roundTrip(&samples[i], 1, GSM_BATCH_MAX_BYTES, DELTA_MISSING_TIME, NULL, NULL));
+    }
+}
+
+static void testCounterResets() {
+    printf("counter resets\n");
+    std::vector<VatSensorData> samples;
+
+    // Timestamp naik, mundur (jam GPS dikoreksi / reboot), hilang, lalu kembali
+    uint32_t times[] = {DELTA_BENCH_NOW, DELTA_BENCH_NOW + 1, DELTA_BENCH_NOW + 2, DELTA_BENCH_NOW - 86400,
+                        DELTA_BENCH_NOW - 86399, 0, 0, DELTA_BENCH_NOW + 3, 1577836800UL, DELTA_BENCH_NOW + 4};
+    for (size_t i = 0; i < sizeof(times) / sizeof(times[0]); i++) {
+        VatSensorData sample = baseSample(times[i]);
+        if (times[i] == 0) sample.isValid = false;
+        // Sensor reset: jarak turun ke 0 lalu kembali
+        if (i == 4 || i == 5) sample.distance1 = sample.distance2 = sample.depth = 0.0f;
+        sample.capturedAtMs = i < 5 ? 4294967000UL + i * 100 : (i - 5) * 100;  // millis() wrap (tidak dikirim)
+        samples.push_back(sample);
+    }
+
+    // Tanpa jam sistem: sampel tanpa waktu GPS dikirim timestamp 0
+    host_set_time(0);
+    CHECK(roundTrip(&samples[0], samples.size(), GSM_BATCH_MAX_BYTES, DELTA_MISSING_TIME, NULL, NULL));
+
+    // Dengan jam sistem: sampel tanpa waktu GPS memakai satu "sekarang" untuk seluruh batch
+    host_set_time(DELTA_BENCH_NOW);
+    CHECK(roundTrip(&samples[0], samples.size(), GSM_BATCH_MAX_BYTES, DELTA_BENCH_NOW, NULL, NULL));
+
+    // Buffer kecil: batch dipecah ke beberapa frame, setiap frame mulai lagi dari 0
+    size_t bytes = 0;
+    size_t frames = 0;
+    CHECK(roundTrip(&samples[0], samples.size(), 48, DELTA_BENCH_NOW, &bytes, &frames));
+    CHECK(frames > 1);
+    host_set_time(0);
+}
+
+static void testInvalidGps() {
+    printf("NaN / invalid GPS\n");
+    std::vector<VatSensorData> samples;
+    double invalid[] = {NAN, INFINITY, -INFINITY, 180.0000001, -200.0, 1e300, -6.2, NAN};
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        VatSensorData sample = baseSample(DELTA_BENCH_NOW + i);
+        sample.latitude = invalid[i];
+        sample.longitude = invalid[(i + 1) % 8];
+        sample.depth = i % 2 ? NAN : 12.5f;
+        sample.distance1 = i % 3 ? INFINITY : 25.0f;
+        sample.distance2 = i % 4 ? 31.0f : NAN;
+        samples.push_back(sample);
+    }
+    // Fix GPS hilang di tengah trace lalu kembali
+    VatSensorData fix = baseSample(DELTA_BENCH_NOW + 10);
+    samples.push_back(fix);
+    samples.insert(samples.begin(), fix);
+    CHECK(roundTrip(&samples[0], samples.size(), GSM_BATCH_MAX_BYTES, DELTA_MISSING_TIME, NULL, NULL));
+
+    // Nilai "tidak tersedia" sama persis dengan sentinel di decoder Python
+    uint8_t frame[256];
+    size_t packed;
+    size_t length = encode_delta_batch(&samples[1], 1, DEVICE_ID, frame, sizeof(frame), packed);
+    std::vector<DeltaRow> rows;
+    std::string deviceId;
+    const char* error;
+    CHECK(length > 0 && decodeDeltaFrame(frame, length, deviceId, rows, &error));
+    CHECK(rows.size() == 1 && rows[0].lat == -2147483648LL && rows[0].depth == 12.5 * 10);
+}
+
+static void testMalformedFrames() {
+    printf("malformed frames\n");
+    VatSensorData samples[4] = {baseSample(DELTA_BENCH_NOW), baseSample(DELTA_BENCH_NOW + 1),
+                                baseSample(DELTA_BENCH_NOW + 2), baseSample(DELTA_BENCH_NOW + 3)};
+    uint8_t frame[256];
+    size_t packed;
+    size_t length = encode_delta_batch(samples, 4, DEVICE_ID, frame, sizeof(frame), packed);
+    std::vector<DeltaRow> rows;
+    std::string deviceId;
+    const char* error;
+
+    CHECK(length > 0 && packed == 4);
+    CHECK(decodeDeltaFrame(frame, length, deviceId, rows, &error));
+    bool truncatedRejected = true;
+    for (size_t cut = 0; cut < length; cut++) {
+        truncatedRejected = truncatedRejected && !decodeDeltaFrame(frame, cut, deviceId, rows, &error);
+    }
+    CHECK(truncatedRejected);
+
+    frame[length] = 0;
+    CHECK(!decodeDeltaFrame(frame, length + 1, deviceId, rows, &error));
+    frame[2] = TELEMETRY_DELTA_VERSION + 1;
+    CHECK(!decodeDeltaFrame(frame, length, deviceId, rows, &error));
+    frame[2] = TELEMETRY_DELTA_VERSION;
+    frame[0] = 'X';
+    CHECK(!decodeDeltaFrame(frame, length, deviceId, rows, &error));
+
+    // Buffer lebih kecil dari header - tidak ada sampel yang dikemas
+    CHECK(encode_delta_batch(samples, 4, DEVICE_ID, frame, 4, packed) == 0 && packed == 0);
+}
+
+// =======================================================
+//   TRACES & RATIO
+// =======================================================
+
+static bool isBlockValid(const uint8_t* block) {
+    BinaryLogBlockHeader header;
+    memcpy(&header, block, sizeof(header));
+    if (header.magic[0] != BINARY_LOG_MAGIC0 || header.magic[1] != BINARY_LOG_MAGIC1 ||
+        header.version != BINARY_LOG_VERSION || header.count == 0 ||
+        header.count > BINARY_LOG_RECORDS_PER_BLOCK) {
+        return false;
+    }
+    uint32_t stored;
+    memcpy(&stored, block + BINARY_LOG_CRC_OFFSET, sizeof(stored));
+    return crc32Compute(block, BINARY_LOG_CRC_OFFSET) == stored;
+}
+
+static double fromFixed(int64_t value, int64_t missing, double scale) {
+    return value == missing ? NAN : value / scale;
+}
+
+// Log harian biner -> VatSensorData (kebalikan toBinaryLogRecord)
+static bool loadBinaryLog(const char* path, std::vector<VatSensorData>& samples) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+    uint8_t block[BINARY_LOG_BLOCK_SIZE];
+    while (fread(block, 1, sizeof(block), file) == sizeof(block)) {
+        if (!isBlockValid(block)) continue;
+        BinaryLogBlockHeader header;
+        memcpy(&header, block, sizeof(header));
+        for (uint8_t i = 0; i < header.count; i++) {
+            BinaryLogRecord record;
+            memcpy(&record, block + sizeof(header) + i * sizeof(record), sizeof(record));
+
+            VatSensorData sample;
+            memset(&sample, 0, sizeof(sample));
+            if (record.timestamp != DELTA_MISSING_TIME) setTime(sample, record.timestamp);
+            sample.latitude = fromFixed(record.latitudeE7, DELTA_MISSING_COORD, 1e7);
+            sample.longitude = fromFixed(record.longitudeE7, DELTA_MISSING_COORD, 1e7);
+            sample.distance1 = fromFixed(record.distance1Mm, DELTA_MISSING_MM, 10.0);
+            sample.distance2 = fromFixed(record.distance2Mm, DELTA_MISSING_MM, 10.0);
+            sample.depth = fromFixed(record.depthMm, DELTA_MISSING_MM, 10.0);
+            sample.satellites = record.satellites;
+            sample.hdop = record.hdopX100 == 0xFFFF ? NAN : record.hdopX100 / 100.0f;
+            sample.capturedAtMs = record.capturedAtMs;
+            samples.push_back(sample);
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+// Sama dengan trace sintetis gzipbench-native
+static void synthesizeTrace(std::vector<VatSensorData>& samples) {
+    VatSensorData sample = baseSample(1736899200UL);   // 2025-01-15 00:00:00 UTC
+    unsigned random = 12345;
+    for (int i = 0; i < 3600; i++) {
+        random = random * 1103515245 + 12345;
+        sample.hour = i / 3600;
+        sample.minute = (i / 60) % 60;
+        sample.second = i % 60;
+        sample.distance1 = 25.0f + (i % 600) * 0.01f + (random >> 16) % 8 * 0.1f;
+        sample.distance2 = 30.0f + (i % 900) * 0.01f + (random >> 20) % 8 * 0.1f;
+        sample.latitude += ((int)((random >> 8) % 5) - 2) * 1e-7;
+        sample.longitude += ((int)((random >> 12) % 5) - 2) * 1e-7;
+        sample.depth = 2.84f * sample.distance2 - 16.6f;
+        samples.push_back(sample);
+    }
+}
+
+// JSON array sampai GSM_BATCH_MAX_BYTES (GSMApiHandler::encodeJsonBatch)
+static size_t jsonBodyBytes(const std::vector<VatSensorData>& samples, size_t& bodies) {
+    char json[PRODUCTION_JSON_MAX_SIZE];
+    size_t total = 0;
+    size_t body = 0;
+    bodies = 0;
+    for (size_t i = 0; i < samples.size(); i++) {
+        size_t length = encode_production_json(samples[i], DEVICE_ID, NULL, json, sizeof(json));
+        if (body > 0 && body + 1 + length + 1 > GSM_BATCH_MAX_BYTES) {
+            total += body + 1;
+            body = 0;
+        }
+        if (body == 0) bodies++;
+        body += 1 + length;     // '[' atau ','
+    }
+    return total + (body > 0 ? body + 1 : 0);
+}
+
+static size_t cborBodyBytes(const std::vector<VatSensorData>& samples, size_t& bodies) {
+    std::vector<uint8_t> buffer(GSM_BATCH_MAX_BYTES);
+    size_t total = 0;
+    bodies = 0;
+    for (size_t offset = 0; offset < samples.size();) {
+        size_t packed = 0;
+        size_t length = encode_cbor_batch(&samples[offset], samples.size() - offset, DEVICE_ID,
+                                          &buffer[0], buffer.size(), packed);
+        if (packed == 0) break;
+        total += length;
+        bodies++;
+        offset += packed;
+    }
+    return total;
+}
+
+static void runTrace(const char* source, const std::vector<VatSensorData>& samples) {
+    size_t jsonBodies, cborBodies, deltaBodies = 0;
+    size_t deltaBytes = 0;
+    size_t jsonBytes = jsonBodyBytes(samples, jsonBodies);
+    size_t cborBytes = cborBodyBytes(samples, cborBodies);
+
+    // Round-trip lengkap trace: setiap frame di-decode dan dibandingkan dengan sampel asli
+    bool ok = roundTrip(&samples[0], samples.size(), GSM_BATCH_MAX_BYTES, DELTA_MISSING_TIME,
+                        &deltaBytes, &deltaBodies);
+    CHECK(ok);
+
+    double count = samples.size();
+    printf("DELTA,%s,json,%u,%u,%u,%.1f,1.00\n", source, (unsigned)samples.size(), (unsigned)jsonBodies,
+           (unsigned)jsonBytes, jsonBytes / count);
+    printf("DELTA,%s,cbor,%u,%u,%u,%.1f,%.2f\n", source, (unsigned)samples.size(), (unsigned)cborBodies,
+           (unsigned)cborBytes, cborBytes / count, (double)jsonBytes / cborBytes);
+    printf("DELTA,%s,delta,%u,%u,%u,%.1f,%.2f\n", source, (unsigned)samples.size(), (unsigned)deltaBodies,
+           (unsigned)deltaBytes, deltaBytes / count, (double)jsonBytes / deltaBytes);
+}
+
+int main(int argc, char** argv) {
+    Serial.setEnabled(false);
+
+    testZigzagExtremes();
+    testCounterResets();
+    testInvalidGps();
+    testMalformedFrames();
+
+    std::vector<VatSensorData> samples;
+    const char* source = "synthetic";
+    for (int i = 1; i < argc; i++) {
+        if (!loadBinaryLog(argv[i], samples)) {
+            fprintf(stderr, "cannot read %s\n", argv[i]);
+            return 1;
+        }
+        source = argc == 2 ? argv[i] : "files";
+    }
+    if (samples.empty()) synthesizeTrace(samples);
+
+    printf("#DELTA,source,encoding,samples,bodies,bytes,bytes_per_sample,ratio_vs_json\n");
+    runTrace(source, samples);
+
+    printf("%s: %lu checks, %lu failures\n", failures ? "FAIL" : "PASS", checks, failures);
+    return failures ? 1 : 0;
+}
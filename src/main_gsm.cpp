@@ -1,16 +1,134 @@
 #include <Arduino.h>
 #include <TinyGPSPlus.h>
 #include "../lib/ApiHandler/gsm_api_handler.h"
+#include "../lib/ApiHandler/retry_policy.h"
 #include "../lib/VatSensor/sensors.h"
 #include "../lib/indicators/indicators.h"
+#include "../lib/SdUtils/sd_utils.h"
+#include "../lib/Pipeline/task_pipeline.h"
 #include "../include/config.h"
 
 // Global objects (using TESTED & WORKING TinyGSM handler)
 GSMApiHandler gsmHandler(DEVICE_ID);
 
-// Timing variables
-unsigned long lastPostTime = 0;
-unsigned long lastSensorTime = 0;
+// Modem dipakai bersama oleh task network dan serial command
+SemaphoreHandle_t modemMutex = NULL;
+
+// Backoff + circuit breaker untuk reconnect & upload: link yang mati tidak dicoba setiap POST_INTERVAL
+RetryPolicy gsmRetry("gsm", GSM_RETRY_INTERVAL, GSM_MAX_RETRIES);
+
+// LED hanya dikendalikan loop(): level dari sampel terakhir, kedip dari hasil upload task network
+volatile int8_t uploadBlink = 0;    // 1 = sukses (LED1), -1 = gagal (LED2), 0 = tidak ada
+uint32_t ledSampleMs = 0;           // capturedAtMs sampel terakhir yang ditampilkan di LED
+
+// =======================================================
+//   PIPELINE CALLBACKS
+// =======================================================
+
+// Task akuisisi: tampilkan sampel (LED diperbarui loop dari get_latest_sample)
+void onSample(const VatSensorData& sample) {
+    Serial.println("📊 Current Sensor Readings:");
+    Serial.printf("Distance1: %.2f cm\n", sample.distance1);
+    Serial.printf("Distance2: %.2f cm\n", sample.distance2);
+    Serial.printf("GPS: %.6f, %.6f (Alt: %.2f)\n", sample.latitude, sample.longitude, altitude);
+}
+
+// Task storage: simpan setiap sampel ke log harian, lalu satu langkah retensi & kompresi log
+void storeSample(const VatSensorData& sample) {
+    if (isSdCardOk) {
+        writeToDailyLog(sample);
+        cleanupOldLogs();
+        compressClosedLogs(sample);
+    }
+}
+
+// Breaker terbuka: sampel langsung ke antrean offline, dikirim syncOfflineData() setelah link pulih
+void queueSamplesOffline(const VatSensorData* samples, size_t count) {
+    char json[PRODUCTION_JSON_MAX_SIZE];
+    for (size_t i = 0; i < count; i++) {
+        if (encode_production_json(samples[i], DEVICE_ID, NULL, json, sizeof(json)) > 0) {
+            addToOfflineQueue(json);
+        }
+    }
+}
+
+// Task network: kirim semua sampel tertunda sebagai batch ke production API
+size_t uploadSamples(const VatSensorData* samples, size_t count) {
+    if (!gsmRetry.canAttempt()) {
+        if (gsmRetry.isOpen() && isSdCardOk) {
+            // Link dianggap mati - modem tidak disentuh sampai waktu probe
+            queueSamplesOffline(samples, count);
+            Serial.printf("📥 GSM breaker open - %u samples queued offline (probe in %lu s)\n",
+                          (unsigned)count, gsmRetry.getRetryInMs() / 1000);
+            return count;
+        }
+        return 0;  // Menunggu backoff - sampel tetap di ring
+    }
+    
+    xSemaphoreTake(modemMutex, portMAX_DELAY);
+    
+    if (!gsmHandler.isModemConnected()) {
+        Serial.println("❌ GSM not connected - attempting reconnection...");
+        
+        // Try to reconnect
+        if (!gsmHandler.connect()) {
+            gsmRetry.recordFailure();
+            xSemaphoreGive(modemMutex);
+            return 0;
+        }
+        Serial.println("✅ GSM reconnected");
+    }
+    
+    Serial.println("\n🚀 SENDING DATA TO PRODUCTION API");
+    Serial.println("=====================================");
+    Serial.println("📡 Target: api-vatsubsoil-dev.ggfsystem.com/subsoils");
+    Serial.println("🔒 Using HTTPS, JSON array of production-format samples");
+    
+    // Satu POST per batch (dibatasi GSM_BATCH_MAX_BYTES); sisa yang gagal tetap di ring
+    size_t sent = 0;
+    while (sent < count) {
+        size_t batch = gsmHandler.sendBatch(samples + sent, count - sent);
+        if (batch == 0) break;
+        sent += batch;
+    }
+    
+    if (sent > 0) {
+        gsmRetry.recordSuccess();
+        
+        // Link sehat - kirim juga antrean offline (sampel saat breaker terbuka)
+        if (sent == count && isSdCardOk) {
+            gsmHandler.syncOfflineData();
+        }
+    } else {
+        gsmRetry.recordFailure();
+    }
+    xSemaphoreGive(modemMutex);
+    
+    if (sent == count) {
+        Serial.println("✅ Data sent successfully to production API!");
+        Serial.println("🎉 Sistem monitoring tanah subsoil berjalan normal");
+        uploadBlink = 1;
+    } else {
+        Serial.printf("❌ Failed to send %u of %u samples to production API\n",
+                      (unsigned)(count - sent), (unsigned)count);
+        Serial.println("🔧 Cek koneksi internet atau format data");
+        uploadBlink = -1;
+    }
+    
+    return sent;
+}
+
+// Kedip hasil upload (seperti kode test): LED1 = sukses, LED2 = gagal
+void blinkUploadResult(bool success) {
+    int pin = success ? LED1_PIN : LED2_PIN;
+    int periodMs = success ? 200 : 500;
+    for (int i = 0; i < 3; i++) {
+        digitalWrite(pin, HIGH);
+        delay(periodMs);
+        digitalWrite(pin, LOW);
+        delay(periodMs);
+    }
+}
 
 void setup() {
     Serial.begin(115200);
@@ -27,6 +145,11 @@ void setup() {
     Serial.println("🔧 Initializing sensors...");
     setup_sensors();
     
+    // Initialize SD Card for daily logging
+    initSdCard();
+    
+    modemMutex = xSemaphoreCreateMutex();
+    
     // Initialize GSM with tested method (same as working version)
     Serial.println("📡 Initializing GSM (TESTED TinyGSM Method)...");
     if (gsmHandler.initialize()) {
@@ -55,91 +178,34 @@ void setup() {
         Serial.println("❌ GSM initialization failed");
     }
     
-    Serial.println("🚀 Setup complete - entering main loop");
+    // Start acquisition, storage and network tasks
+    PipelineConfig pipeline;
+    pipeline.sampleIntervalMs = SAVE_SD_INTERVAL;
+    pipeline.uploadIntervalMs = POST_INTERVAL;
+    pipeline.onSample = onSample;
+    pipeline.store = storeSample;
+    pipeline.upload = uploadSamples;
+    start_task_pipeline(pipeline);
+    
+    Serial.println("🚀 Setup complete - pipeline tasks running");
     Serial.println("📊 Data will be sent every " + String(POST_INTERVAL/1000) + " seconds");
     Serial.println("==========================================");
 }
 
 void loop() {
-    unsigned long currentTime = millis();
-    
-    // Read sensors periodically (same timing as working version)
-    if (currentTime - lastSensorTime >= SAVE_SD_INTERVAL) {
-        // Read sensor data using existing functions
-        read_ultrasonic_sensors();
-        read_gps_data();
-        
-        // Print sensor data using existing global variables
-        Serial.println("📊 Current Sensor Readings:");
-        Serial.printf("Distance1: %.2f cm\n", distance1);
-        Serial.printf("Distance2: %.2f cm\n", distance2);
-        Serial.printf("GPS: %.6f, %.6f (Alt: %.2f)\n", latitude, longitude, altitude);
-        
-        // Update LEDs
-        update_leds(distance1, distance2);
-        
-        // Update timing
-        lastSensorTime = currentTime;
+    // Sensor, storage dan upload berjalan di task pipeline.
+    // Loop hanya mengendalikan LED dan melayani serial command (serialEvent).
+    VatSensorData sample;
+    if (get_latest_sample(sample) && sample.capturedAtMs != ledSampleMs) {
+        ledSampleMs = sample.capturedAtMs;
+        update_leds(sample.distance1, sample.distance2);
     }
     
-    // Send data to API periodically (same as working version)
-    if (currentTime - lastPostTime >= POST_INTERVAL) {
-        if (gsmHandler.isModemConnected()) {
-            Serial.println("\n🚀 SENDING DATA TO PRODUCTION API");
-            Serial.println("=====================================");
-            Serial.println("📡 Target: api-vatsubsoil-dev.ggfsystem.com/subsoils");
-            Serial.println("🔒 Using HTTPS with exact working format");
-            
-            // Calculate depth if needed
-            float depth = calculate_depth();
-            
-            // Send to API using TESTED TinyGSM method with current sensor data
-            // This uses the exact same format that works in your test code:
-            // {"type":"sensor","deviceId":"BJK0001","gps":{"lat":-4.823621,"lon":105.226395,"alt":100.0,"sog":0,"cog":0},"ultrasonic":{"dist1":5.20,"dist2":52.80},"timestamp":"2025-07-21T09:52:00+07:00"}
-            bool success = gsmHandler.sendSensorData(
-                distance1, 
-                distance2,
-                latitude, 
-                longitude, 
-                depth
-            );
-            
-            if (success) {
-                Serial.println("✅ Data sent successfully to production API!");
-                Serial.println("🎉 Sistem monitoring tanah subsoil berjalan normal");
-                
-                // Success LED indication (like your test code)
-                for (int i = 0; i < 3; i++) {
-                    digitalWrite(LED1_PIN, HIGH);
-                    delay(200);
-                    digitalWrite(LED1_PIN, LOW);
-                    delay(200);
-                }
-            } else {
-                Serial.println("❌ Failed to send data to production API");
-                Serial.println("🔧 Cek koneksi internet atau format data");
-                
-                // Error LED indication
-                for (int i = 0; i < 3; i++) {
-                    digitalWrite(LED2_PIN, HIGH);
-                    delay(500);
-                    digitalWrite(LED2_PIN, LOW);
-                    delay(500);
-                }
-            }
-        } else {
-            Serial.println("❌ GSM not connected - attempting reconnection...");
-            
-            // Try to reconnect
-            if (gsmHandler.connect()) {
-                Serial.println("✅ GSM reconnected");
-            }
-        }
-        
-        lastPostTime = currentTime;
+    int8_t blink = uploadBlink;
+    if (blink != 0) {
+        uploadBlink = 0;
+        blinkUploadResult(blink > 0);
     }
-    
-    // Small delay to prevent overwhelming the system
     delay(100);
 }
 
@@ -153,58 +219,86 @@ void serialEvent() {
             Serial.println("🧪 Manual test initiated...");
             Serial.println("📡 Sending test data to production API...");
             // Use exact same test data as working version
+            xSemaphoreTake(modemMutex, portMAX_DELAY);
             bool result = gsmHandler.sendSensorData(12.34, 56.78, -6.175392, 106.827153, 25.5);
+            xSemaphoreGive(modemMutex);
             Serial.println(result ? "✅ Test successful" : "❌ Test failed");
         }
         else if (command == "status") {
             Serial.println("\n📋 SYSTEM STATUS");
             Serial.println("================");
+            xSemaphoreTake(modemMutex, portMAX_DELAY);
             gsmHandler.printStatus();
             gsmHandler.printNetworkInfo();
-            display_sensor_data(); // Use existing function
+            xSemaphoreGive(modemMutex);
+            VatSensorData sample;
+            if (get_latest_sample(sample)) {
+                display_sensor_data(sample);
+            }
+            print_pipeline_stats();
+            printSdCardStats();       // Termasuk statistik antrean offline
+            gsmRetry.printStats();
             Serial.println("📡 API Target: api-vatsubsoil-dev.ggfsystem.com");
             Serial.println("📊 Format: Working JSON structure from test");
         }
         else if (command == "reconnect") {
             Serial.println("🔄 Reconnecting GSM...");
+            xSemaphoreTake(modemMutex, portMAX_DELAY);
             gsmHandler.disconnect();
             delay(2000);
             if (gsmHandler.connect()) {
                 Serial.println("✅ Reconnection successful");
+                gsmRetry.reset();  // Upload berikutnya tidak menunggu backoff / breaker
                 gsmHandler.printNetworkInfo();
             } else {
                 Serial.println("❌ Reconnection failed");
             }
+            xSemaphoreGive(modemMutex);
         }
         else if (command == "sensors") {
-            Serial.println("📊 Reading sensors manually...");
-            read_ultrasonic_sensors();
-            read_gps_data();
-            display_sensor_data();
+            Serial.println("📊 Latest sample from acquisition task...");
             
             // Show what would be sent to API
-            float depth = calculate_depth();
-            Serial.println("\n📡 Data that would be sent to API:");
-            Serial.printf("Distance1: %.2f cm\n", distance1);
-            Serial.printf("Distance2: %.2f cm\n", distance2);
-            Serial.printf("GPS: %.6f, %.6f\n", latitude, longitude);
-            Serial.printf("Depth: %.2f cm\n", depth);
+            VatSensorData sample;
+            if (get_latest_sample(sample)) {
+                display_sensor_data(sample);
+                Serial.println("\n📡 Data that would be sent to API:");
+                Serial.printf("Distance1: %.2f cm\n", sample.distance1);
+                Serial.printf("Distance2: %.2f cm\n", sample.distance2);
+                Serial.printf("GPS: %.6f, %.6f\n", sample.latitude, sample.longitude);
+                Serial.printf("Depth: %.2f cm\n", sample.depth);
+            } else {
+                Serial.println("⏳ No sample yet");
+            }
         }
         else if (command == "production") {
             Serial.println("🚀 FORCE SEND TO PRODUCTION API");
             Serial.println("================================");
             
-            // Read current sensors
-            read_ultrasonic_sensors();
-            read_gps_data();
-            float depth = calculate_depth();
-            
-            // Send immediately
-            bool result = gsmHandler.sendSensorData(distance1, distance2, latitude, longitude, depth);
-            if (result) {
-                Serial.println("✅ Production API send successful!");
+            // Bangunkan task network agar langsung upload sampel yang tertunda
+            request_pipeline_upload();
+            Serial.println("📤 Upload requested - see network task output");
+        }
+        else if (command == "pipeline") {
+            print_pipeline_stats();
+        }
+        else if (command == "exportall") {
+            // Semua log harian -> satu CSV di SD Card (blocking, progress per hari)
+            exportAllData();
+        }
+        else if (command == "stats") {
+            // Info kartu + clock SPI; counter antrean dari metadata (tanpa scan file)
+            printSdCardStats();
+            print_pipeline_stats();
+            gsmRetry.printStats();
+        }
+        else if (command == "exportlog") {
+            // Log biner hari ini (tanggal UTC sampel terakhir) -> CSV di SD Card
+            VatSensorData sample;
+            if (get_latest_sample(sample) && sample.isValid) {
+                exportDailyLogToCsv(sample.year, sample.month, sample.day);
             } else {
-                Serial.println("❌ Production API send failed!");
+                Serial.println("⏳ No GPS date yet - cannot pick daily log");
             }
         }
         else {
@@ -215,6 +309,10 @@ void serialEvent() {
             Serial.println("  reconnect  - Reconnect GSM network");
             Serial.println("  sensors    - Read sensors manually");
             Serial.println("  production - Force send current data to production");
+            Serial.println("  pipeline   - Show task pipeline statistics");
+            Serial.println("  stats      - Show offline queue, pipeline and retry statistics");
+            Serial.println("  exportlog  - Export today's binary log to CSV");
+            Serial.println("  exportall  - Merge all daily logs into " LOG_EXPORT_DEFAULT_FILE);
             Serial.println("\n🎯 This version uses TESTED & WORKING TinyGSM method");
             Serial.println("📡 Target: api-vatsubsoil-dev.ggfsystem.com/subsoils");
         }
@@ -0,0 +1,132 @@
+// =======================================================
+//   GZIP BENCHMARK - HOST (env:gzipbench-native)
+//   Rasio dan biaya CPU GzipEncoder (encoder yang sama dengan firmware) pada body
+//   batch upload. Input: file antrean offline / payload rekaman (satu JSON per baris,
+//   mis. /queue/seg_*.txt dari SD Card); record digabung jadi JSON array sampai
+//   ukuran batch GSM dan WiFi, persis seperti sendBatch / syncOfflineData.
+//   Tanpa argumen: trace sintetis production schema (1 sampel/detik, 1 jam).
+//     pio run -e gzipbench-native && .pio/build/gzipbench-native/program /path/seg_*.txt
+//   Waktu CPU diukur di host - ESP32 @240 MHz kira-kira 10-20x lebih lambat.
+// =======================================================
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+#include <string>
+#include "../lib/Telemetry/gzip_deflate.h"
+#include "../lib/Telemetry/telemetry_json.h"
+#include "../lib/Telemetry/telemetry_json.cpp"
+#include "../lib/Telemetry/gzip_deflate.cpp"
+#include "../lib/SdUtils/crc32.cpp"
+#include "../include/config.h"
+
+#define GZIP_BENCH_LINK_BPS 40000.0     // GPRS efektif ~40 kbit/s
+#define GZIP_BENCH_REPEAT 20            // Kompres ulang agar waktu terukur
+
+static GzipEncoder encoder;
+static uint8_t packedBuffer[WIFI_DRAIN_BATCH_BYTES + GZIP_OVERHEAD + 1024];
+
+static double nowUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static bool loadRecords(const char* path, std::vector<std::string>& records) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+    char line[1024];
+    while (fgets(line, sizeof(line), file)) {
+        size_t length = strcspn(line, "\r\n");
+        if (length > 0) records.push_back(std::string(line, length));
+    }
+    fclose(file);
+    return true;
+}
+
+static void synthesizeRecords(std::vector<std::string>& records) {
+    char json[PRODUCTION_JSON_MAX_SIZE];
+    VatSensorData sample;
+    memset(&sample, 0, sizeof(sample));
+    sample.isValid = true;
+    sample.year = 2025;
+    sample.month = 1;
+    sample.day = 15;
+    sample.latitude = -6.175392;
+    sample.longitude = 106.827153;
+    sample.satellites = 9;
+    sample.hdop = 0.9f;
+
+    unsigned random = 12345;
+    for (int i = 0; i < 3600; i++) {
+        random = random * 1103515245 + 12345;
+        sample.hour = i / 3600;
+        sample.minute = (i / 60) % 60;
+        sample.second = i % 60;
+        sample.distance1 = 25.0f + (i % 600) * 0.01f + (random >> 16) % 8 * 0.1f;
+        sample.distance2 = 30.0f + (i % 900) * 0.01f + (random >> 20) % 8 * 0.1f;
+        sample.latitude += ((int)((random >> 8) % 5) - 2) * 1e-7;
+        sample.longitude += ((int)((random >> 12) % 5) - 2) * 1e-7;
+        sample.depth = 2.84f * sample.distance2 - 16.6f;
+        if (encode_production_json(sample, DEVICE_ID, NULL, json, sizeof(json)) > 0) {
+            records.push_back(json);
+        }
+    }
+}
+
+// Gabung record jadi JSON array (maks batchBytes), kompres, kumpulkan total
+static void runBatchSize(const char* source, const std::vector<std::string>& records, size_t batchBytes) {
+    std::string body;
+    size_t batches = 0;
+    double rawBytes = 0;
+    double packedBytes = 0;
+    double elapsedUs = 0;
+    size_t next = 0;
+
+    while (next < records.size()) {
+        body = "[";
+        while (next < records.size() && body.size() + records[next].size() + 2 <= batchBytes) {
+            if (body.size() > 1) body += ",";
+            body += records[next++];
+        }
+        if (body.size() == 1) body += records[next++];  // Record lebih besar dari batch
+        body += "]";
+
+        size_t packed = 0;
+        double startUs = nowUs();
+        for (int i = 0; i < GZIP_BENCH_REPEAT; i++) {
+            packed = gzip_compress(encoder, body.data(), body.size(), packedBuffer, sizeof(packedBuffer));
+        }
+        elapsedUs += (nowUs() - startUs) / GZIP_BENCH_REPEAT;
+
+        batches++;
+        rawBytes += body.size();
+        packedBytes += packed > 0 && packed < body.size() ? packed : body.size();
+    }
+
+    printf("GZIP,%s,%u,%u,%u,%.0f,%.0f,%.2f,%.1f,%.1f,%.1f\n", source, (unsigned)batchBytes,
+           (unsigned)records.size(), (unsigned)batches, rawBytes, packedBytes, rawBytes / packedBytes,
+           elapsedUs / (rawBytes / 1024.0), rawBytes * 8 / GZIP_BENCH_LINK_BPS,
+           packedBytes * 8 / GZIP_BENCH_LINK_BPS);
+}
+
+int main(int argc, char** argv) {
+    printf("#GZIP,source,batch_bytes,records,batches,raw_bytes,gzip_bytes,ratio,host_us_per_kb,"
+           "link_s_raw,link_s_gzip\n");
+
+    std::vector<std::string> records;
+    const char* source = "synthetic";
+    for (int i = 1; i < argc; i++) {
+        if (!loadRecords(argv[i], records)) {
+            fprintf(stderr, "cannot read %s\n", argv[i]);
+            return 1;
+        }
+        source = argc == 2 ? argv[i] : "files";
+    }
+    if (records.empty()) synthesizeRecords(records);
+
+    runBatchSize(source, records, GSM_BATCH_MAX_BYTES);
+    runBatchSize(source, records, WIFI_DRAIN_BATCH_BYTES);
+    return 0;
+}
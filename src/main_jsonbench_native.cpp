@@ -0,0 +1,282 @@
+// =======================================================
+//   JSON ENCODER BENCHMARK - HOST (env:jsonbench-native)
+//   encode_production_json (lib/Telemetry) dibandingkan dengan jalur lama
+//   sebelum encoder bebas heap:
+//     arduinojson_static  GSM createProductionJsonPayload: StaticJsonDocument<512>
+//                         + serializeJson ke String, batch disambung dengan String
+//     arduinojson_dynamic sensorDataToJson (antrean offline): DynamicJsonDocument(1024)
+//     string_concat       WiFi sendDataToAPI: payload disusun dengan String +=
+//     telemetry_json      encode_production_json langsung ke buffer batch
+//   Trace sintetis production schema (sama dengan gzipbench-native), batch sampai
+//   GSM_BATCH_MAX_BYTES. Alokasi heap dihitung lewat operator new dan allocator
+//   DynamicJsonDocument; String host = std::string (Arduino String juga malloc per resize).
+//     pio run -e jsonbench-native && .pio/build/jsonbench-native/program
+//   Waktu CPU diukur di host - ESP32 @240 MHz kira-kira 10-20x lebih lambat.
+// =======================================================
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <new>
+#include <string>
+#include <vector>
+#include <ArduinoJson.h>
+#include "../tools/host/host_arduino.cpp"
+#include "../lib/Telemetry/telemetry_json.cpp"
+
+#define JSON_BENCH_ROUNDS 20
+#define JSON_BENCH_NOW 1736935200UL     // Jam sistem simulasi (sampel tanpa waktu GPS)
+
+// =======================================================
+//   HEAP COUNTER
+// =======================================================
+
+static bool countingAllocations = false;
+static unsigned long allocations = 0;
+
+void* operator new(size_t size) {
+    if (countingAllocations) allocations++;
+    void* memory = malloc(size ? size : 1);
+    if (!memory) throw std::bad_alloc();
+    return memory;
+}
+
+void operator delete(void* memory) noexcept {
+    free(memory);
+}
+
+struct CountingAllocator {
+    void* allocate(size_t size) {
+        if (countingAllocations) allocations++;
+        return malloc(size);
+    }
+    void deallocate(void* memory) {
+        free(memory);
+    }
+    void* reallocate(void* memory, size_t size) {
+        if (countingAllocations) allocations++;
+        return realloc(memory, size);
+    }
+};
+
+// DynamicJsonDocument = BasicJsonDocument<DefaultAllocator> (malloc), di sini dengan counter
+typedef BasicJsonDocument<CountingAllocator> CountingJsonDocument;
+
+static double nowUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// =======================================================
+//   JALUR LAMA
+// =======================================================
+
+// getWibTimestamp() lama: gmtime + strftime ke String
+static String oldWibTimestamp(const VatSensorData& data) {
+    time_t utc_time = 0;
+    sample_utc_epoch(data, utc_time);
+    time_t wib_time = utc_time + (7 * 3600);
+    struct tm* wib_tm_ptr = gmtime(&wib_time);
+
+    char wibTimestampStr[30];
+    strftime(wibTimestampStr, sizeof(wibTimestampStr), "%Y-%m-%dT%H:%M:%S+07:00", wib_tm_ptr);
+    return String(wibTimestampStr);
+}
+
+static String oldNowTimestamp() {
+    char timestamp[WIB_TIMESTAMP_SIZE];
+    format_wib_timestamp_now(timestamp, sizeof(timestamp));
+    return String(timestamp);
+}
+
+// GSMApiHandler::createProductionJsonPayload (sebelum encode_production_json)
+static String oldStaticPayload(const VatSensorData& sample) {
+    StaticJsonDocument<512> doc;
+
+    doc["type"] = "sensor";
+    doc["deviceId"] = DEVICE_ID;
+
+    JsonObject gps = doc.createNestedObject("gps");
+    gps["lat"] = sample.latitude;
+    gps["lon"] = sample.longitude;
+    gps["alt"] = sample.depth;
+    gps["sog"] = 0;
+    gps["cog"] = 0;
+
+    JsonObject ultrasonic = doc.createNestedObject("ultrasonic");
+    ultrasonic["dist1"] = round(sample.distance1 * 100) / 100.0;
+    ultrasonic["dist2"] = round(sample.distance2 * 100) / 100.0;
+
+    std::string timestamp = (sample.isValid ? oldWibTimestamp(sample) : oldNowTimestamp()).c_str();
+    doc["timestamp"] = timestamp;
+
+    std::string payload;
+    serializeJson(doc, payload);
+    return String(payload);
+}
+
+// sensorDataToJson (antrean offline, schema lama)
+static String oldDynamicPayload(const VatSensorData& data) {
+    CountingJsonDocument doc(1024);
+
+    doc["device_id"] = DEVICE_ID;
+    doc["data"]["distance1"] = round(data.distance1 * 10) / 10.0;
+    doc["data"]["distance2"] = round(data.distance2 * 10) / 10.0;
+    doc["data"]["latitude"] = data.latitude;
+    doc["data"]["longitude"] = data.longitude;
+    doc["data"]["depth"] = round(data.depth * 10) / 10.0;
+    std::string timestamp = oldWibTimestamp(data).c_str();
+    doc["timestamp"] = timestamp;
+
+    std::string jsonString;
+    serializeJson(doc, jsonString);
+    return String(jsonString);
+}
+
+// WiFi sendDataToAPI (payload String +=)
+static String oldConcatPayload(const VatSensorData& sample) {
+    String payload = "{\n";
+    payload += "  \"device_id\": \"" + String(DEVICE_ID) + "\",\n";
+    payload += "  \"data\": {\n";
+    payload += "    \"distance1\": " + String(sample.distance1, 1) + ",\n";
+    payload += "    \"distance2\": " + String(sample.distance2, 1) + ",\n";
+    payload += "    \"latitude\": " + String(sample.latitude, 6) + ",\n";
+    payload += "    \"longitude\": " + String(sample.longitude, 6) + "\n";
+    payload += "  },\n";
+    payload += "  \"timestamp\": \"" + (sample.isValid ? oldWibTimestamp(sample) : oldNowTimestamp()) + "\"\n";
+    payload += "}";
+    return payload;
+}
+
+typedef String (*OldEncoder)(const VatSensorData& sample);
+
+// sendBatch lama: body String disambung per sampel sampai GSM_BATCH_MAX_BYTES
+static size_t oldBatches(const std::vector<VatSensorData>& samples, OldEncoder encode, size_t& batches) {
+    size_t total = 0;
+    batches = 0;
+    for (size_t i = 0; i < samples.size();) {
+        String body = "[";
+        body.reserve(GSM_BATCH_MAX_BYTES);
+        size_t packed = 0;
+        for (; i < samples.size(); i++) {
+            String item = encode(samples[i]);
+            if (packed > 0 && body.length() + item.length() + 2 > GSM_BATCH_MAX_BYTES) break;
+            if (packed > 0) body += ",";
+            body += item;
+            packed++;
+        }
+        body += "]";
+        total += body.length();
+        batches++;
+    }
+    return total;
+}
+
+// =======================================================
+//   JALUR BARU (GSMApiHandler::encodeJsonBatch)
+// =======================================================
+
+static char batchBuffer[GSM_BATCH_MAX_BYTES + 1];
+
+static size_t newBatches(const std::vector<VatSensorData>& samples, size_t& batches) {
+    size_t total = 0;
+    batches = 0;
+    for (size_t i = 0; i < samples.size();) {
+        size_t length = 0;
+        size_t packed = 0;
+        batchBuffer[length++] = '[';
+        for (; i < samples.size(); i++) {
+            char* item = batchBuffer + length + (packed > 0 ? 1 : 0);
+            size_t room = GSM_BATCH_MAX_BYTES - (item - batchBuffer);
+            size_t itemLength = encode_production_json(samples[i], DEVICE_ID, NULL, item, room > 1 ? room - 1 : 0);
+            if (itemLength == 0) break;
+            if (packed > 0) batchBuffer[length++] = ',';
+            length += itemLength;
+            packed++;
+        }
+        batchBuffer[length++] = ']';
+        batchBuffer[length] = '\0';
+        if (packed == 0) i++;   // Sampel tidak muat sama sekali - lewati
+        total += length;
+        batches++;
+    }
+    return total;
+}
+
+// =======================================================
+//   TRACE & REPORT
+// =======================================================
+
+// Sama dengan trace sintetis gzipbench-native; setiap sampel ke-10 tanpa waktu GPS
+static void synthesizeSamples(std::vector<VatSensorData>& samples) {
+    VatSensorData sample;
+    memset(&sample, 0, sizeof(sample));
+    sample.isValid = true;
+    sample.year = 2025;
+    sample.month = 1;
+    sample.day = 15;
+    sample.latitude = -6.175392;
+    sample.longitude = 106.827153;
+    sample.satellites = 9;
+    sample.hdop = 0.9f;
+
+    unsigned random = 12345;
+    for (int i = 0; i < 3600; i++) {
+        random = random * 1103515245 + 12345;
+        sample.hour = i / 3600;
+        sample.minute = (i / 60) % 60;
+        sample.second = i % 60;
+        sample.distance1 = 25.0f + (i % 600) * 0.01f + (random >> 16) % 8 * 0.1f;
+        sample.distance2 = 30.0f + (i % 900) * 0.01f + (random >> 20) % 8 * 0.1f;
+        sample.latitude += ((int)((random >> 8) % 5) - 2) * 1e-7;
+        sample.longitude += ((int)((random >> 12) % 5) - 2) * 1e-7;
+        sample.depth = 2.84f * sample.distance2 - 16.6f;
+        sample.isValid = i % 10 != 9;
+        samples.push_back(sample);
+    }
+}
+
+static void report(const char* path, const std::vector<VatSensorData>& samples, OldEncoder encode) {
+    size_t batches = 0;
+    size_t bytes = 0;
+
+    allocations = 0;
+    countingAllocations = true;
+    bytes = encode ? oldBatches(samples, encode, batches) : newBatches(samples, batches);
+    countingAllocations = false;
+    unsigned long allocationsPerRound = allocations;
+
+    double startUs = nowUs();
+    for (int round = 0; round < JSON_BENCH_ROUNDS; round++) {
+        encode ? oldBatches(samples, encode, batches) : newBatches(samples, batches);
+    }
+    double elapsedUs = (nowUs() - startUs) / JSON_BENCH_ROUNDS;
+
+    double count = samples.size();
+    printf("JSON,%s,%u,%u,%.1f,%.0f,%.2f\n", path, (unsigned)samples.size(), (unsigned)batches,
+           bytes / count, elapsedUs * 1000.0 / count, allocationsPerRound / count);
+}
+
+int main() {
+    Serial.setEnabled(false);
+    host_set_time(JSON_BENCH_NOW);
+
+    std::vector<VatSensorData> samples;
+    synthesizeSamples(samples);
+
+    // Contoh output satu sampel per jalur
+    char json[PRODUCTION_JSON_MAX_SIZE];
+    encode_production_json(samples[0], DEVICE_ID, NULL, json, sizeof(json));
+    printf("# telemetry_json      %s\n", json);
+    printf("# arduinojson_static  %s\n", oldStaticPayload(samples[0]).c_str());
+    printf("# arduinojson_dynamic %s\n", oldDynamicPayload(samples[0]).c_str());
+
+    printf("#JSON,path,samples,batches,bytes_per_sample,host_ns_per_sample,allocs_per_sample\n");
+    report("telemetry_json", samples, NULL);
+    report("arduinojson_static", samples, oldStaticPayload);
+    report("arduinojson_dynamic", samples, oldDynamicPayload);
+    report("string_concat", samples, oldConcatPayload);
+    return 0;
+}
@@ -0,0 +1,285 @@
+// =======================================================
+//   LOG RETENTION TEST - HOST (env:logretention-native)
+//   LogRetention di atas SimFs (tools/host) dengan jam sistem simulasi:
+//     - parseLogFileName: nama valid / tidak valid, tanggal dan jenis ekstensi
+//     - umur log (LOG_RETENTION_DAYS) dengan jam sistem
+//     - lebih dari LOG_RETENTION_MAX_FILES log: insertEntry membuang entri terbaru,
+//       pass pertama menghapus yang tertua, sisanya di pass berikutnya
+//     - hysteresis watermark free space (LOW / HIGH_FREE_PERCENT)
+//     - tanpa jam sistem: tanggal log terbaru (termasuk yang tidak muat) = hari ini
+//     pio run -e logretention-native && .pio/build/logretention-native/program
+//   Exit code 1 jika ada pemeriksaan yang gagal.
+// =======================================================
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "../tools/host/host_arduino.cpp"
+#include "../tools/host/sim_fs.cpp"
+#include "../lib/SdUtils/crc32.cpp"
+#include "../lib/SdUtils/segmented_queue.cpp"
+#include "../lib/SdUtils/binary_log.cpp"
+#include "../lib/SdUtils/log_compress.cpp"
+#include "../lib/SdUtils/log_export.cpp"
+#include "../lib/SdUtils/log_retention.cpp"
+#include "../lib/SdUtils/sd_utils.cpp"
+#include "../lib/Telemetry/telemetry_json.cpp"
+#include "../lib/Telemetry/telemetry_delta.cpp"
+
+static unsigned long checks = 0;
+static unsigned long failures = 0;
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+#define CHECK_EQ(actual, expected) checkEqual((long)(actual), (long)(expected), #actual, __LINE__)
+
+static void check(bool ok, const char* expression, int line) {
+    checks++;
+    if (ok) return;
+    failures++;
+    printf("  FAIL line %d: %s\n", line, expression);
+}
+
+static void checkEqual(long actual, long expected, const char* expression, int line) {
+    checks++;
+    if (actual == expected) return;
+    failures++;
+    printf("  FAIL line %d: %s = %ld, expected %ld\n", line, expression, actual, expected);
+}
+
+static uint32_t dayOf(int year, int month, int date) {
+    struct tm tm = {0};
+    tm.tm_year = year - 1900;
+    tm.tm_mon = month - 1;
+    tm.tm_mday = date;
+    return (uint32_t)(timegm_custom(&tm) / 86400);
+}
+
+static std::string logPath(uint32_t day, uint8_t extension) {
+    time_t dayStart = (time_t)day * 86400;
+    struct tm tm;
+    gmtime_r(&dayStart, &tm);
+    return generateLogFileName(tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+                               LogRetention::getExtension(extension)).c_str();
+}
+
+static void createFile(const std::string& path, size_t size) {
+    simFs.writeFile(path, std::vector<uint8_t>(size, 'x'));
+}
+
+// Log untuk setiap hari di days, dibuat dalam urutan acak (urutan entri direktori FAT)
+static void createLogs(std::vector<uint32_t> days, size_t size, unsigned int seed) {
+    srand(seed);
+    for (size_t i = days.size(); i > 1; i--) std::swap(days[i - 1], days[rand() % i]);
+    for (size_t i = 0; i < days.size(); i++) {
+        createFile(logPath(days[i], (uint8_t)(days[i] % LOG_FILE_KIND_COUNT)), size);
+    }
+}
+
+static bool logExists(uint32_t day) {
+    return simFs.exists(logPath(day, (uint8_t)(day % LOG_FILE_KIND_COUNT)));
+}
+
+static std::vector<uint32_t> dayRange(uint32_t first, uint32_t last) {
+    std::vector<uint32_t> days;
+    for (uint32_t day = first; day <= last; day++) days.push_back(day);
+    return days;
+}
+
+// Satu pass penuh (scan + delete); return jumlah file yang dihapus pass ini
+static uint32_t runPass(LogRetention& retention, int daysToKeep) {
+    uint32_t before = retention.getFilesDeleted();
+    host_advance_ms(LOG_RETENTION_INTERVAL);
+    retention.tick(daysToKeep);
+    for (int i = 0; i < 10000 && retention.isRunning(); i++) retention.tick(daysToKeep);
+    CHECK(!retention.isRunning());
+    return retention.getFilesDeleted() - before;
+}
+
+static uint8_t freePercent() {
+    return (uint8_t)((simFs.getCapacity() - simFs.getUsedBytes()) * 100 / simFs.getCapacity());
+}
+
+// =======================================================
+//   TESTS
+// =======================================================
+
+static void testParseLogFileName() {
+    printf("parseLogFileName\n");
+    uint32_t day;
+    uint8_t extension;
+
+    CHECK(LogRetention::parseLogFileName("vatlog_2025-01-15.csv", day, extension));
+    CHECK_EQ(day, dayOf(2025, 1, 15));
+    CHECK_EQ(extension, LOG_FILE_CSV);
+    CHECK(LogRetention::parseLogFileName("/vatlog_2024-02-29.bin", day, extension));
+    CHECK_EQ(day, dayOf(2024, 2, 29));
+    CHECK_EQ(extension, LOG_FILE_BIN);
+    CHECK(LogRetention::parseLogFileName("/sd/vatlog_2025-12-31.csv.lzs", day, extension));
+    CHECK_EQ(day, dayOf(2025, 12, 31));
+    CHECK_EQ(extension, LOG_FILE_CSV_LZS);
+    CHECK(LogRetention::parseLogFileName("vatlog_2000-01-01.bin.lzs", day, extension));
+    CHECK_EQ(day, 10957);
+    CHECK_EQ(extension, LOG_FILE_BIN_LZS);
+
+    const char* invalid[] = {
+        "vatlog_2025-01-15.txt", "vatlog_2025-01-15.csv.bak", "vatlog_2025-01-15", "vatlog_2025-1-15.csv",
+        "vatlog_25-01-15.csv", "vatlog_1999-12-31.csv", "vatlog_2025-13-01.csv", "vatlog_2025-00-10.csv",
+        "vatlog_2025-01-32.csv", "vatlog_2025-01-00.csv", "datalog_2025-01-15.csv", "vatlog_2025-01-15.lzs",
+        "/queue/seg_000001.txt", "", "vatlog_.csv"
+    };
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        if (LogRetention::parseLogFileName(invalid[i], day, extension)) {
+            checks++;
+            failures++;
+            printf("  FAIL: \"%s\" accepted\n", invalid[i]);
+        } else {
+            checks++;
+        }
+    }
+
+    for (uint8_t kind = 0; kind < LOG_FILE_KIND_COUNT; kind++) {
+        std::string path = logPath(dayOf(2025, 6, 1), kind);
+        CHECK(LogRetention::parseLogFileName(path.c_str(), day, extension));
+        CHECK_EQ(extension, kind);
+    }
+}
+
+static void testExpiry() {
+    printf("expiry with system clock\n");
+    simFs.format();
+    uint32_t today = dayOf(2025, 3, 1);
+    host_set_time((time_t)today * 86400 + 12 * 3600);
+
+    createLogs(dayRange(today - 59, today), 1000, 1);
+    createFile("/offline_queue.txt", 100);
+    createFile("/vatlog_notes.txt", 100);
+
+    LogRetention retention;
+    CHECK_EQ(runPass(retention, LOG_RETENTION_DAYS), 59 - LOG_RETENTION_DAYS);
+    for (uint32_t day = today - 59; day <= today; day++) {
+        if (logExists(day) != (today - day <= (uint32_t)LOG_RETENTION_DAYS)) {
+            checks++;
+            failures++;
+            printf("  FAIL: log %u days old %s\n", today - day, logExists(day) ? "kept" : "deleted");
+        }
+    }
+    CHECK(simFs.exists("/offline_queue.txt"));
+    CHECK(simFs.exists("/vatlog_notes.txt"));
+
+    // Pass berikutnya tidak menghapus apa pun; daysToKeep <= 0 mematikan batas umur
+    CHECK_EQ(runPass(retention, LOG_RETENTION_DAYS), 0);
+    CHECK_EQ(runPass(retention, 0), 0);
+    CHECK(logExists(today - LOG_RETENTION_DAYS));
+}
+
+static void testMaxFilesEviction() {
+    printf("more than LOG_RETENTION_MAX_FILES logs\n");
+    simFs.format();
+    uint32_t today = dayOf(2025, 6, 1);
+    host_set_time((time_t)today * 86400 + 3600);
+
+    // 200 log kedaluwarsa + log hari ini, entri direktori diacak
+    const uint32_t expiredCount = 200;
+    uint32_t first = today - 400;
+    std::vector<uint32_t> days = dayRange(first, first + expiredCount - 1);
+    days.push_back(today);
+    createLogs(days, 100, 2);
+
+    LogRetention retention;
+    CHECK_EQ(runPass(retention, LOG_RETENTION_DAYS), LOG_RETENTION_MAX_FILES);
+
+    // Yang dihapus harus tepat LOG_RETENTION_MAX_FILES log tertua
+    uint32_t wrong = 0;
+    for (uint32_t i = 0; i < expiredCount; i++) {
+        if (logExists(first + i) != (i >= LOG_RETENTION_MAX_FILES)) wrong++;
+    }
+    CHECK_EQ(wrong, 0);
+    CHECK(logExists(today));
+
+    CHECK_EQ(runPass(retention, LOG_RETENTION_DAYS), expiredCount - LOG_RETENTION_MAX_FILES);
+    CHECK_EQ(simFs.list("/").size(), 1);
+    CHECK(logExists(today));
+}
+
+static void testWatermarkHysteresis() {
+    printf("free space watermark hysteresis\n");
+    const uint64_t capacity = 1000000;
+    const size_t logSize = 46000;       // 20 log = 92% terpakai (free 8% < LOW)
+    simFs.format(capacity);
+    uint32_t today = dayOf(2025, 6, 1);
+    host_set_time((time_t)today * 86400 + 3600);
+
+    // Semua log masih dalam LOG_RETENTION_DAYS - hanya free space yang memicu penghapusan
+    createLogs(dayRange(today - 19, today), logSize, 3);
+    CHECK(freePercent() < LOG_RETENTION_LOW_FREE_PERCENT);
+
+    LogRetention retention;
+    // Hapus sampai free >= HIGH (bukan berhenti begitu free >= LOW)
+    CHECK_EQ(runPass(retention, LOG_RETENTION_DAYS), 3);
+    CHECK(freePercent() >= LOG_RETENTION_HIGH_FREE_PERCENT);
+    CHECK(!logExists(today - 19) && !logExists(today - 18) && !logExists(today - 17));
+    CHECK(logExists(today - 16));
+
+    // Di antara watermark tanpa sedang purging: tidak ada yang dihapus
+    createFile("/export_all.csv", 68000);
+    CHECK(freePercent() >= LOG_RETENTION_LOW_FREE_PERCENT && freePercent() < LOG_RETENTION_HIGH_FREE_PERCENT);
+    CHECK_EQ(runPass(retention, LOG_RETENTION_DAYS), 0);
+
+    // Turun lagi di bawah LOW: purging sampai HIGH lagi
+    createFile("/backup.bin", 60000);
+    CHECK(freePercent() < LOG_RETENTION_LOW_FREE_PERCENT);
+    CHECK_EQ(runPass(retention, LOG_RETENTION_DAYS), 3);
+    CHECK(freePercent() >= LOG_RETENTION_HIGH_FREE_PERCENT);
+
+    // Kartu penuh (free 0%): 5 log x 4.6% sampai free >= HIGH
+    createFile("/backup.bin", (size_t)(capacity - simFs.getUsedBytes() + 60000));
+    CHECK_EQ(runPass(retention, LOG_RETENTION_DAYS), 5);
+    CHECK(freePercent() >= LOG_RETENTION_HIGH_FREE_PERCENT);
+    CHECK(logExists(today));
+}
+
+static void testNoClockFallback() {
+    printf("no system clock: newest log is today\n");
+    simFs.format();
+    host_set_time(0);
+    time_t now;
+    CHECK(!system_clock_epoch(now));
+
+    // 150 log: yang terbaru tidak muat di entries tapi tetap menentukan "hari ini"
+    uint32_t newest = dayOf(2025, 6, 1);
+    uint32_t first = newest - 149;
+    createLogs(dayRange(first, newest), 100, 4);
+
+    LogRetention retention;
+    uint32_t expired = newest - LOG_RETENTION_DAYS - first;   // Umur > LOG_RETENTION_DAYS dari log terbaru
+    CHECK_EQ(runPass(retention, LOG_RETENTION_DAYS), expired);
+    CHECK(!logExists(newest - LOG_RETENTION_DAYS - 1));
+    CHECK(logExists(newest - LOG_RETENTION_DAYS));
+    CHECK(logExists(newest));
+
+    // Kartu penuh oleh file lain: purging tidak pernah mencapai HIGH, log terbaru tetap
+    const uint64_t capacity = 1000000;
+    std::vector<std::string> files = simFs.list("/");
+    simFs.format(capacity);
+    for (size_t i = 0; i < files.size(); i++) createFile(files[i], 100);
+    createFile("/export_all.csv", (size_t)(capacity - simFs.getUsedBytes()));
+    CHECK_EQ(runPass(retention, LOG_RETENTION_DAYS), LOG_RETENTION_DAYS);
+    CHECK_EQ(simFs.list("/").size(), 2);
+    CHECK(logExists(newest));
+}
+
+int main() {
+    Serial.setEnabled(false);
+
+    testParseLogFileName();
+    testExpiry();
+    testMaxFilesEviction();
+    testWatermarkHysteresis();
+    testNoClockFallback();
+
+    printf("%s: %lu checks, %lu failures\n", failures ? "FAIL" : "PASS", checks, failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,310 @@
+// =======================================================
+//   OFFLINE QUEUE POWER-CUT FUZZ - HOST (env:queuefuzz-native)
+//   SegmentedQueue di atas SimFs (tools/host): setiap iterasi menjalankan
+//   workload acak enqueue / peek+ack / clear, memotong listrik pada unit
+//   mutasi acak (bisa di tengah record atau di tengah write metadata),
+//   kadang memotong lagi saat begin() recovery, lalu memeriksa isi antrean:
+//     - record yang enqueue-nya berhasil dan belum di-ack tidak hilang
+//     - record yang ack-nya berhasil tidak muncul lagi
+//     - urutan terjaga, tanpa duplikat, payload utuh
+//     - record terpotong (tail torn) muncul paling banyak sekali sebagai length 0
+//     - pendingRecords() sama dengan jumlah record yang bisa di-drain
+//     - segmen yang sudah di-ack tidak tertinggal di /queue
+//     pio run -e queuefuzz-native && .pio/build/queuefuzz-native/program [iterasi] [seed]
+//   Exit code 1 jika ada pelanggaran (seed iterasi dicetak untuk reproduksi).
+// =======================================================
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <deque>
+#include <set>
+#include <vector>
+#include "../tools/host/host_arduino.cpp"
+#include "../tools/host/sim_fs.cpp"
+#include "../lib/SdUtils/crc32.cpp"
+#include "../lib/SdUtils/segmented_queue.cpp"
+
+#define FUZZ_DEFAULT_ITERATIONS 3000
+#define FUZZ_OPS_PER_ITERATION 160
+#define FUZZ_POST_RECOVERY_RECORDS 5
+
+enum FuzzOp { OP_NONE, OP_ENQUEUE, OP_ACK, OP_CLEAR };
+
+struct FuzzStats {
+    unsigned long iterations;
+    unsigned long failures;
+    unsigned long cutsInEnqueue;
+    unsigned long cutsInAck;
+    unsigned long cutsInClear;
+    unsigned long tornMetaSlots;        // Slot metadata tidak valid setelah power cut
+    unsigned long tornTails;            // Record terpotong yang muncul sebagai length 0
+    unsigned long secondCuts;           // Power cut kedua saat begin() recovery
+    unsigned long recordsChecked;
+};
+
+static FuzzStats stats;
+static uint32_t rngState;
+
+static uint32_t nextRandom() {
+    // xorshift32 - deterministik per seed, tidak bergantung libc
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+static uint32_t randomBelow(uint32_t limit) {
+    return limit == 0 ? 0 : nextRandom() % limit;
+}
+
+// Payload deterministik dari id: panjang bervariasi agar segmen bergulir di tengah record
+static size_t makeRecord(uint32_t id, char* out, size_t size) {
+    uint32_t mix = id * 2654435761UL;
+    size_t padding = 8 + (mix >> 8) % 180;
+    int length = snprintf(out, size, "{\"id\":%lu,\"pad\":\"", (unsigned long)id);
+    for (size_t i = 0; i < padding && (size_t)length + 3 < size; i++) {
+        out[length++] = 'a' + (char)((mix + i) % 26);
+    }
+    out[length++] = '"';
+    out[length++] = '}';
+    out[length] = '\0';
+    return length;
+}
+
+static bool parseRecordId(const char* record, size_t length, uint32_t& id) {
+    unsigned long value;
+    if (length == 0 || sscanf(record, "{\"id\":%lu,", &value) != 1) return false;
+    id = value;
+    char expected[QUEUE_RECORD_MAX_SIZE + 1];
+    size_t expectedLength = makeRecord(id, expected, sizeof(expected));
+    return expectedLength == length && memcmp(expected, record, length) == 0;
+}
+
+static bool isMetaSlotValid(const char* path) {
+    std::vector<uint8_t> data;
+    if (!simFs.readFile(path, data) || data.size() != sizeof(QueueMeta)) return false;
+    QueueMeta meta;
+    memcpy(&meta, &data[0], sizeof(meta));
+    return meta.magic == QUEUE_META_MAGIC && meta.crc == crc32Compute(&meta, offsetof(QueueMeta, crc));
+}
+
+// Keadaan model setelah workload: record pasti pending + operasi yang terpotong listrik
+struct FuzzModel {
+    std::deque<uint32_t> pending;
+    std::vector<uint32_t> inFlightAck;  // Di-ack saat listrik mati (ack gagal)
+    uint32_t inFlightEnqueue;           // Id enqueue yang gagal saat listrik mati (0 = tidak ada)
+    FuzzOp cutOp;
+    uint32_t nextId;
+};
+
+// Workload acak; berhenti setelah operasi yang sedang jalan saat listrik mati
+static void runWorkload(uint32_t seed, FuzzModel& model) {
+    rngState = seed;
+    model.pending.clear();
+    model.inFlightAck.clear();
+    model.inFlightEnqueue = 0;
+    model.cutOp = OP_NONE;
+    model.nextId = 1;
+
+    SegmentedQueue queue;
+    if (!queue.begin()) return;
+
+    char record[QUEUE_RECORD_MAX_SIZE + 1];
+    char buffer[2048];
+    const char* records[QUEUE_PEEK_MAX_RECORDS];
+    size_t lengths[QUEUE_PEEK_MAX_RECORDS];
+
+    for (int op = 0; op < FUZZ_OPS_PER_ITERATION; op++) {
+        uint32_t roll = randomBelow(100);
+
+        if (roll < 65) {
+            uint32_t id = model.nextId++;
+            size_t length = makeRecord(id, record, sizeof(record));
+            bool ok = queue.enqueue(record, length);
+            if (ok) model.pending.push_back(id);
+            if (simFs.isPowerLost()) {
+                model.cutOp = OP_ENQUEUE;
+                if (!ok) model.inFlightEnqueue = id;
+                return;
+            }
+        } else if (roll < 99) {
+            size_t count = queue.peek(1 + randomBelow(8), buffer, sizeof(buffer), records, lengths);
+            size_t ackCount = randomBelow(count + 1);
+            bool ok = queue.ack(ackCount);
+            std::vector<uint32_t> acked(model.pending.begin(), model.pending.begin() + ackCount);
+            if (ok) {
+                model.pending.erase(model.pending.begin(), model.pending.begin() + ackCount);
+            }
+            if (simFs.isPowerLost()) {
+                model.cutOp = OP_ACK;
+                if (!ok) model.inFlightAck = acked;
+                return;
+            }
+        } else {
+            queue.clear();
+            if (simFs.isPowerLost()) {
+                model.cutOp = OP_CLEAR;
+                return;
+            }
+            model.pending.clear();
+        }
+    }
+}
+
+static bool fail(uint32_t seed, const char* message, unsigned long value = 0) {
+    printf("FAIL seed=%lu: %s (%lu)\n", (unsigned long)seed, message, value);
+    stats.failures++;
+    return false;
+}
+
+static bool runIteration(uint32_t seed) {
+    FuzzModel model;
+
+    // Putaran tanpa cut hanya untuk mengukur total unit mutasi workload ini
+    simFs.format();
+    runWorkload(seed, model);
+    uint32_t totalUnits = simFs.getUnitsUsed();
+
+    rngState = seed ^ 0x9E3779B9UL;
+    uint32_t cutAt = 1 + randomBelow(totalUnits);
+    bool secondCut = randomBelow(4) == 0;
+    uint32_t secondCutAt = 1 + randomBelow(64);
+
+    simFs.format();
+    simFs.cutPowerAfter(cutAt);
+    runWorkload(seed, model);
+    if (!simFs.isPowerLost()) return true;  // Cut jatuh di unit terakhir - tidak ada yang diuji
+
+    if (model.cutOp == OP_ENQUEUE) stats.cutsInEnqueue++;
+    if (model.cutOp == OP_ACK) stats.cutsInAck++;
+    if (model.cutOp == OP_CLEAR) stats.cutsInClear++;
+    if (simFs.exists(QUEUE_META_FILE_A) && !isMetaSlotValid(QUEUE_META_FILE_A)) stats.tornMetaSlots++;
+    if (simFs.exists(QUEUE_META_FILE_B) && !isMetaSlotValid(QUEUE_META_FILE_B)) stats.tornMetaSlots++;
+
+    if (secondCut) {
+        stats.secondCuts++;
+        simFs.cutPowerAfter(secondCutAt);
+        SegmentedQueue interrupted;
+        interrupted.begin();
+    }
+
+    simFs.powerOn();
+    SegmentedQueue queue;
+    if (!queue.begin()) return fail(seed, "begin() failed after power cut");
+
+    char record[QUEUE_RECORD_MAX_SIZE + 1];
+    uint32_t firstPostId = model.nextId;
+    for (uint32_t i = 0; i < FUZZ_POST_RECOVERY_RECORDS; i++) {
+        size_t length = makeRecord(firstPostId + i, record, sizeof(record));
+        if (!queue.enqueue(record, length)) return fail(seed, "enqueue failed after recovery");
+    }
+    uint32_t pendingBefore = queue.pendingRecords();
+
+    // Drain semua
+    char buffer[2048];
+    const char* records[QUEUE_PEEK_MAX_RECORDS];
+    size_t lengths[QUEUE_PEEK_MAX_RECORDS];
+    std::vector<uint32_t> drained;
+    size_t tornEntries = 0;
+    size_t total = 0;
+    while (true) {
+        size_t count = queue.peek(QUEUE_PEEK_MAX_RECORDS, buffer, sizeof(buffer), records, lengths);
+        if (count == 0) break;
+        for (size_t i = 0; i < count; i++) {
+            uint32_t id;
+            if (lengths[i] == 0) {
+                tornEntries++;
+            } else if (!parseRecordId(records[i], lengths[i], id)) {
+                return fail(seed, "corrupt record payload", lengths[i]);
+            } else {
+                drained.push_back(id);
+            }
+        }
+        total += count;
+        if (!queue.ack(count)) return fail(seed, "ack failed during drain");
+        if (total > 100000) return fail(seed, "drain does not terminate");
+    }
+
+    stats.recordsChecked += total;
+    if (tornEntries > 0) stats.tornTails++;
+    if (pendingBefore != total) return fail(seed, "pendingRecords() != drained records", pendingBefore);
+    if (queue.pendingRecords() != 0 || !queue.isEmpty()) return fail(seed, "queue not empty after drain");
+    if (tornEntries > 1) return fail(seed, "more than one torn record", tornEntries);
+    if (tornEntries == 1 && model.cutOp != OP_ENQUEUE) return fail(seed, "torn record without cut in enqueue");
+
+    for (size_t i = 1; i < drained.size(); i++) {
+        if (drained[i] <= drained[i - 1]) return fail(seed, "records out of order or duplicated", drained[i]);
+    }
+
+    // Record setelah recovery harus utuh di akhir
+    if (drained.size() < FUZZ_POST_RECOVERY_RECORDS) return fail(seed, "post-recovery records lost");
+    for (uint32_t i = 0; i < FUZZ_POST_RECOVERY_RECORDS; i++) {
+        if (drained[drained.size() - FUZZ_POST_RECOVERY_RECORDS + i] != firstPostId + i) {
+            return fail(seed, "post-recovery record mismatch", firstPostId + i);
+        }
+    }
+    drained.resize(drained.size() - FUZZ_POST_RECOVERY_RECORDS);
+
+    std::set<uint32_t> found(drained.begin(), drained.end());
+    std::set<uint32_t> allowed(model.pending.begin(), model.pending.end());
+    allowed.insert(model.inFlightAck.begin(), model.inFlightAck.end());
+
+    bool clearTookEffect = model.cutOp == OP_CLEAR && !model.pending.empty() && found.empty();
+    if (!clearTookEffect) {
+        for (size_t i = 0; i < model.pending.size(); i++) {
+            if (!found.count(model.pending[i])) return fail(seed, "pending record lost", model.pending[i]);
+        }
+    }
+    // ack yang gagal tidak boleh menggeser head: record-nya harus kembali
+    for (size_t i = 0; i < model.inFlightAck.size(); i++) {
+        if (!found.count(model.inFlightAck[i])) return fail(seed, "record of failed ack lost", model.inFlightAck[i]);
+    }
+    for (std::set<uint32_t>::const_iterator it = found.begin(); it != found.end(); ++it) {
+        if (!allowed.count(*it)) {
+            if (*it == model.inFlightEnqueue) return fail(seed, "failed enqueue returned intact record", *it);
+            return fail(seed, "acked record reappeared", *it);
+        }
+    }
+
+    // Segmen yang sudah di-ack (di bawah head) tidak boleh tertinggal
+    std::vector<std::string> entries = simFs.list(QUEUE_DIR);
+    for (size_t i = 0; i < entries.size(); i++) {
+        unsigned long segment;
+        const char* base = strrchr(entries[i].c_str(), '/');
+        base = base ? base + 1 : entries[i].c_str();
+        if (sscanf(base, "seg_%lu.txt", &segment) == 1 && segment < queue.getHeadSegment()) {
+            return fail(seed, "acked segment left on card", segment);
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    unsigned long iterations = argc > 1 ? strtoul(argv[1], NULL, 10) : FUZZ_DEFAULT_ITERATIONS;
+    uint32_t baseSeed = argc > 2 ? strtoul(argv[2], NULL, 10) : 1;
+    Serial.setEnabled(false);
+    memset(&stats, 0, sizeof(stats));
+
+    printf("Queue power-cut fuzz: %lu iterations, seed %lu, segment %lu bytes\n",
+           iterations, (unsigned long)baseSeed, (unsigned long)QUEUE_SEGMENT_MAX_BYTES);
+
+    for (unsigned long i = 0; i < iterations; i++) {
+        // Seed 0 membuat xorshift macet di 0
+        uint32_t seed = (baseSeed * 2654435761UL + i * 40503UL) | 1;
+        runIteration(seed);
+        stats.iterations++;
+        if (stats.failures >= 10) break;
+    }
+
+    printf("iterations        %lu\n", stats.iterations);
+    printf("cuts in enqueue   %lu\n", stats.cutsInEnqueue);
+    printf("cuts in ack       %lu\n", stats.cutsInAck);
+    printf("cuts in clear     %lu\n", stats.cutsInClear);
+    printf("torn meta slots   %lu\n", stats.tornMetaSlots);
+    printf("torn tails        %lu\n", stats.tornTails);
+    printf("second cuts       %lu\n", stats.secondCuts);
+    printf("records checked   %lu\n", stats.recordsChecked);
+    printf("%s: %lu failures\n", stats.failures ? "FAIL" : "PASS", stats.failures);
+    return stats.failures ? 1 : 0;
+}
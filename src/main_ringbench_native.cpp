@@ -0,0 +1,336 @@
+// =======================================================
+//   SAMPLE RING TEST & BENCHMARK - HOST (env:ringbench-native)
+//   SampleRing (lib/Pipeline/sample_ring.h, header yang sama dengan firmware):
+//     - kosong / penuh / overflow counter, wraparound buffer berkali-kali
+//     - peekBatch + consume sebagian (pola upload: buang setelah sukses)
+//     - wraparound index 32-bit (opsional, argumen "wrap32", ~2^32 push / ~10 detik)
+//     - stress SPSC dua thread: urutan, tanpa hilang/duplikat, tanpa sampel sobek
+//     - throughput push/pop satu thread dan dua thread (VatSensorData)
+//     pio run -e ringbench-native && .pio/build/ringbench-native/program [wrap32]
+//   Waktu diukur di host (x86 punya memory model lebih kuat dari Xtensa) -
+//   angka throughput hanya pembanding antar perubahan, bukan angka ESP32.
+// =======================================================
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <thread>
+#include "../include/config.h"
+#include "../lib/VatSensor/vat_sensor_data.h"
+#include "../lib/Pipeline/sample_ring.h"
+
+#define RING_STRESS_SAMPLES 5000000UL
+#define RING_BENCH_SAMPLES 20000000UL
+
+static unsigned long checks = 0;
+static unsigned long failures = 0;
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+static void check(bool ok, const char* expression, int line) {
+    checks++;
+    if (ok) return;
+    failures++;
+    printf("  FAIL line %d: %s\n", line, expression);
+}
+
+static double nowSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Semua field diturunkan dari seq agar sampel yang tersalin setengah terdeteksi
+static void makeSample(uint32_t seq, VatSensorData& sample) {
+    sample.isValid = (seq & 1) != 0;
+    sample.distance1 = (float)(seq & 0xFFFF) * 0.5f;
+    sample.distance2 = (float)(seq >> 16);
+    sample.latitude = -6.0 - seq * 1e-7;
+    sample.longitude = 106.0 + seq * 1e-7;
+    sample.depth = sample.distance1 - sample.distance2;
+    sample.year = 2000 + (seq % 100);
+    sample.month = 1 + seq % 12;
+    sample.day = 1 + seq % 28;
+    sample.hour = seq % 24;
+    sample.minute = seq % 60;
+    sample.second = (seq / 60) % 60;
+    sample.satellites = seq % 13;
+    sample.hdop = (float)(seq % 50) / 10.0f;
+    sample.capturedAtMs = seq;
+}
+
+static bool sampleMatches(const VatSensorData& sample, uint32_t seq) {
+    VatSensorData expected;
+    makeSample(seq, expected);
+    return sample.capturedAtMs == seq && sample.isValid == expected.isValid &&
+           sample.distance1 == expected.distance1 && sample.distance2 == expected.distance2 &&
+           sample.latitude == expected.latitude && sample.longitude == expected.longitude &&
+           sample.depth == expected.depth && sample.year == expected.year &&
+           sample.month == expected.month && sample.day == expected.day &&
+           sample.hour == expected.hour && sample.minute == expected.minute &&
+           sample.second == expected.second && sample.satellites == expected.satellites &&
+           sample.hdop == expected.hdop;
+}
+
+// =======================================================
+//   SINGLE-THREAD TESTS
+// =======================================================
+
+static void testEmptyFull() {
+    printf("empty / full / overflow\n");
+    SampleRing<uint32_t, 8> ring;
+    uint32_t value = 0;
+    uint32_t out[16];
+
+    CHECK(ring.capacity() == 8);
+    CHECK(ring.empty() && !ring.full() && ring.size() == 0);
+    CHECK(!ring.pop(value));
+    CHECK(ring.peekBatch(out, 16) == 0);
+    ring.consume(3);                    // Consume di ring kosong tidak boleh menggeser tail
+    CHECK(ring.size() == 0);
+
+    for (uint32_t i = 0; i < 8; i++) CHECK(ring.push(i));
+    CHECK(ring.full() && !ring.empty() && ring.size() == 8);
+    CHECK(!ring.push(100));
+    CHECK(!ring.push(101));
+    CHECK(ring.getOverflowCount() == 2);
+    CHECK(ring.size() == 8);
+
+    // Sampel yang ditolak tidak menimpa yang lama
+    CHECK(ring.popBatch(out, 16) == 8);
+    bool ordered = true;
+    for (uint32_t i = 0; i < 8; i++) ordered = ordered && out[i] == i;
+    CHECK(ordered);
+    CHECK(ring.empty());
+    CHECK(ring.getOverflowCount() == 2);
+}
+
+static void testWraparound() {
+    printf("buffer wraparound\n");
+    SampleRing<uint32_t, 8> ring;
+    uint32_t out[8];
+    uint32_t nextPush = 0;
+    uint32_t nextPop = 0;
+    bool ordered = true;
+    bool sized = true;
+
+    // Pola push/pop dengan panjang berbeda agar head/tail melewati batas buffer di semua posisi
+    for (uint32_t round = 0; round < 10000; round++) {
+        uint32_t pushes = 1 + (round * 7) % 8;
+        for (uint32_t i = 0; i < pushes && !ring.full(); i++) ring.push(nextPush++);
+        sized = sized && ring.size() == nextPush - nextPop && ring.size() <= 8;
+
+        size_t count = ring.popBatch(out, 1 + (round * 5) % 8);
+        for (size_t i = 0; i < count; i++) ordered = ordered && out[i] == nextPop++;
+    }
+    CHECK(ordered);
+    CHECK(sized);
+    CHECK(nextPush > 8 * 1000);
+    CHECK(ring.getOverflowCount() == 0);
+}
+
+static void testPeekConsume() {
+    printf("peekBatch / consume\n");
+    SampleRing<VatSensorData, PIPELINE_UPLOAD_RING_SIZE> ring;
+    VatSensorData sample;
+    VatSensorData out[PIPELINE_UPLOAD_RING_SIZE];
+
+    for (uint32_t i = 0; i < 10; i++) {
+        makeSample(i, sample);
+        ring.push(sample);
+    }
+
+    // Peek tidak mengeluarkan; peek ulang memberi sampel yang sama
+    CHECK(ring.peekBatch(out, 4) == 4);
+    CHECK(sampleMatches(out[0], 0) && sampleMatches(out[3], 3));
+    CHECK(ring.size() == 10);
+    CHECK(ring.peekBatch(out, 4) == 4);
+    CHECK(sampleMatches(out[0], 0));
+
+    // Upload gagal sebagian: hanya 3 yang di-consume, sisanya muncul lagi
+    ring.consume(3);
+    CHECK(ring.size() == 7);
+    CHECK(ring.peekBatch(out, PIPELINE_UPLOAD_RING_SIZE) == 7);
+    CHECK(sampleMatches(out[0], 3) && sampleMatches(out[6], 9));
+
+    // Producer menambah di antara peek dan consume - consume hanya membuang yang sudah di-peek
+    makeSample(10, sample);
+    ring.push(sample);
+    ring.consume(7);
+    CHECK(ring.size() == 1);
+    CHECK(ring.pop(sample) && sampleMatches(sample, 10));
+
+    // consume lebih dari isi ring dibatasi
+    makeSample(11, sample);
+    ring.push(sample);
+    ring.consume(100);
+    CHECK(ring.empty());
+    makeSample(12, sample);
+    CHECK(ring.push(sample));
+    CHECK(ring.pop(sample) && sampleMatches(sample, 12));
+}
+
+// Index head/tail berjalan bebas 32-bit: lewati 2^32 lalu periksa size/urutan
+static void testCounterWrap() {
+    printf("32-bit index wraparound (~2^32 push)\n");
+    SampleRing<uint32_t, 4> ring;
+    uint32_t out[4];
+    uint64_t total = (1ULL << 32) + 1000;
+    uint32_t expected = 0;
+    bool ordered = true;
+
+    for (uint64_t pushed = 0; pushed < total; pushed += 3) {
+        ring.push((uint32_t)pushed);
+        ring.push((uint32_t)pushed + 1);
+        ring.push((uint32_t)pushed + 2);
+        if (ring.size() != 3) ordered = false;
+        size_t count = ring.popBatch(out, 4);
+        for (size_t i = 0; i < count; i++) {
+            if (out[i] != expected++) ordered = false;
+        }
+        if (!ordered) break;
+    }
+    CHECK(ordered);
+    CHECK(ring.empty());
+    CHECK(ring.getOverflowCount() == 0);
+}
+
+// =======================================================
+//   SPSC STRESS (producer thread + consumer thread)
+// =======================================================
+
+static void testSpscStress() {
+    printf("SPSC stress: %lu samples, ring %d\n", RING_STRESS_SAMPLES, PIPELINE_STORAGE_RING_SIZE);
+    static SampleRing<VatSensorData, PIPELINE_STORAGE_RING_SIZE> ring;
+    unsigned long producerRetries = 0;
+
+    std::thread producer([&producerRetries]() {
+        VatSensorData sample;
+        for (uint32_t seq = 0; seq < RING_STRESS_SAMPLES; seq++) {
+            makeSample(seq, sample);
+            while (!ring.push(sample)) {
+                producerRetries++;
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    // Consumer bergantian pop / popBatch / peekBatch+consume sebagian
+    VatSensorData out[PIPELINE_STORAGE_RING_SIZE];
+    uint32_t expected = 0;
+    unsigned long torn = 0;
+    unsigned long misordered = 0;
+    unsigned long oversized = 0;
+    uint32_t mode = 0;
+    while (expected < RING_STRESS_SAMPLES) {
+        size_t count = 0;
+        size_t take = 0;
+        switch (mode++ % 3) {
+            case 0:
+                count = ring.pop(out[0]) ? 1 : 0;
+                take = count;
+                break;
+            case 1:
+                count = ring.popBatch(out, 1 + mode % PIPELINE_STORAGE_RING_SIZE);
+                take = count;
+                break;
+            default:
+                count = ring.peekBatch(out, PIPELINE_STORAGE_RING_SIZE);
+                take = count / 2 + (count & 1);
+                ring.consume(take);
+                break;
+        }
+        if (ring.size() > PIPELINE_STORAGE_RING_SIZE) oversized++;
+        for (size_t i = 0; i < take; i++) {
+            if (out[i].capturedAtMs != expected) {
+                misordered++;
+                expected = out[i].capturedAtMs;
+            }
+            if (!sampleMatches(out[i], expected)) torn++;
+            expected++;
+        }
+        if (count == 0) std::this_thread::yield();
+        if (misordered > 10) break;
+    }
+    producer.join();
+
+    CHECK(misordered == 0);
+    CHECK(torn == 0);
+    CHECK(oversized == 0);
+    CHECK(expected == RING_STRESS_SAMPLES);
+    CHECK(ring.empty());
+    CHECK(ring.getOverflowCount() == producerRetries);
+    printf("  producer full-ring retries: %lu\n", producerRetries);
+}
+
+// =======================================================
+//   THROUGHPUT
+// =======================================================
+
+static void benchSingleThread() {
+    static SampleRing<VatSensorData, PIPELINE_UPLOAD_RING_SIZE> ring;
+    VatSensorData sample;
+    VatSensorData out[16];
+    makeSample(1, sample);
+    uint32_t checksum = 0;
+
+    double start = nowSeconds();
+    for (unsigned long i = 0; i < RING_BENCH_SAMPLES; i += 16) {
+        for (int n = 0; n < 16; n++) {
+            sample.capturedAtMs = i + n;
+            ring.push(sample);
+        }
+        size_t count = ring.popBatch(out, 16);
+        checksum += out[count - 1].capturedAtMs;
+    }
+    double seconds = nowSeconds() - start;
+    printf("single thread push + popBatch(16): %.1f M samples/s (%.1f ns/sample, checksum %lu)\n",
+           RING_BENCH_SAMPLES / seconds / 1e6, seconds * 1e9 / RING_BENCH_SAMPLES, (unsigned long)checksum);
+}
+
+static void benchTwoThreads() {
+    static SampleRing<VatSensorData, PIPELINE_STORAGE_RING_SIZE> ring;
+    unsigned long retries = 0;
+
+    double start = nowSeconds();
+    std::thread producer([&retries]() {
+        VatSensorData sample;
+        makeSample(1, sample);
+        for (uint32_t seq = 0; seq < RING_BENCH_SAMPLES; seq++) {
+            sample.capturedAtMs = seq;
+            while (!ring.push(sample)) {
+                retries++;
+                std::this_thread::yield();   // Host 1 core: spin tanpa yield menunggu time slice habis
+            }
+        }
+    });
+
+    VatSensorData out[PIPELINE_STORAGE_RING_SIZE];
+    unsigned long received = 0;
+    while (received < RING_BENCH_SAMPLES) {
+        size_t count = ring.popBatch(out, PIPELINE_STORAGE_RING_SIZE);
+        if (count == 0) std::this_thread::yield();
+        received += count;
+    }
+    producer.join();
+    double seconds = nowSeconds() - start;
+    printf("two threads push / popBatch(%d): %.1f M samples/s (producer full-ring retries %lu)\n",
+           PIPELINE_STORAGE_RING_SIZE, RING_BENCH_SAMPLES / seconds / 1e6, retries);
+}
+
+int main(int argc, char** argv) {
+    bool wrap32 = argc > 1 && strcmp(argv[1], "wrap32") == 0;
+
+    testEmptyFull();
+    testWraparound();
+    testPeekConsume();
+    if (wrap32) testCounterWrap();
+    testSpscStress();
+
+    printf("%s: %lu checks, %lu failures\n", failures ? "FAIL" : "PASS", checks, failures);
+    if (failures) return 1;
+
+    benchSingleThread();
+    benchTwoThreads();
+    return 0;
+}
@@ -0,0 +1,135 @@
+// =======================================================
+//   SD BENCHMARK - ESP32 (env:sdbench)
+//   Firmware terpisah: hanya SD Card yang dipakai. Semua kombinasi clock SPI
+//   (SD_BENCH_SPI_CLOCKS) x record rate (SD_BENCH_RECORD_RATES) x pola tulis
+//   dijalankan, hasilnya satu baris "BENCH,..." per run di Serial.
+//     pio run -e sdbench -t upload && pio device monitor | grep -E "^#|^BENCH" > bench.csv
+//   Kartu harus FAT32 dan sebaiknya kosong; file /bench_* dihapus setelah setiap run.
+// =======================================================
+
+#include <Arduino.h>
+#include <SD.h>
+#include <SPI.h>
+#include "FS.h"
+#include "../lib/SdBench/sd_bench.h"
+#include "../include/config.h"
+
+class SdCardBenchIo : public BenchIo {
+public:
+    SdCardBenchIo() : frequency(0) {}
+
+    void setClock(uint32_t hz) { frequency = hz; }
+
+    const char* name() const override { return "esp32"; }
+    uint32_t clockHz() const override { return frequency; }
+
+    bool open(const char* path, BenchOpenMode mode) override {
+        const char* fileMode = mode == BENCH_OPEN_APPEND ? FILE_APPEND : (mode == BENCH_OPEN_CREATE ? FILE_WRITE : "r+");
+        file = SD.open(path, fileMode);
+        return (bool)file;
+    }
+
+    size_t write(const uint8_t* data, size_t length) override { return file.write(data, length); }
+    bool seek(uint32_t position) override { return file.seek(position); }
+    void flush() override { file.flush(); }
+
+    void close() override {
+        if (file) file.close();
+    }
+
+    void remove(const char* path) override {
+        if (SD.exists(path)) SD.remove(path);
+    }
+
+    uint32_t micros() override { return ::micros(); }
+
+    void waitUntil(uint32_t target) override {
+        int32_t remaining;
+        while ((remaining = (int32_t)(target - ::micros())) > 0) {
+            if (remaining > 2000) {
+                delay(1);
+            } else {
+                delayMicroseconds(remaining);
+            }
+        }
+    }
+
+private:
+    File file;
+    uint32_t frequency;
+};
+
+static SdCardBenchIo benchIo;
+
+static const char* getCardTypeName(uint8_t type) {
+    switch (type) {
+    case CARD_MMC: return "MMC";
+    case CARD_SD: return "SDSC";
+    case CARD_SDHC: return "SDHC";
+    default: return "UNKNOWN";
+    }
+}
+
+void runBenchSuite() {
+    unsigned long startMs = millis();
+    char line[SD_BENCH_LINE_SIZE];
+    Serial.println(SD_BENCH_CSV_HEADER);
+
+    for (size_t c = 0; c < sizeof(SD_BENCH_SPI_CLOCKS) / sizeof(SD_BENCH_SPI_CLOCKS[0]); c++) {
+        uint32_t clock = SD_BENCH_SPI_CLOCKS[c];
+        SD.end();
+        if (!SD.begin(SD_CS, SPI, clock)) {
+            // Kartu / wiring tidak stabil di clock ini
+            Serial.printf("#SKIP,esp32,spi_khz=%lu,mount failed\n", (unsigned long)(clock / 1000));
+            continue;
+        }
+        benchIo.setClock(clock);
+        Serial.printf("#CARD,esp32,type=%s,size_mb=%llu,used_mb=%llu,spi_khz=%lu\n",
+                      getCardTypeName(SD.cardType()), SD.cardSize() / (1024 * 1024),
+                      SD.usedBytes() / (1024 * 1024), (unsigned long)(clock / 1000));
+
+        for (size_t r = 0; r < sizeof(SD_BENCH_RECORD_RATES) / sizeof(SD_BENCH_RECORD_RATES[0]); r++) {
+            for (int pattern = 0; pattern < BENCH_PATTERN_COUNT; pattern++) {
+                BenchResult result;
+                uint32_t records = SD_BENCH_RECORD_RATES[r] * SD_BENCH_RUN_SECONDS;
+                if (!runBench(benchIo, (BenchPattern)pattern, SD_BENCH_RECORD_RATES[r], records, result)) {
+                    Serial.printf("#SKIP,esp32,%s,cannot create bench file\n", getBenchPatternName(pattern));
+                    continue;
+                }
+                formatBenchResult(result, benchIo.name(), line, sizeof(line));
+                Serial.println(line);
+            }
+        }
+    }
+
+    Serial.printf("#DONE,esp32,%lu s\n", (millis() - startMs) / 1000);
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println("\n========================================");
+    Serial.println("  💾 SD CARD BENCHMARK");
+    Serial.println("========================================");
+    Serial.printf("  %u clocks x %u rates x %d patterns, %lu s per run\n",
+                  (unsigned)(sizeof(SD_BENCH_SPI_CLOCKS) / sizeof(SD_BENCH_SPI_CLOCKS[0])),
+                  (unsigned)(sizeof(SD_BENCH_RECORD_RATES) / sizeof(SD_BENCH_RECORD_RATES[0])),
+                  BENCH_PATTERN_COUNT, (unsigned long)SD_BENCH_RUN_SECONDS);
+    Serial.println("💡 Commands: RUN (ulangi benchmark)");
+
+    SPI.begin(SD_SCLK, SD_MISO, SD_MOSI, SD_CS);
+    runBenchSuite();
+}
+
+void loop() {
+    if (Serial.available()) {
+        String command = Serial.readStringUntil('\n');
+        command.trim();
+        command.toUpperCase();
+        if (command == "RUN") {
+            runBenchSuite();
+        }
+    }
+    delay(100);
+}
@@ -0,0 +1,38 @@
+// =======================================================
+//   SD BENCHMARK - HOST (env:sdbench-native)
+//   Pola yang sama dengan env:sdbench dijalankan di atas SimBlockDevice.
+//   Tidak butuh hardware; berguna untuk membandingkan pola dan melihat
+//   pengaruh clock SPI / record rate / profil kartu sebelum diukur di device.
+//     pio run -e sdbench-native && .pio/build/sdbench-native/program > bench.csv
+// =======================================================
+
+#include <stdio.h>
+#include "../lib/SdBench/sd_bench.h"
+#include "../lib/SdBench/sim_block_device.h"
+
+static const SimCardProfile* PROFILES[] = {&SIM_CARD_BUDGET, &SIM_CARD_INDUSTRIAL};
+
+int main() {
+    printf("%s\n", SD_BENCH_CSV_HEADER);
+
+    char line[SD_BENCH_LINE_SIZE];
+    for (size_t p = 0; p < sizeof(PROFILES) / sizeof(PROFILES[0]); p++) {
+        for (size_t c = 0; c < sizeof(SD_BENCH_SPI_CLOCKS) / sizeof(SD_BENCH_SPI_CLOCKS[0]); c++) {
+            for (size_t r = 0; r < sizeof(SD_BENCH_RECORD_RATES) / sizeof(SD_BENCH_RECORD_RATES[0]); r++) {
+                for (int pattern = 0; pattern < BENCH_PATTERN_COUNT; pattern++) {
+                    // Kartu baru per run agar GC / isi direktori tidak terbawa
+                    SimBlockDevice device(*PROFILES[p], SD_BENCH_SPI_CLOCKS[c]);
+                    BenchResult result;
+                    uint32_t records = SD_BENCH_RECORD_RATES[r] * SD_BENCH_RUN_SECONDS;
+                    if (!runBench(device, (BenchPattern)pattern, SD_BENCH_RECORD_RATES[r], records, result)) {
+                        fprintf(stderr, "run failed: %s %s\n", device.name(), getBenchPatternName(pattern));
+                        continue;
+                    }
+                    formatBenchResult(result, device.name(), line, sizeof(line));
+                    printf("%s\n", line);
+                }
+            }
+        }
+    }
+    return 0;
+}
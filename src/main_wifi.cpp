@@ -3,10 +3,16 @@
 #include "../lib/VatSensor/sensors.h"
 #include "../lib/indicators/indicators.h"
 #include "../lib/ApiHandler/wifi_api_handler.h"
+#include "../lib/ApiHandler/async_uploader.h"
+#include "../lib/ApiHandler/retry_policy.h"
+#include "../lib/SdUtils/sd_utils.h"
+#include "../lib/Pipeline/task_pipeline.h"
+#include "../lib/Telemetry/telemetry_json.h"
 #include "../include/config.h"
 
 // Forward declarations
-bool sendDataToAPI(float d1, float d2, float lat, float lon, float depth);
+uint32_t submitDataToAPI(const VatSensorData& sample);
+void printUploadResults();
 String getISOTimestamp();
 void setupWiFi();
 void handleWiFiReconnection();
@@ -17,16 +23,25 @@ bool SENSORS_INITIALIZED = false;
 bool WIFI_CONNECTED = false;
 
 // Timing - lebih sering untuk sensor testing
-unsigned long lastApiPost = 0;
 const unsigned long API_POST_INTERVAL = 60000; // 60 detik untuk API (lebih jarang)
 const unsigned long SENSOR_READ_INTERVAL = 1000; // 1 detik untuk sensor (lebih sering)
 
+// Upload HTTP non-blocking - loop dan task network tidak pernah menunggu server
+AsyncUploader uploader(API_URL, "ESP32-VAT-Monitor/1.0");
+bool uploaderReady = false;    // false: begin() gagal (heap kurang) - semua sampel lewat antrean offline
+
+// Drain antrean offline (sampel yang dialihkan saat breaker terbuka) dari task network
+WiFiApiHandler apiHandler(API_URL, DEVICE_ID);
+
+// Backoff + circuit breaker: reconnect WiFi (loop) dan upload API (task network + worker)
+RetryPolicy wifiRetry("wifi", WIFI_RETRY_INTERVAL, WIFI_MAX_RETRIES);
+RetryPolicy uploadRetry("upload", WIFI_UPLOAD_RETRY_MS, WIFI_MAX_RETRIES);
+bool wifiReconnecting = false;
+unsigned long wifiAttemptMs = 0;
+
 // Display timer
 unsigned long displayTimer = 0;
-unsigned long sensorTimer = 0;
-unsigned long wifiCheckTimer = 0;
 int displayCount = 0;
-int sensorReadCount = 0;
 
 // Fungsi untuk membuat ISO timestamp
 String getISOTimestamp() {
@@ -107,77 +122,176 @@ void setupWiFi() {
     }
 }
 
+// Reconnect non-blocking: WiFi.begin() lalu hasilnya dicek di loop berikutnya (maks WIFI_TIMEOUT).
+// Jeda antar percobaan mengikuti wifiRetry (backoff + breaker), bukan interval tetap
 void handleWiFiReconnection() {
-    if (millis() - wifiCheckTimer >= WIFI_RETRY_INTERVAL) {
-        wifiCheckTimer = millis();
-        
-        if (WiFi.status() != WL_CONNECTED && WIFI_CONNECTED) {
-            Serial.println("❌ WiFi disconnected - attempting reconnection...");
-            WIFI_CONNECTED = false;
-        }
-        
+    if (WiFi.status() == WL_CONNECTED) {
         if (!WIFI_CONNECTED) {
-            setupWiFi();
+            WIFI_CONNECTED = true;
+            wifiReconnecting = false;
+            wifiRetry.recordSuccess();
+            Serial.print("✅ WiFi reconnected - IP: ");
+            Serial.println(WiFi.localIP());
+            configTime(TIMEZONE_OFFSET, 0, NTP_SERVER1, NTP_SERVER2);  // Sinkron NTP di background
         }
+        return;
     }
+    
+    if (WIFI_CONNECTED) {
+        Serial.println("❌ WiFi disconnected");
+        WIFI_CONNECTED = false;
+    }
+    
+    if (wifiReconnecting) {
+        if (millis() - wifiAttemptMs < WIFI_TIMEOUT) return;
+        wifiReconnecting = false;
+        wifiRetry.recordFailure();
+    }
+    
+    if (!wifiRetry.canAttempt()) return;
+    
+    Serial.println("📡 Reconnecting WiFi...");
+    WiFi.disconnect();
+    WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+    wifiReconnecting = true;
+    wifiAttemptMs = millis();
 }
 
-bool sendDataToAPI(float d1, float d2, float lat, float lon, float depth) {
+// Encode sampel dan antrekan ke uploader; hasil dicetak oleh printUploadResults() di loop
+uint32_t submitDataToAPI(const VatSensorData& sample) {
     if (WiFi.status() != WL_CONNECTED) {
         Serial.println("❌ WiFi not connected - cannot send data");
-        return false;
+        return 0;
     }
     
     Serial.println("");
     Serial.println("🚀 SENDING DATA TO API");
     Serial.println("========================================");
-    Serial.print("Distance1: "); Serial.print(d1); Serial.println(" cm");
-    Serial.print("Distance2: "); Serial.print(d2); Serial.println(" cm");
-    Serial.print("Latitude: "); Serial.println(lat, 6);
-    Serial.print("Longitude: "); Serial.println(lon, 6);
-    Serial.print("Depth: "); Serial.print(depth); Serial.println(" cm");
+    Serial.print("Distance1: "); Serial.print(sample.distance1); Serial.println(" cm");
+    Serial.print("Distance2: "); Serial.print(sample.distance2); Serial.println(" cm");
+    Serial.print("Latitude: "); Serial.println(sample.latitude, 6);
+    Serial.print("Longitude: "); Serial.println(sample.longitude, 6);
+    Serial.print("Depth: "); Serial.print(sample.depth); Serial.println(" cm");
     Serial.println("========================================");
     
-    // Membuat HTTP request
-    HTTPClient http;
-    http.setTimeout(20000); // 20 second timeout
-    http.begin(API_URL);
-    http.addHeader("Content-Type", "application/json");
-    
-    // Membuat JSON payload dengan format yang PERSIS SAMA
-    String payload = "{\n";
-    payload += "  \"device_id\": \"" + String(DEVICE_ID) + "\",\n";
-    payload += "  \"data\": {\n";
-    payload += "    \"distance1\": " + String(d1, 1) + ",\n";
-    payload += "    \"distance2\": " + String(d2, 1) + ",\n";
-    payload += "    \"latitude\": " + String(lat, 6) + ",\n";
-    payload += "    \"longitude\": " + String(lon, 6) + "\n";
-    payload += "  },\n";
-    payload += "  \"timestamp\": \"" + getISOTimestamp() + "\"\n";
-    payload += "}";
+    // Membuat JSON payload production schema (sama dengan jalur GSM), tanpa String.
+    // Sampel tanpa waktu memakai jam sistem; getISOTimestamp() hanya jika NTP belum sinkron
+    char payload[PRODUCTION_JSON_MAX_SIZE];
+    char fallback[WIB_TIMESTAMP_SIZE];
+    const char* timestamp = NULL;
+    if (!sample.isValid && format_wib_timestamp_now(fallback, sizeof(fallback)) == 0) {
+        strlcpy(fallback, getISOTimestamp().c_str(), sizeof(fallback));
+        timestamp = fallback;
+    }
+    size_t payloadLength = encode_production_json(sample, DEVICE_ID, timestamp, payload, sizeof(payload));
     
     Serial.println("📋 JSON Payload:");
     Serial.println(payload);
     Serial.println("========================================");
     
-    int httpResponseCode = http.POST(payload);
-    
-    if (httpResponseCode > 0) {
-        String response = http.getString();
-        Serial.print("✅ HTTP Response Code: ");
-        Serial.println(httpResponseCode);
-        Serial.print("Response: ");
-        Serial.println(response);
-        http.end();
-        return true;
+    uint32_t id = uploader.submit(payload, payloadLength);
+    if (id == 0) {
+        Serial.println("⏳ Upload slots full - request not queued");
+    } else {
+        Serial.printf("📤 Upload #%lu queued\n", (unsigned long)id);
+    }
+    return id;
+}
+
+// Dipanggil di task worker uploader: status HTTP apa pun berarti link ke server hidup
+void onUploadDone(const UploadResult& result) {
+    if (result.statusCode > 0 && result.statusCode < 500) {
+        uploadRetry.recordSuccess();
     } else {
-        Serial.print("❌ HTTP Error: ");
-        Serial.println(httpResponseCode);
-        http.end();
-        return false;
+        uploadRetry.recordFailure();
+    }
+}
+
+void printUploadResults() {
+    UploadResult result;
+    while (uploader.poll(result)) {
+        if (result.isSuccess()) {
+            Serial.printf("✅ Upload #%lu: HTTP %d in %lu ms (queued %lu ms)\n", (unsigned long)result.id,
+                          result.statusCode, result.elapsedMs, result.queuedMs);
+        } else if (result.statusCode > 0) {
+            Serial.printf("❌ Upload #%lu rejected: HTTP %d\n", (unsigned long)result.id, result.statusCode);
+        } else {
+            Serial.printf("❌ Upload #%lu failed: HTTP error %d after %lu ms\n", (unsigned long)result.id,
+                          result.statusCode, result.elapsedMs);
+        }
+    }
+}
+
+// Task storage: simpan setiap sampel ke log harian, lalu satu langkah retensi & kompresi log
+void storeSample(const VatSensorData& sample) {
+    if (isSdCardOk) {
+        writeToDailyLog(sample);
+        cleanupOldLogs();
+        compressClosedLogs(sample);
     }
 }
 
+// Breaker terbuka: sampel langsung ke antrean offline, dikirim apiHandler.syncOfflineData() setelah pulih
+void queueSamplesOffline(const VatSensorData* samples, size_t count) {
+    char json[PRODUCTION_JSON_MAX_SIZE];
+    for (size_t i = 0; i < count; i++) {
+        if (encode_production_json(samples[i], DEVICE_ID, NULL, json, sizeof(json)) > 0) {
+            addToOfflineQueue(json);
+        }
+    }
+}
+
+// Task network: antrekan sampel terbaru ke uploader (tidak menunggu respon server)
+size_t uploadSamples(const VatSensorData* samples, size_t count) {
+    bool linkUp = WiFi.status() == WL_CONNECTED;
+    if (!uploaderReady) {
+        // Tanpa worker: sampel ke antrean offline, dikirim drain (satu sesi TLS) saat link sehat
+        if (!isSdCardOk) return 0;
+        queueSamplesOffline(samples, count);
+        if (linkUp && uploadRetry.canAttempt()) {
+            if (apiHandler.syncOfflineData()) {
+                uploadRetry.recordSuccess();
+            } else {
+                uploadRetry.recordFailure();
+            }
+            apiHandler.closeConnection();
+        }
+        return count;
+    }
+    
+    if (!linkUp || !uploadRetry.canAttempt()) {
+        if ((wifiRetry.isOpen() || uploadRetry.isOpen()) && isSdCardOk) {
+            // Link dianggap mati - tidak ada request sampai waktu probe
+            queueSamplesOffline(samples, count);
+            Serial.printf("📥 %s breaker open - %u samples queued offline\n",
+                          wifiRetry.isOpen() ? "WiFi" : "Upload", (unsigned)count);
+            return count;
+        }
+        return 0;  // Menunggu reconnect / backoff - sampel tetap di ring
+    }
+    
+    // Link sehat - kirim dulu antrean offline (blocking di task network, maks WIFI_DRAIN_MAX_MS).
+    // Socket worker uploader ditutup selama drain agar hanya satu sesi TLS di heap
+    if (uploadRetry.getState() == RETRY_CLOSED && isSdCardOk && isOfflineQueueNotEmpty()) {
+        uploader.pause();
+        apiHandler.syncOfflineData();
+        apiHandler.closeConnection();  // Lepas RAM sesi TLS sebelum worker connect lagi
+        uploader.resume();
+    }
+    
+    // Slot penuh (server lambat) atau WiFi baru putus - sampel tetap di ring untuk siklus
+    // berikutnya. Bukan kegagalan: tidak ada request yang keluar, jadi izin dikembalikan
+    // (probe HALF_OPEN tidak menggantung); breaker hanya diperbarui oleh onUploadDone
+    const VatSensorData& latest = samples[count - 1];
+    if (submitDataToAPI(latest) == 0) {
+        uploadRetry.cancelAttempt();
+        return 0;
+    }
+    
+    // Sampel yang lebih lama sudah tersimpan di log harian
+    return count;
+}
+
 void setup() {
     Serial.begin(115200);
     delay(3000);
@@ -193,8 +307,15 @@ void setup() {
     Serial.println(" MHz");
     Serial.println("========================================");
     
-    // WiFi Connection
+    // WiFi Connection (blocking hanya saat boot, reconnect berikutnya non-blocking)
     setupWiFi();
+    if (!WIFI_CONNECTED) {
+        wifiRetry.recordFailure();
+    }
+    uploaderReady = uploader.begin(onUploadDone);
+    if (!uploaderReady) {
+        Serial.println("⚠️ Async uploader not running - samples go through the offline queue");
+    }
     
     // Real sensor initialization
     if (USE_REAL_SENSORS) {
@@ -234,6 +355,18 @@ void setup() {
             // Setup LED indicators
             setup_leds();
             Serial.println("✅ LED indicators ready!");
+            
+            // SD Card untuk log harian
+            initSdCard();
+            
+            // Akuisisi, storage dan upload berjalan di task terpisah
+            PipelineConfig pipeline;
+            pipeline.sampleIntervalMs = SENSOR_READ_INTERVAL;
+            pipeline.uploadIntervalMs = API_POST_INTERVAL;
+            pipeline.onSample = NULL;
+            pipeline.store = storeSample;
+            pipeline.upload = uploadSamples;
+            start_task_pipeline(pipeline);
         } else {
             SENSORS_INITIALIZED = false;
             Serial.println("❌ SENSOR INITIALIZATION FAILED - using dummy data");
@@ -242,7 +375,7 @@ void setup() {
     
     Serial.println("========================================");
     Serial.println("✅ Setup completed!");
-    Serial.println("💡 Commands: SENSOR, DUMMY, WIFI, TIME, TEST, LED, API");
+    Serial.println("💡 Commands: SENSOR, DUMMY, WIFI, TIME, TEST, LED, API, PIPELINE, STATS, EXPORTLOG, EXPORTALL");
     Serial.println("========================================");
 }
 
@@ -250,6 +383,9 @@ void loop() {
     // Handle WiFi reconnection
     handleWiFiReconnection();
     
+    // Hasil upload dari task worker
+    printUploadResults();
+    
     // Handle serial commands
     if (Serial.available()) {
         String command = Serial.readString();
@@ -267,36 +403,50 @@ void loop() {
                 Serial.print(WiFi.RSSI());
                 Serial.println(" dBm");
             }
+        } else if (command == "PIPELINE") {
+            print_pipeline_stats();
+        } else if (command == "STATS") {
+            // Info kartu + clock SPI; counter antrean dari metadata (tanpa scan file)
+            printSdCardStats();
+            print_pipeline_stats();
+            uploader.printStats();
+            wifiRetry.printStats();
+            uploadRetry.printStats();
+        } else if (command == "EXPORTLOG") {
+            // Log biner hari ini (tanggal UTC sampel terakhir) -> CSV di SD Card
+            VatSensorData sample;
+            if (get_latest_sample(sample) && sample.isValid) {
+                exportDailyLogToCsv(sample.year, sample.month, sample.day);
+            } else {
+                Serial.println("⏳ No GPS date yet - cannot pick daily log");
+            }
+        } else if (command == "EXPORTALL") {
+            // Semua log harian -> satu CSV di SD Card (blocking, progress per hari)
+            exportAllData();
         } else if (command == "API") {
             Serial.println("\n🧪 API TEST:");
             if (WiFi.status() == WL_CONNECTED) {
-                float test_d1 = SENSORS_INITIALIZED ? distance1 : 23.5;
-                float test_d2 = SENSORS_INITIALIZED ? distance2 : 32.1;
-                float test_lat = SENSORS_INITIALIZED && gps.location.isValid() ? gps.location.lat() : -6.175392;
-                float test_lon = SENSORS_INITIALIZED && gps.location.isValid() ? gps.location.lng() : 106.827153;
-                float test_depth = SENSORS_INITIALIZED ? calculate_depth() : (2.84 * test_d2 - 16.6);
+                // Sampel terakhir dari task akuisisi, atau data dummy jika sensor belum jalan
+                VatSensorData test = {0};
+                if (!SENSORS_INITIALIZED || !get_latest_sample(test)) {
+                    test.distance1 = 23.5;
+                    test.distance2 = 32.1;
+                    test.depth = 2.84 * test.distance2 - 16.6;
+                }
+                if (test.latitude == 0 && test.longitude == 0) {
+                    test.latitude = -6.175392;
+                    test.longitude = 106.827153;
+                }
+                test.isValid = false;  // Timestamp = waktu saat ini
                 
-                bool apiSuccess = sendDataToAPI(test_d1, test_d2, test_lat, test_lon, test_depth);
-                Serial.println(apiSuccess ? "✅ API test successful!" : "❌ API test failed!");
+                // Hasil muncul di log "Upload #N" setelah server menjawab
+                submitDataToAPI(test);
             } else {
                 Serial.println("❌ WiFi not connected - cannot test API");
             }
         }
     }
     
-    // Read sensors
-    if (SENSORS_INITIALIZED && millis() - sensorTimer >= SENSOR_READ_INTERVAL) {
-        sensorTimer = millis();
-        sensorReadCount++;
-        
-        try {
-            read_ultrasonic_sensors();
-            read_gps_data();
-        } catch (...) {
-            Serial.println("⚠️ Error reading sensors");
-        }
-    }
-    
     // Display data and send to API
     if (millis() - displayTimer >= 5000) {
         displayTimer = millis();
@@ -308,47 +458,37 @@ void loop() {
         Serial.println(displayCount);
         Serial.println("========================================");
         
-        if (SENSORS_INITIALIZED) {
-            // Real sensor data
+        VatSensorData sample;
+        if (SENSORS_INITIALIZED && get_latest_sample(sample)) {
+            // Real sensor data - salinan dari task akuisisi (global sensor hanya milik task itu)
             Serial.println("📏 REAL SENSOR DATA:");
             Serial.print("  Distance 1: ");
-            Serial.print(distance1);
+            Serial.print(sample.distance1);
             Serial.println(" cm");
             Serial.print("  Distance 2: ");
-            Serial.print(distance2);
+            Serial.print(sample.distance2);
             Serial.println(" cm");
             
-            float depth = calculate_depth();
             Serial.print("🌊 Calculated Depth: ");
-            Serial.print(depth);
+            Serial.print(sample.depth);
             Serial.println(" cm");
             
-            update_leds(distance1, distance2);
+            // LED hanya dikendalikan dari loop
+            update_leds(sample.distance1, sample.distance2);
             
-            // GPS Data
+            // GPS Data (posisi terakhir yang valid; 0,0 = belum pernah fix)
             Serial.println("🛰️ GPS MODULE:");
-            if (gps.location.isValid()) {
+            if (sample.latitude != 0 || sample.longitude != 0) {
                 Serial.print("  Status: FIXED ✅ (");
-                Serial.print(gps.satellites.value());
+                Serial.print(sample.satellites);
                 Serial.println(" satellites)");
                 Serial.print("  Latitude: ");
-                Serial.println(gps.location.lat(), 6);
+                Serial.println(sample.latitude, 6);
                 Serial.print("  Longitude: ");
-                Serial.println(gps.location.lng(), 6);
+                Serial.println(sample.longitude, 6);
             } else {
                 Serial.println("  Status: SEARCHING... ⏳");
             }
-            
-            // Send to API
-            if (WiFi.status() == WL_CONNECTED && millis() - lastApiPost >= API_POST_INTERVAL) {
-                lastApiPost = millis();
-                
-                float lat = gps.location.isValid() ? gps.location.lat() : 0.0;
-                float lon = gps.location.isValid() ? gps.location.lng() : 0.0;
-                
-                bool apiSuccess = sendDataToAPI(distance1, distance2, lat, lon, depth);
-                Serial.println(apiSuccess ? "✅ DATA POSTED SUCCESSFULLY" : "❌ API POST FAILED");
-            }
         } else {
             // Dummy data
             Serial.println("🎭 DUMMY DATA (Sensor Failed):");
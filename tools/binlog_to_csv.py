@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+"""
+Ubah log harian biner (/vatlog_YYYY-MM-DD.bin) dari SD Card menjadi CSV.
+
+Format file (lihat lib/SdUtils/binary_log.h): deretan blok 512 byte
+    header  : 'V' 'L' <versi=1> <jumlah record> <uint32 nomor blok>
+    record  : 17 x 28 byte, little-endian
+              uint32 timestamp UTC, int32 lat x 1e7, int32 lon x 1e7, uint32 uptime ms,
+              int16 dist1 mm, int16 dist2 mm, int16 depth mm, uint16 hdop x 100,
+              uint8 satelit, uint8 flags, uint16 reserved
+    offset 508: CRC-32 (zlib) dari byte 0..507
+
+Blok dengan CRC salah dilewati dan dilaporkan ke stderr.
+
+Pemakaian:
+    python3 tools/binlog_to_csv.py vatlog_2025-01-15.bin > vatlog_2025-01-15.csv
+    python3 tools/binlog_to_csv.py --device-id BJK0001 vatlog_2025-01-15.bin -o out.csv
+"""
+
+import argparse
+import csv
+import struct
+import sys
+import zlib
+from datetime import datetime, timedelta, timezone
+
+BLOCK_SIZE = 512
+CRC_OFFSET = BLOCK_SIZE - 4
+VERSION = 1
+HEADER = struct.Struct("<2sBBI")
+RECORD = struct.Struct("<IiiIhhhHBBH")
+RECORDS_PER_BLOCK = (CRC_OFFSET - HEADER.size) // RECORD.size
+WIB = timezone(timedelta(hours=7))
+MISSING_COORD = -2147483648
+MISSING_MM = -32768
+
+COLUMNS = ["timestamp_wib", "device_id", "distance1", "distance2", "latitude", "longitude",
+           "depth", "satellites", "hdop", "uptime_ms"]
+
+
+def read_blocks(data):
+    """Yield (nomor blok, list record) untuk setiap blok valid; cetak blok rusak ke stderr."""
+    for offset in range(0, len(data) - BLOCK_SIZE + 1, BLOCK_SIZE):
+        block = data[offset:offset + BLOCK_SIZE]
+        magic, version, count, sequence = HEADER.unpack_from(block)
+        stored_crc = struct.unpack_from("<I", block, CRC_OFFSET)[0]
+
+        if magic != b"VL" or version != VERSION or not 0 < count <= RECORDS_PER_BLOCK:
+            print("⚠️  blok %d: header tidak valid" % (offset // BLOCK_SIZE), file=sys.stderr)
+            continue
+        if zlib.crc32(block[:CRC_OFFSET]) != stored_crc:
+            print("⚠️  blok %d: CRC salah" % (offset // BLOCK_SIZE), file=sys.stderr)
+            continue
+
+        records = [RECORD.unpack_from(block, HEADER.size + i * RECORD.size) for i in range(count)]
+        yield sequence, records
+
+    if len(data) % BLOCK_SIZE:
+        print("⚠️  %d byte sisa di akhir file diabaikan" % (len(data) % BLOCK_SIZE), file=sys.stderr)
+
+
+def format_row(device_id, record):
+    timestamp, lat, lon, uptime, dist1, dist2, depth, hdop, satellites, _flags, _ = record
+
+    def mm_to_cm(value):
+        return "" if value == MISSING_MM else "%.1f" % (value / 10.0)
+
+    def coord(value):
+        return "" if value == MISSING_COORD else "%.7f" % (value / 1e7)
+
+    return [
+        datetime.fromtimestamp(timestamp, WIB).strftime("%Y-%m-%dT%H:%M:%S+07:00") if timestamp else "",
+        device_id,
+        mm_to_cm(dist1),
+        mm_to_cm(dist2),
+        coord(lat),
+        coord(lon),
+        "" if depth == MISSING_MM else "%.2f" % (depth / 10.0),
+        satellites,
+        "" if hdop == 0xFFFF else "%.2f" % (hdop / 100.0),
+        uptime,
+    ]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Export log biner VAT Subsoil Monitor ke CSV")
+    parser.add_argument("input", help="file .bin dari SD Card")
+    parser.add_argument("-o", "--output", help="file CSV tujuan (default stdout)")
+    parser.add_argument("--device-id", default="BJK0001", help="isi kolom device_id")
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as handle:
+        data = handle.read()
+
+    output = open(args.output, "w", newline="") if args.output else sys.stdout
+    writer = csv.writer(output, lineterminator="\n")
+    writer.writerow(COLUMNS)
+
+    rows = 0
+    for _sequence, records in read_blocks(data):
+        for record in records:
+            writer.writerow(format_row(args.device_id, record))
+            rows += 1
+
+    if args.output:
+        output.close()
+    print("✅ %d record diexport" % rows, file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
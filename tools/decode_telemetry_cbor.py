@@ -0,0 +1,203 @@
+#!/usr/bin/env python3
+"""
+Decode & validasi body batch CBOR dari firmware VAT Subsoil Monitor.
+
+Format (lihat docs/API.md, "Binary Batch Request"):
+    {0: versi, 1: deviceId, 2: [ {0: ts, 1: lat, 2: lon, 3: alt, 4: dist1, 5: dist2}, ... ]}
+
+Nilai sampel berupa integer fixed-point:
+    ts          detik Unix UTC (null = waktu tidak diketahui)
+    lat, lon    derajat x 1e7
+    alt         depth x 100
+    dist1/2     jarak x 100
+
+Output: JSON array dalam schema production API (sama dengan body JSON batch).
+
+Pemakaian:
+    python3 tools/decode_telemetry_cbor.py body.cbor
+    curl ... | python3 tools/decode_telemetry_cbor.py -
+    python3 tools/decode_telemetry_cbor.py --validate body.cbor
+
+Tidak butuh library tambahan (decoder CBOR subset ada di file ini).
+"""
+
+import argparse
+import json
+import struct
+import sys
+from datetime import datetime, timedelta, timezone
+
+SUPPORTED_VERSION = 1
+WIB = timezone(timedelta(hours=7))
+
+KEY_VERSION, KEY_DEVICE_ID, KEY_SAMPLES = 0, 1, 2
+KEY_TS, KEY_LAT, KEY_LON, KEY_ALT, KEY_DIST1, KEY_DIST2 = range(6)
+SAMPLE_KEYS = {KEY_TS, KEY_LAT, KEY_LON, KEY_ALT, KEY_DIST1, KEY_DIST2}
+
+_BREAK = object()
+
+
+class CborError(ValueError):
+    pass
+
+
+class CborReader:
+    """Decoder CBOR minimal: uint, negint, text, array, map, null, break."""
+
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def _take(self, count):
+        if self.pos + count > len(self.data):
+            raise CborError("body terpotong di offset %d" % self.pos)
+        chunk = self.data[self.pos:self.pos + count]
+        self.pos += count
+        return chunk
+
+    def _argument(self, info):
+        if info < 24:
+            return info
+        if info == 24:
+            return self._take(1)[0]
+        if info == 25:
+            return struct.unpack(">H", self._take(2))[0]
+        if info == 26:
+            return struct.unpack(">I", self._take(4))[0]
+        if info == 27:
+            return struct.unpack(">Q", self._take(8))[0]
+        raise CborError("argument tidak didukung (info %d) di offset %d" % (info, self.pos - 1))
+
+    def read(self):
+        initial = self._take(1)[0]
+        major, info = initial >> 5, initial & 0x1F
+
+        if initial == 0xF6:
+            return None
+        if initial == 0xFF:
+            return _BREAK
+        if major == 0:
+            return self._argument(info)
+        if major == 1:
+            return -1 - self._argument(info)
+        if major == 3:
+            return self._take(self._argument(info)).decode("utf-8")
+        if major == 4:
+            if info == 31:
+                items = []
+                while True:
+                    item = self.read()
+                    if item is _BREAK:
+                        return items
+                    items.append(item)
+            return [self.read() for _ in range(self._argument(info))]
+        if major == 5:
+            result = {}
+            for _ in range(self._argument(info)):
+                key = self.read()
+                result[key] = self.read()
+            return result
+        raise CborError("tipe CBOR 0x%02x tidak didukung di offset %d" % (initial, self.pos - 1))
+
+
+def _scaled(value, scale):
+    return None if value is None else value / scale
+
+
+def decode_batch(data):
+    """Decode body CBOR, kembalikan (device_id, list sampel schema production, list error)."""
+    reader = CborReader(data)
+    root = reader.read()
+    errors = []
+
+    if reader.pos != len(data):
+        errors.append("ada %d byte sisa setelah item utama" % (len(data) - reader.pos))
+    if not isinstance(root, dict):
+        raise CborError("item utama harus map")
+
+    version = root.get(KEY_VERSION)
+    if version != SUPPORTED_VERSION:
+        errors.append("versi %r tidak dikenal (didukung: %d)" % (version, SUPPORTED_VERSION))
+
+    device_id = root.get(KEY_DEVICE_ID)
+    if not isinstance(device_id, str) or not device_id:
+        errors.append("deviceId kosong atau bukan text")
+
+    raw_samples = root.get(KEY_SAMPLES)
+    if not isinstance(raw_samples, list):
+        raise CborError("key 2 (samples) harus array")
+
+    samples = []
+    for index, raw in enumerate(raw_samples):
+        if not isinstance(raw, dict):
+            errors.append("sampel %d bukan map" % index)
+            continue
+        if set(raw.keys()) != SAMPLE_KEYS:
+            errors.append("sampel %d: key %s" % (index, sorted(raw.keys())))
+
+        lat = _scaled(raw.get(KEY_LAT), 1e7)
+        lon = _scaled(raw.get(KEY_LON), 1e7)
+        if lat is not None and not -90 <= lat <= 90:
+            errors.append("sampel %d: lat %.7f di luar jangkauan" % (index, lat))
+        if lon is not None and not -180 <= lon <= 180:
+            errors.append("sampel %d: lon %.7f di luar jangkauan" % (index, lon))
+
+        ts = raw.get(KEY_TS)
+        timestamp = None
+        if ts is not None:
+            timestamp = datetime.fromtimestamp(ts, WIB).strftime("%Y-%m-%dT%H:%M:%S+07:00")
+
+        samples.append({
+            "type": "sensor",
+            "deviceId": device_id,
+            "gps": {
+                "lat": lat,
+                "lon": lon,
+                "alt": _scaled(raw.get(KEY_ALT), 100),
+                "sog": 0,
+                "cog": 0,
+            },
+            "ultrasonic": {
+                "dist1": _scaled(raw.get(KEY_DIST1), 100),
+                "dist2": _scaled(raw.get(KEY_DIST2), 100),
+            },
+            "timestamp": timestamp,
+        })
+
+    return device_id, samples, errors
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode batch CBOR VAT Subsoil Monitor")
+    parser.add_argument("input", help="file body CBOR, atau - untuk stdin")
+    parser.add_argument("--validate", action="store_true",
+                        help="hanya validasi, cetak ringkasan (exit 1 jika ada error)")
+    args = parser.parse_args()
+
+    if args.input == "-":
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.input, "rb") as handle:
+            data = handle.read()
+
+    try:
+        device_id, samples, errors = decode_batch(data)
+    except CborError as exc:
+        print("❌ CBOR tidak valid: %s" % exc, file=sys.stderr)
+        return 1
+
+    for error in errors:
+        print("⚠️  %s" % error, file=sys.stderr)
+
+    if args.validate:
+        print("deviceId=%s samples=%d bytes=%d (%.1f byte/sampel)" % (
+            device_id, len(samples), len(data), len(data) / max(len(samples), 1)))
+    else:
+        json.dump(samples, sys.stdout, indent=2)
+        print()
+
+    return 1 if errors else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
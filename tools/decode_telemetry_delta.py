@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+"""
+Decode & validasi frame batch delta (application/vnd.vatsubsoil.delta) dari firmware.
+
+Layout (lihat docs/API.md, "Delta Batch Request"):
+    'V' 'D' <versi=1>
+    varint panjang deviceId, deviceId (UTF-8)
+    varint jumlah sampel N
+    6 kolom x N zigzag varint, tiap nilai = selisih dengan sampel sebelumnya
+    (sampel pertama: selisih dengan 0), urutan kolom:
+        timestamp   detik Unix UTC (0 = tidak diketahui)
+        lat, lon    derajat x 1e7 (-2147483648 = tidak tersedia)
+        depth       milimeter      (-32768 = tidak tersedia)
+        dist1/dist2 milimeter      (-32768 = tidak tersedia)
+
+Output: JSON array dalam schema production API (jarak dalam cm seperti body JSON).
+
+Pemakaian:
+    python3 tools/decode_telemetry_delta.py body.bin
+    python3 tools/decode_telemetry_delta.py --validate body.bin   # ukuran & rasio vs JSON
+"""
+
+import argparse
+import json
+import sys
+from datetime import datetime, timedelta, timezone
+
+VERSION = 1
+WIB = timezone(timedelta(hours=7))
+MISSING_COORD = -2147483648
+MISSING_MM = -32768
+COLUMNS = ("timestamp", "lat", "lon", "depth", "dist1", "dist2")
+
+
+class DeltaError(ValueError):
+    pass
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def byte(self):
+        if self.pos >= len(self.data):
+            raise DeltaError("frame terpotong di offset %d" % self.pos)
+        value = self.data[self.pos]
+        self.pos += 1
+        return value
+
+    def varint(self):
+        result = 0
+        shift = 0
+        while True:
+            value = self.byte()
+            result |= (value & 0x7F) << shift
+            if value < 0x80:
+                return result
+            shift += 7
+            if shift > 63:
+                raise DeltaError("varint terlalu panjang di offset %d" % self.pos)
+
+    def zigzag(self):
+        value = self.varint()
+        return (value >> 1) ^ -(value & 1)
+
+
+def decode_frame(data):
+    """Kembalikan (device_id, list dict kolom fixed-point)."""
+    reader = Reader(data)
+    if reader.byte() != ord("V") or reader.byte() != ord("D"):
+        raise DeltaError("magic bukan 'VD'")
+    version = reader.byte()
+    if version != VERSION:
+        raise DeltaError("versi %d tidak dikenal" % version)
+
+    id_length = reader.varint()
+    device_id = bytes(reader.byte() for _ in range(id_length)).decode("utf-8")
+    count = reader.varint()
+
+    columns = {}
+    for name in COLUMNS:
+        values = []
+        last = 0
+        for _ in range(count):
+            last += reader.zigzag()
+            values.append(last)
+        columns[name] = values
+
+    if reader.pos != len(data):
+        raise DeltaError("ada %d byte sisa setelah kolom terakhir" % (len(data) - reader.pos))
+
+    rows = [{name: columns[name][i] for name in COLUMNS} for i in range(count)]
+    return device_id, rows
+
+
+def to_production(device_id, row):
+    def coord(value):
+        return None if value == MISSING_COORD else value / 1e7
+
+    def cm(value):
+        return None if value == MISSING_MM else value / 10.0
+
+    timestamp = None
+    if row["timestamp"] != 0:
+        timestamp = datetime.fromtimestamp(row["timestamp"], WIB).strftime("%Y-%m-%dT%H:%M:%S+07:00")
+
+    return {
+        "type": "sensor",
+        "deviceId": device_id,
+        "gps": {"lat": coord(row["lat"]), "lon": coord(row["lon"]), "alt": cm(row["depth"]),
+                "sog": 0, "cog": 0},
+        "ultrasonic": {"dist1": cm(row["dist1"]), "dist2": cm(row["dist2"])},
+        "timestamp": timestamp,
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode batch delta VAT Subsoil Monitor")
+    parser.add_argument("input", help="file frame delta, atau - untuk stdin")
+    parser.add_argument("--validate", action="store_true",
+                        help="cetak ringkasan ukuran & rasio terhadap JSON (exit 1 jika tidak valid)")
+    args = parser.parse_args()
+
+    if args.input == "-":
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.input, "rb") as handle:
+            data = handle.read()
+
+    try:
+        device_id, rows = decode_frame(data)
+    except DeltaError as exc:
+        print("❌ Frame tidak valid: %s" % exc, file=sys.stderr)
+        return 1
+
+    samples = [to_production(device_id, row) for row in rows]
+    if args.validate:
+        json_size = len(json.dumps(samples, separators=(",", ":")))
+        print("deviceId=%s samples=%d bytes=%d (%.1f byte/sampel), JSON=%d bytes, rasio %.1fx" % (
+            device_id, len(samples), len(data), len(data) / max(len(samples), 1),
+            json_size, json_size / max(len(data), 1)))
+    else:
+        json.dump(samples, sys.stdout, indent=2)
+        print()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,80 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// =======================================================
+//   ARDUINO API - HOST (env:*-native)
+//   Bagian kecil Arduino core yang dipakai lib/SdUtils: Serial, String,
+//   millis()/delay(). Cukup untuk menjalankan kode SD Card di atas SimFs;
+//   bukan emulasi lengkap.
+// =======================================================
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include "host_clock.h"
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void yield();
+
+class String {
+public:
+    String() {}
+    String(const char* text) : value(text ? text : "") {}
+    String(const std::string& text) : value(text) {}
+    explicit String(int number) : value(std::to_string(number)) {}
+    explicit String(unsigned long number) : value(std::to_string(number)) {}
+    String(double number, unsigned int decimals);
+
+    const char* c_str() const { return value.c_str(); }
+    unsigned int length() const { return value.size(); }
+    void reserve(unsigned int size) { value.reserve(size); }
+    long toInt() const { return strtol(value.c_str(), NULL, 10); }
+    int indexOf(const char* text) const;
+
+    String& operator+=(const String& other) { value += other.value; return *this; }
+    String& operator+=(const char* other) { value += other; return *this; }
+    String& operator+=(char other) { value += other; return *this; }
+    bool operator==(const char* other) const { return value == other; }
+    friend String operator+(const String& a, const String& b) { return String(a.value + b.value); }
+    friend String operator+(const String& a, const char* b) { return String(a.value + b); }
+    friend String operator+(const char* a, const String& b) { return String(a + b.value); }
+
+private:
+    std::string value;
+};
+
+// Serial ke stdout; host_serial_enable(false) membungkam log firmware selama test
+class HostSerial {
+public:
+    HostSerial() : enabled(true) {}
+    void setEnabled(bool on) { enabled = on; }
+
+    size_t print(const char* text);
+    size_t print(const String& text) { return print(text.c_str()); }
+    size_t print(char c);
+    size_t print(long number);
+    size_t print(unsigned long number);
+    size_t print(int number) { return print((long)number); }
+    size_t print(unsigned int number) { return print((unsigned long)number); }
+    size_t print(long long number);
+    size_t print(unsigned long long number);
+    size_t print(double number, int decimals = 2);
+    template <typename T>
+    size_t println(const T& value) { size_t n = print(value); return n + print("\n"); }
+    size_t println(double number, int decimals) { size_t n = print(number, decimals); return n + print("\n"); }
+    size_t println() { return print("\n"); }
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+private:
+    bool enabled;
+};
+
+extern HostSerial Serial;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,55 @@
+#ifndef HOST_FS_H
+#define HOST_FS_H
+
+// =======================================================
+//   FS / File - HOST (env:*-native)
+//   File di atas SimFs (sim_fs.h) dengan API yang dipakai lib/SdUtils.
+//   Mode sama dengan core ESP32: "r", "w" (dikosongkan saat open), "a", "r+".
+// =======================================================
+
+#include <stddef.h>
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Arduino.h"
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+struct SimOpenFile;
+
+class File {
+public:
+    File() {}
+    explicit File(std::shared_ptr<SimOpenFile> state) : state(state) {}
+
+    operator bool() const { return (bool)state; }
+    void close() { state.reset(); }
+
+    size_t read(uint8_t* buffer, size_t size);
+    int read();
+    int peek();
+    size_t write(const uint8_t* data, size_t size);
+    size_t write(uint8_t value) { return write(&value, 1); }
+    size_t print(const char* text) { return write((const uint8_t*)text, strlen(text)); }
+    size_t print(const String& text) { return print(text.c_str()); }
+    size_t println(const char* text) { return print(text) + print("\r\n"); }
+    size_t println(const String& text) { return println(text.c_str()); }
+    bool seek(uint32_t position);
+    size_t position() const;
+    size_t size() const;
+    int available();
+    void flush() {}
+    String readString();
+
+    const char* name() const;
+    bool isDirectory() const;
+    File openNextFile();
+
+private:
+    std::shared_ptr<SimOpenFile> state;
+};
+
+#endif // HOST_FS_H
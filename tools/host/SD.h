@@ -0,0 +1,26 @@
+#ifndef HOST_SD_H
+#define HOST_SD_H
+
+// SD library - host (env:*-native): semua operasi diteruskan ke SimFs global
+#include "FS.h"
+#include "SPI.h"
+
+class SDClass {
+public:
+    bool begin(uint8_t ssPin = 5, SPIClass& spi = SPI, uint32_t frequency = 4000000,
+               const char* mountpoint = "/sd", uint8_t maxFiles = 5);
+    void end() {}
+    File open(const char* path, const char* mode = FILE_READ);
+    bool exists(const char* path);
+    bool mkdir(const char* path);
+    bool remove(const char* path);
+    bool rename(const char* from, const char* to);
+    bool rmdir(const char* path) { return remove(path); }
+    uint64_t cardSize();
+    uint64_t totalBytes();
+    uint64_t usedBytes();
+};
+
+extern SDClass SD;
+
+#endif // HOST_SD_H
@@ -0,0 +1,13 @@
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+// FreeRTOS - host (env:*-native): test berjalan di satu thread, mutex tidak berbuat apa-apa
+#include <stdint.h>
+
+typedef void* SemaphoreHandle_t;
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+#define portMAX_DELAY 0xFFFFFFFFUL
+#define pdTRUE 1
+
+#endif // HOST_FREERTOS_H
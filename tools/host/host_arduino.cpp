@@ -0,0 +1,104 @@
+#include "Arduino.h"
+#include <stdarg.h>
+
+HostSerial Serial;
+
+static unsigned long hostMillis = 0;
+static time_t hostEpoch = 0;    // 0 = jam sistem belum disinkronkan
+static unsigned long hostEpochSetMs = 0;
+
+// =======================================================
+//   CLOCK
+// =======================================================
+
+time_t host_time(time_t* out) {
+    time_t now = hostEpoch != 0 ? hostEpoch + (time_t)((hostMillis - hostEpochSetMs) / 1000) : 0;
+    if (out) *out = now;
+    return now;
+}
+
+void host_set_time(time_t utcSeconds) {
+    hostEpoch = utcSeconds;
+    hostEpochSetMs = hostMillis;
+}
+
+void host_advance_ms(unsigned long ms) {
+    hostMillis += ms;
+}
+
+unsigned long millis() {
+    return hostMillis;
+}
+
+unsigned long micros() {
+    return hostMillis * 1000;
+}
+
+void delay(unsigned long ms) {
+    host_advance_ms(ms);
+}
+
+void yield() {
+}
+
+// =======================================================
+//   STRING
+// =======================================================
+
+String::String(double number, unsigned int decimals) {
+    char text[48];
+    snprintf(text, sizeof(text), "%.*f", decimals, number);
+    value = text;
+}
+
+int String::indexOf(const char* text) const {
+    size_t position = value.find(text);
+    return position == std::string::npos ? -1 : (int)position;
+}
+
+// =======================================================
+//   SERIAL
+// =======================================================
+
+size_t HostSerial::print(const char* text) {
+    if (!enabled) return strlen(text);
+    return fputs(text, stdout) >= 0 ? strlen(text) : 0;
+}
+
+size_t HostSerial::print(char c) {
+    char text[2] = {c, '\0'};
+    return print(text);
+}
+
+size_t HostSerial::print(long number) {
+    return print(std::to_string(number).c_str());
+}
+
+size_t HostSerial::print(unsigned long number) {
+    return print(std::to_string(number).c_str());
+}
+
+size_t HostSerial::print(long long number) {
+    return print(std::to_string(number).c_str());
+}
+
+size_t HostSerial::print(unsigned long long number) {
+    return print(std::to_string(number).c_str());
+}
+
+size_t HostSerial::print(double number, int decimals) {
+    char text[48];
+    snprintf(text, sizeof(text), "%.*f", decimals, number);
+    return print(text);
+}
+
+size_t HostSerial::printf(const char* format, ...) {
+    char text[512];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    if (length < 0) return 0;
+    print(text);
+    return length;
+}
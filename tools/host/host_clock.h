@@ -0,0 +1,27 @@
+#ifndef HOST_CLOCK_H
+#define HOST_CLOCK_H
+
+// =======================================================
+//   HOST CLOCK (env:*-native)
+//   millis() dan jam sistem time() yang dikendalikan test. Header ini
+//   di-include paksa (-include host_clock.h) agar time() di kode firmware
+//   yang meng-include <time.h> lebih dulu ikut diarahkan ke host_time().
+// =======================================================
+
+#include <time.h>
+#include <stdint.h>
+
+time_t host_time(time_t* out);
+#define time(out) host_time(out)
+
+/**
+ * @brief Atur jam sistem simulasi (detik Unix); 0 = jam belum disinkronkan
+ */
+void host_set_time(time_t utcSeconds);
+
+/**
+ * @brief Majukan millis() (dan jam sistem jika sudah diatur)
+ */
+void host_advance_ms(unsigned long ms);
+
+#endif // HOST_CLOCK_H
@@ -0,0 +1,303 @@
+#include "sim_fs.h"
+#include <string.h>
+#include "SD.h"
+
+SimFs simFs;
+SDClass SD;
+SPIClass SPI;
+
+SimFs::SimFs() {
+    format();
+}
+
+void SimFs::format(uint64_t capacityBytes) {
+    nodes.clear();
+    nextCreated = 0;
+    add("/", true);
+    capacity = capacityBytes;
+    unitsUsed = 0;
+    cutAt = SIM_FS_NO_CUT;
+    powerLost = false;
+}
+
+void SimFs::cutPowerAfter(uint32_t units) {
+    cutAt = units == SIM_FS_NO_CUT ? SIM_FS_NO_CUT : unitsUsed + units;
+    powerLost = false;
+}
+
+void SimFs::powerOn() {
+    cutAt = SIM_FS_NO_CUT;
+    powerLost = false;
+}
+
+bool SimFs::spend(uint32_t units) {
+    if (powerLost) return false;
+    if (cutAt != SIM_FS_NO_CUT && unitsUsed + units > cutAt) {
+        unitsUsed = cutAt;
+        powerLost = true;
+        return false;
+    }
+    unitsUsed += units;
+    return true;
+}
+
+std::string SimFs::normalize(const char* path) {
+    std::string result = path && path[0] == '/' ? path : std::string("/") + (path ? path : "");
+    while (result.size() > 1 && result[result.size() - 1] == '/') result.erase(result.size() - 1);
+    return result;
+}
+
+static std::string parentOf(const std::string& path) {
+    size_t slash = path.rfind('/');
+    return slash == 0 ? "/" : path.substr(0, slash);
+}
+
+bool SimFs::parentExists(const std::string& path) const {
+    std::map<std::string, SimNode>::const_iterator parent = nodes.find(parentOf(path));
+    return parent != nodes.end() && parent->second.directory;
+}
+
+SimNode& SimFs::add(const std::string& path, bool directory) {
+    SimNode& node = nodes[path];
+    node.data.clear();
+    node.directory = directory;
+    node.created = nextCreated++;
+    return node;
+}
+
+SimNode* SimFs::find(const std::string& path) {
+    std::map<std::string, SimNode>::iterator it = nodes.find(path);
+    return it == nodes.end() ? NULL : &it->second;
+}
+
+bool SimFs::exists(const std::string& path) const {
+    return nodes.count(path) > 0;
+}
+
+bool SimFs::createFile(const std::string& path, bool truncate) {
+    SimNode* node = find(path);
+    if (node) {
+        if (node->directory) return false;
+        if (!truncate || node->data.empty()) return true;
+    } else if (!parentExists(path)) {
+        return false;
+    }
+    if (!spend(1)) return false;
+    if (node) {
+        node->data.clear();
+    } else {
+        add(path, false);
+    }
+    return true;
+}
+
+bool SimFs::mkdir(const std::string& path) {
+    if (exists(path)) return find(path)->directory;
+    if (!parentExists(path) || !spend(1)) return false;
+    add(path, true);
+    return true;
+}
+
+bool SimFs::remove(const std::string& path) {
+    SimNode* node = find(path);
+    if (node == NULL || path == "/") return false;
+    if (node->directory && !list(path).empty()) return false;
+    if (!spend(1)) return false;
+    nodes.erase(path);
+    return true;
+}
+
+bool SimFs::rename(const std::string& from, const std::string& to) {
+    SimNode* node = find(from);
+    if (node == NULL || node->directory || !parentExists(to) || !spend(1)) return false;
+    std::vector<uint8_t> data = node->data;
+    nodes.erase(from);
+    add(to, false).data = data;
+    return true;
+}
+
+size_t SimFs::write(SimOpenFile& file, const uint8_t* data, size_t size) {
+    SimNode* node = find(file.path);
+    if (node == NULL || !file.writable) return 0;
+    if (file.append) file.position = node->data.size();
+
+    size_t growth = file.position + size > node->data.size() ? file.position + size - node->data.size() : 0;
+    if (getUsedBytes() + growth > capacity) return 0;   // Kartu penuh
+
+    size_t written = 0;
+    while (written < size && spend(1)) {
+        if (file.position >= node->data.size()) node->data.resize(file.position + 1);
+        node->data[file.position++] = data[written++];
+    }
+    return written;
+}
+
+bool SimFs::readFile(const std::string& path, std::vector<uint8_t>& out) const {
+    std::map<std::string, SimNode>::const_iterator it = nodes.find(path);
+    if (it == nodes.end() || it->second.directory) return false;
+    out = it->second.data;
+    return true;
+}
+
+void SimFs::writeFile(const std::string& path, const std::vector<uint8_t>& data) {
+    SimNode* node = find(path);
+    (node ? *node : add(path, false)).data = data;
+}
+
+std::vector<std::string> SimFs::list(const std::string& directory) const {
+    std::map<uint64_t, std::string> ordered;
+    for (std::map<std::string, SimNode>::const_iterator it = nodes.begin(); it != nodes.end(); ++it) {
+        if (it->first != "/" && it->first != directory && parentOf(it->first) == directory) {
+            ordered[it->second.created] = it->first;
+        }
+    }
+
+    std::vector<std::string> children;
+    for (std::map<uint64_t, std::string>::const_iterator it = ordered.begin(); it != ordered.end(); ++it) {
+        children.push_back(it->second);
+    }
+    return children;
+}
+
+uint64_t SimFs::getUsedBytes() const {
+    uint64_t used = 0;
+    for (std::map<std::string, SimNode>::const_iterator it = nodes.begin(); it != nodes.end(); ++it) {
+        used += it->second.data.size();
+    }
+    return used;
+}
+
+// =======================================================
+//   SDClass
+// =======================================================
+
+bool SDClass::begin(uint8_t ssPin, SPIClass& spi, uint32_t frequency, const char* mountpoint, uint8_t maxFiles) {
+    return true;
+}
+
+File SDClass::open(const char* path, const char* mode) {
+    std::string name = SimFs::normalize(path);
+    bool write = strcmp(mode, FILE_READ) != 0;
+    bool truncate = strcmp(mode, FILE_WRITE) == 0;
+    bool create = truncate || strcmp(mode, FILE_APPEND) == 0;
+
+    if (create && !simFs.createFile(name, truncate)) return File();
+    SimNode* node = simFs.find(name);
+    if (node == NULL || (write && node->directory)) return File();
+
+    std::shared_ptr<SimOpenFile> state(new SimOpenFile());
+    state->path = name;
+    state->writable = write;
+    state->append = strcmp(mode, FILE_APPEND) == 0;
+    state->directory = node->directory;
+    state->position = state->append ? node->data.size() : 0;
+    state->listIndex = 0;
+    if (node->directory) state->listing = simFs.list(name);
+    return File(state);
+}
+
+bool SDClass::exists(const char* path) {
+    return simFs.exists(SimFs::normalize(path));
+}
+
+bool SDClass::mkdir(const char* path) {
+    return simFs.mkdir(SimFs::normalize(path));
+}
+
+bool SDClass::remove(const char* path) {
+    return simFs.remove(SimFs::normalize(path));
+}
+
+bool SDClass::rename(const char* from, const char* to) {
+    return simFs.rename(SimFs::normalize(from), SimFs::normalize(to));
+}
+
+uint64_t SDClass::cardSize() {
+    return simFs.getCapacity();
+}
+
+uint64_t SDClass::totalBytes() {
+    return simFs.getCapacity();
+}
+
+uint64_t SDClass::usedBytes() {
+    return simFs.getUsedBytes();
+}
+
+// =======================================================
+//   File
+// =======================================================
+
+size_t File::read(uint8_t* buffer, size_t size) {
+    if (!state || state->directory) return 0;
+    SimNode* node = simFs.find(state->path);
+    if (node == NULL || state->position >= node->data.size()) return 0;
+    size_t count = node->data.size() - state->position;
+    if (count > size) count = size;
+    memcpy(buffer, &node->data[state->position], count);
+    state->position += count;
+    return count;
+}
+
+int File::read() {
+    uint8_t value;
+    return read(&value, 1) == 1 ? value : -1;
+}
+
+int File::peek() {
+    int value = read();
+    if (value >= 0) state->position--;
+    return value;
+}
+
+size_t File::write(const uint8_t* data, size_t size) {
+    if (!state) return 0;
+    return simFs.write(*state, data, size);
+}
+
+bool File::seek(uint32_t position) {
+    if (!state) return false;
+    state->position = position;
+    return position <= size();
+}
+
+size_t File::position() const {
+    return state ? state->position : 0;
+}
+
+size_t File::size() const {
+    if (!state) return 0;
+    SimNode* node = simFs.find(state->path);
+    return node ? node->data.size() : 0;
+}
+
+int File::available() {
+    size_t total = size();
+    return state && state->position < total ? (int)(total - state->position) : 0;
+}
+
+String File::readString() {
+    std::string text;
+    int value;
+    while ((value = read()) >= 0) text += (char)value;
+    return String(text);
+}
+
+const char* File::name() const {
+    if (!state) return "";
+    size_t slash = state->path.rfind('/');
+    return state->path.c_str() + (state->path.size() > 1 ? slash + 1 : 0);
+}
+
+bool File::isDirectory() const {
+    return state && state->directory;
+}
+
+File File::openNextFile() {
+    if (!state || !state->directory) return File();
+    while (state->listIndex < state->listing.size()) {
+        const std::string& path = state->listing[state->listIndex++];
+        if (simFs.exists(path)) return SD.open(path.c_str(), FILE_READ);
+    }
+    return File();
+}
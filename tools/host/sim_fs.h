@@ -0,0 +1,94 @@
+#ifndef SIM_FS_H
+#define SIM_FS_H
+
+// =======================================================
+//   SIMULATED FILESYSTEM (host)
+//   Isi SD Card di RAM untuk test kode lib/SdUtils (SD.h / FS.h host).
+//   Setiap mutasi memakai "unit": satu byte yang ditulis, atau satu operasi
+//   metadata (open "w" yang mengosongkan file, remove, rename, mkdir).
+//   cutPowerAfter(n) mensimulasikan listrik mati setelah n unit: byte yang
+//   sudah lewat tetap tersimpan (write bisa terpotong di tengah), mutasi
+//   sesudahnya dibuang sampai powerOn(). Baca tetap jalan agar kode yang
+//   "mati" bisa selesai tanpa crash; hasilnya tidak dipakai test.
+// =======================================================
+
+#include <stddef.h>
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#define SIM_FS_DEFAULT_CAPACITY (1024ULL * 1024 * 1024)
+#define SIM_FS_NO_CUT 0xFFFFFFFFUL
+
+struct SimNode {
+    std::vector<uint8_t> data;
+    bool directory;
+    uint64_t created;           // Urutan pembuatan - list() mengikuti urutan entri FAT, bukan nama
+};
+
+struct SimOpenFile {
+    std::string path;
+    size_t position;
+    bool writable;
+    bool append;
+    bool directory;
+    std::vector<std::string> listing;   // Anak direktori (openNextFile)
+    size_t listIndex;
+};
+
+class SimFs {
+public:
+    SimFs();
+
+    /**
+     * @brief Kosongkan kartu (hanya direktori root) dan batalkan power cut
+     */
+    void format(uint64_t capacityBytes = SIM_FS_DEFAULT_CAPACITY);
+
+    /**
+     * @brief Listrik mati setelah units mutasi berikutnya (SIM_FS_NO_CUT = tidak pernah)
+     */
+    void cutPowerAfter(uint32_t units);
+    void powerOn();
+    bool isPowerLost() const { return powerLost; }
+
+    /**
+     * @brief Total unit mutasi sejak format() (untuk memilih titik power cut)
+     */
+    uint32_t getUnitsUsed() const { return unitsUsed; }
+
+    // Akses langsung untuk pemeriksaan test (tidak memakai unit)
+    bool readFile(const std::string& path, std::vector<uint8_t>& out) const;
+    void writeFile(const std::string& path, const std::vector<uint8_t>& data);
+    std::vector<std::string> list(const std::string& directory) const;
+    uint64_t getCapacity() const { return capacity; }
+    uint64_t getUsedBytes() const;
+
+    // Dipakai File / SDClass host
+    SimNode* find(const std::string& path);
+    bool exists(const std::string& path) const;
+    bool createFile(const std::string& path, bool truncate);
+    bool mkdir(const std::string& path);
+    bool remove(const std::string& path);
+    bool rename(const std::string& from, const std::string& to);
+    size_t write(SimOpenFile& file, const uint8_t* data, size_t size);
+
+    static std::string normalize(const char* path);
+
+private:
+    bool spend(uint32_t units);         // false = listrik sudah mati
+    bool parentExists(const std::string& path) const;
+    SimNode& add(const std::string& path, bool directory);
+
+    std::map<std::string, SimNode> nodes;
+    uint64_t capacity;
+    uint64_t nextCreated;
+    uint32_t unitsUsed;
+    uint32_t cutAt;
+    bool powerLost;
+};
+
+extern SimFs simFs;
+
+#endif // SIM_FS_H
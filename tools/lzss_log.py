@@ -0,0 +1,211 @@
+#!/usr/bin/env python3
+"""
+Dekompres / kompres log harian .lzs dari SD Card (lihat lib/SdUtils/log_compress.h).
+
+Format file:
+    header 12 byte : 'V' 'Z' <versi=1> <window bits> <uint32 ukuran asli> <uint32 CRC-32 asli>
+    stream LZSS    : flag byte (bit 0 = item pertama; 1 = literal, 0 = match) + 8 item
+                     literal 1 byte, match 2 byte big-endian:
+                     (jarak - 1) << (16 - window bits) | (panjang - 3)
+
+Encoder di sini port langsung dari firmware (window geser + hash chain yang sama),
+jadi hasil `compress` identik byte-per-byte dengan file dari device dan rasio
+`bench` sama dengan yang dicapai firmware.
+
+Pemakaian:
+    python3 tools/lzss_log.py decompress vatlog_2025-01-15.csv.lzs -o vatlog_2025-01-15.csv
+    python3 tools/lzss_log.py compress vatlog_2025-01-15.csv -o vatlog_2025-01-15.csv.lzs
+    python3 tools/lzss_log.py bench /path/ke/log/*.csv
+"""
+
+import argparse
+import struct
+import sys
+import time
+import zlib
+
+HEADER = struct.Struct("<2sBBII")
+VERSION = 1
+WINDOW_BITS = 11
+MIN_MATCH = 3
+HASH_BITS = 12
+MAX_CHAIN = 32
+NIL = 0xFFFF
+
+
+def decompress(data):
+    magic, version, window_bits, size, crc = HEADER.unpack_from(data)
+    if magic != b"VZ" or version != VERSION:
+        raise ValueError("bukan file .lzs (magic/versi salah)")
+
+    length_bits = 16 - window_bits
+    out = bytearray()
+    pos = HEADER.size
+    while len(out) < size:
+        flags = data[pos]
+        pos += 1
+        for bit in range(8):
+            if len(out) >= size:
+                break
+            if flags & (1 << bit):
+                out.append(data[pos])
+                pos += 1
+            else:
+                token = (data[pos] << 8) | data[pos + 1]
+                pos += 2
+                distance = (token >> length_bits) + 1
+                length = (token & ((1 << length_bits) - 1)) + MIN_MATCH
+                if distance > len(out):
+                    raise ValueError("stream rusak di offset %d" % pos)
+                for _ in range(length):
+                    out.append(out[-distance])
+
+    if zlib.crc32(bytes(out)) != crc:
+        raise ValueError("CRC salah - file rusak")
+    return bytes(out)
+
+
+def compress(data, window_bits=WINDOW_BITS):
+    """Port encoder firmware: greedy, window 2 x W yang digeser, hash chain terbatas."""
+    window_size = 1 << window_bits
+    length_bits = 16 - window_bits
+    max_match = MIN_MATCH + (1 << length_bits) - 1
+    hash_size = 1 << HASH_BITS
+    mask = window_size - 1
+
+    window = bytearray(2 * window_size)
+    head = [NIL] * hash_size
+    prev = [NIL] * window_size
+    win_pos = win_end = src = 0
+    input_done = False
+
+    out = bytearray(HEADER.pack(b"VZ", VERSION, window_bits, len(data), zlib.crc32(data)))
+    group = bytearray([0])
+    items = 0
+
+    def hash3(p):
+        return ((window[p] << 8) ^ (window[p + 1] << 4) ^ window[p + 2]) & (hash_size - 1)
+
+    while True:
+        # fillWindow()
+        while not input_done and win_end - win_pos < max_match:
+            if win_end == len(window):
+                window[:window_size] = window[window_size:]
+                win_pos -= window_size
+                win_end -= window_size
+                head = [h - window_size if h != NIL and h >= window_size else NIL for h in head]
+                prev = [h - window_size if h != NIL and h >= window_size else NIL for h in prev]
+            got = data[src:src + len(window) - win_end]
+            if not got:
+                input_done = True
+                break
+            window[win_end:win_end + len(got)] = got
+            src += len(got)
+            win_end += len(got)
+        if win_pos >= win_end:
+            break
+
+        # findMatch()
+        best = distance = 0
+        available = win_end - win_pos
+        if available >= MIN_MATCH:
+            max_length = min(available, max_match)
+            limit = win_pos - window_size if win_pos > window_size else 0
+            candidate = head[hash3(win_pos)]
+            chain = MAX_CHAIN
+            while chain > 0 and candidate != NIL and candidate >= limit:
+                if window[candidate + best] == window[win_pos + best]:
+                    length = 0
+                    while length < max_length and window[candidate + length] == window[win_pos + length]:
+                        length += 1
+                    if length > best:
+                        best = length
+                        distance = win_pos - candidate
+                        if best == max_length:
+                            break
+                following = prev[candidate & mask]
+                if following >= candidate:
+                    break
+                candidate = following
+                chain -= 1
+        if best < MIN_MATCH:
+            best = 0
+
+        if best:
+            token = ((distance - 1) << length_bits) | (best - MIN_MATCH)
+            group += bytes([token >> 8, token & 0xFF])
+            length = best
+        else:
+            group[0] |= 1 << items
+            group.append(window[win_pos])
+            length = 1
+        items += 1
+        if items == 8:
+            out += group
+            group = bytearray([0])
+            items = 0
+
+        for _ in range(length):
+            if win_end - win_pos >= MIN_MATCH:
+                h = hash3(win_pos)
+                prev[win_pos & mask] = head[h]
+                head[h] = win_pos
+            win_pos += 1
+
+    if items:
+        out += group
+    return bytes(out)
+
+
+def bench(paths):
+    print("%-36s %10s %10s %7s %10s" % ("file", "asli", "lzs", "rasio", "decode"))
+    total_in = total_out = 0
+    for path in paths:
+        with open(path, "rb") as handle:
+            data = handle.read()
+        packed = compress(data)
+        started = time.time()
+        assert decompress(packed) == data
+        elapsed = max(time.time() - started, 1e-6)
+        total_in += len(data)
+        total_out += len(packed)
+        print("%-36s %10d %10d %6.2fx %7.0f KB/s" % (
+            path[-36:], len(data), len(packed), len(data) / max(len(packed), 1),
+            len(data) / 1024.0 / elapsed))
+    if len(paths) > 1:
+        print("%-36s %10d %10d %6.2fx" % ("TOTAL", total_in, total_out, total_in / max(total_out, 1)))
+    print("(throughput firmware dicetak di Serial setelah setiap kompresi)")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Kompresi LZSS log harian VAT Subsoil Monitor")
+    sub = parser.add_subparsers(dest="command")
+    for name in ("decompress", "compress"):
+        command = sub.add_parser(name)
+        command.add_argument("input")
+        command.add_argument("-o", "--output", help="file tujuan (default stdout)")
+    command = sub.add_parser("bench", help="rasio & verifikasi round-trip untuk trace log")
+    command.add_argument("inputs", nargs="+")
+    args = parser.parse_args()
+
+    if args.command == "bench":
+        bench(args.inputs)
+        return 0
+    if args.command not in ("decompress", "compress"):
+        parser.print_help()
+        return 1
+
+    with open(args.input, "rb") as handle:
+        data = handle.read()
+    result = decompress(data) if args.command == "decompress" else compress(data)
+
+    if args.output:
+        with open(args.output, "wb") as handle:
+            handle.write(result)
+    else:
+        sys.stdout.buffer.write(result)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())